@@ -0,0 +1,149 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Отпечатки применённых к актёрам оверлейных пресетов, чтобы не переприменять их без нужды.
+ *
+ * Для каждого актёра хранится отпечаток последнего применения: id пресета, множество uid
+ * его оверлеев у актёра и поколение 3D на момент применения. Поколение - счётчик актёра, который владелец
+ * увеличивает через bumpGeneration() при загрузке актёра и пересборке его модели. decide() сравнивает
+ * отпечаток с текущим состоянием, сначала дешёвые проверки, обход оверлеев актёра - последним:
+ * - нет отпечатка или сменился пресет - Reapply;
+ * - поколение 3D то же - Skip, оверлеи не обходятся;
+ * - корня оверлеев нет - Reapply;
+ * - набор uid оверлеев стал другим - Reapply;
+ * - иначе Refresh: оверлеи пережили пересборку, обновляется только поколение.
+ * Потокобезопасен. Текущие оверлеи актёра отдаёт Source, и только когда поколение изменилось.
+ */
+class AppliedOverlaysTracker
+{
+public:
+	using Uids = std::vector<uint32_t>;
+
+	/**
+	 * @brief Что делать с пресетом актёра.
+	 */
+	enum class Decision
+	{
+		Skip,		///< Ничего не изменилось.
+		Refresh,	///< 3D пересобрано, оверлеи на месте. Поколение уже обновлено.
+		Reapply		///< Нужно полное переприменение, после него вызвать record().
+	};
+
+	/**
+	 * @brief Отпечаток применённого пресета.
+	 */
+	struct Fingerprint
+	{
+		std::string presetId{};
+		uint64_t generation{ 0 };
+		Uids uids{};	///< Отсортированы.
+	};
+
+	/**
+	 * @brief Решить, нужно ли переприменять пресет.
+	 * @tparam Source Тип с методами Uids overlayUids() и bool hasOverlayRoot().
+	 * @param formId FormID актёра.
+	 * @param presetId id текущего пресета актёра.
+	 * @param generation Текущее поколение 3D актёра, см. generation().
+	 * @param source Текущее состояние оверлеев актёра. Вызывается вне блокировки и только если поколение сменилось.
+	 */
+	template <class Source>
+	Decision decide(uint32_t formId, std::string_view presetId, uint64_t generation, Source& source) {
+		Fingerprint recorded;
+		{
+			std::lock_guard lock(m_mutex);
+			auto it = m_fingerprints.find(formId);
+			if (it == m_fingerprints.end() || it->second.presetId != presetId) {
+				return Decision::Reapply;
+			}
+			recorded.generation = it->second.generation;
+			recorded.uids = it->second.uids;
+		}
+
+		if (recorded.generation == generation) {
+			return Decision::Skip;
+		}
+		if (!source.hasOverlayRoot()) {
+			return Decision::Reapply;
+		}
+		if (normalize(source.overlayUids()) != recorded.uids) {
+			return Decision::Reapply;
+		}
+
+		std::lock_guard lock(m_mutex);
+		if (auto it = m_fingerprints.find(formId); it != m_fingerprints.end() && it->second.presetId == presetId) {
+			it->second.generation = generation;
+		}
+		return Decision::Refresh;
+	}
+
+	/**
+	 * @brief Запомнить состояние после применения пресета.
+	 * @param formId FormID актёра.
+	 * @param presetId id применённого пресета.
+	 * @param generation Поколение 3D актёра.
+	 * @param uids uid оверлеев пресета у актёра, порядок не важен.
+	 */
+	void record(uint32_t formId, std::string_view presetId, uint64_t generation, Uids uids) {
+		std::lock_guard lock(m_mutex);
+		m_fingerprints.insert_or_assign(formId, Fingerprint{ std::string{ presetId }, generation, normalize(std::move(uids)) });
+	}
+
+	/**
+	 * @brief Отметить, что 3D актёра загружено или пересобрано.
+	 * @return Новое поколение 3D актёра.
+	 */
+	uint64_t bumpGeneration(uint32_t formId) {
+		std::lock_guard lock(m_mutex);
+		return ++m_generations[formId];
+	}
+
+	/**
+	 * @brief Текущее поколение 3D актёра, 0 если актёр ещё не загружался.
+	 */
+	uint64_t generation(uint32_t formId) const {
+		std::lock_guard lock(m_mutex);
+		auto it = m_generations.find(formId);
+		return it != m_generations.end() ? it->second : 0;
+	}
+
+	/**
+	 * @brief Забыть актёра: отпечаток и поколение. Вызывается при выгрузке актёра.
+	 * @return true если у актёра был отпечаток.
+	 */
+	bool erase(uint32_t formId) {
+		std::lock_guard lock(m_mutex);
+		m_generations.erase(formId);
+		return m_fingerprints.erase(formId) > 0;
+	}
+
+	void clear() {
+		std::lock_guard lock(m_mutex);
+		m_fingerprints.clear();
+		m_generations.clear();
+	}
+
+	size_t size() const {
+		std::lock_guard lock(m_mutex);
+		return m_fingerprints.size();
+	}
+
+private:
+	static Uids normalize(Uids uids) {
+		std::sort(uids.begin(), uids.end());
+		uids.erase(std::unique(uids.begin(), uids.end()), uids.end());
+		return uids;
+	}
+
+	std::unordered_map<uint32_t, Fingerprint> m_fingerprints;
+	std::unordered_map<uint32_t, uint64_t> m_generations;
+	mutable std::mutex m_mutex;
+};
@@ -0,0 +1,124 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <Preset/Preset.h>
+
+/**
+ * @brief Кэш кандидатов для PresetsGenerator.
+ *
+ * Актёры с одинаковым снимком условий (ActorFacts::signature) и расой получают одинаковые списки кандидатов,
+ * поэтому полный перебор пресетов нужен только для первого из них. Кэш привязан к поколению PresetsManager
+ * и полностью сбрасывается, когда набор пресетов меняется (загрузка, валидация).
+ */
+class CandidatesCache {
+public:
+    /**
+     * @brief Предел числа записей. При его достижении кэш очищается целиком.
+     */
+    static constexpr size_t MAX_ENTRIES = 4096;
+
+    /**
+     * @brief Кандидаты одного типа пресета: максимальный уровень совпадения и пресеты с этим уровнем.
+     */
+    struct TypeCandidates {
+        CoincidenceLevel level{ CoincidenceLevel::NONE };
+        std::vector<std::shared_ptr<Preset>> presets{};
+    };
+
+    /**
+     * @brief Кандидаты по всем типам пресетов, индекс - PresetType.
+     */
+    using Candidates = std::array<TypeCandidates, static_cast<size_t>(PresetType::END)>;
+
+    /**
+     * @brief Ключ кэша: сигнатура снимка актёра и раса (от расы зависит, доступны ли оверлеи).
+     */
+    struct Key {
+        ActorFacts facts{};
+        uint32_t raceFormID{};
+
+        bool operator==(const Key&) const noexcept = default;
+    };
+
+    /**
+     * @brief Получить единственный экземпляр кэша (Singleton).
+     */
+    static CandidatesCache& get() {
+        static CandidatesCache instance;
+        return instance;
+    }
+
+    /**
+     * @brief Найти кандидатов по ключу.
+     * @param key Ключ.
+     * @param generation Текущее поколение PresetsManager. Если оно изменилось, кэш сбрасывается.
+     * @return Кандидаты или nullptr, если их нет в кэше.
+     */
+    std::shared_ptr<const Candidates> find(const Key& key, uint64_t generation) {
+        std::lock_guard lock(m_mutex);
+        if (!syncGeneration(generation)) {
+            return nullptr;
+        }
+        auto it = m_entries.find(key);
+        return it != m_entries.end() ? it->second : nullptr;
+    }
+
+    /**
+     * @brief Сохранить кандидатов.
+     * @param key Ключ.
+     * @param candidates Кандидаты.
+     * @param generation Поколение PresetsManager, на котором кандидаты были посчитаны. Устаревшие результаты не сохраняются.
+     */
+    void store(Key key, std::shared_ptr<const Candidates> candidates, uint64_t generation) {
+        std::lock_guard lock(m_mutex);
+        if (!syncGeneration(generation)) {
+            return;
+        }
+        // Защита от неограниченного роста при большом разнообразии актёров
+        if (m_entries.size() >= MAX_ENTRIES) {
+            m_entries.clear();
+        }
+        m_entries.insert_or_assign(std::move(key), std::move(candidates));
+    }
+
+    /**
+     * @brief Очистить кэш.
+     */
+    void clear() {
+        std::lock_guard lock(m_mutex);
+        m_entries.clear();
+    }
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            return ActorFactsHash{}(key.facts) ^ (std::hash<uint32_t>{}(key.raceFormID) << 1);
+        }
+    };
+
+    CandidatesCache() = default;
+    CandidatesCache(const CandidatesCache&) = delete;
+    CandidatesCache& operator=(const CandidatesCache&) = delete;
+
+    /**
+     * @brief Сбросить кэш при смене поколения. Вызывать под m_mutex.
+     * @return false, если переданное поколение старше текущего кэша.
+     */
+    bool syncGeneration(uint64_t generation) {
+        if (generation < m_generation) {
+            return false;
+        }
+        if (generation > m_generation) {
+            m_entries.clear();
+            m_generation = generation;
+        }
+        return true;
+    }
+
+    std::mutex m_mutex;
+    uint64_t m_generation{ 0 };
+    std::unordered_map<Key, std::shared_ptr<const Candidates>, KeyHash> m_entries;
+};
@@ -22,9 +22,8 @@ inline std::unordered_set<std::uint32_t> getActorAndTesNPCFormIDsFromJsonArray(b
 }
 
 void ExcludedActors::refreshExclusionList() noexcept {
-	static auto ini = globals::g_ini;
-	ini->reload();
-	auto foldersStr = ini->at("PATH/sExclusions", std::string{});
+	globals::refreshSettings();
+	const auto& foldersStr = globals::settings().sExclusions;
 	if (foldersStr.empty()) {
 		m_excludedForms.clear();
 		return;
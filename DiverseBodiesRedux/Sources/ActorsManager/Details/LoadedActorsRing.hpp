@@ -0,0 +1,132 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Множество недавно обработанных актёров с истечением по поколениям.
+ *
+ * Время делится на поколения длиной resolution. Для каждого актёра в хеш-таблице хранится поколение,
+ * в котором запись истекает, а сам formId кладётся в слот кольца этого поколения. Старение ленивое и
+ * выполняется при записи: пройденные слоты кольца очищаются, их актёры удаляются из таблицы, если срок
+ * не был продлён. Поэтому insert, contains и старение стоят O(1) в среднем, и отдельный поток не нужен.
+ * contains только сравнивает срок с текущим поколением и берёт разделяемую блокировку.
+ * Сроки длиннее Generations - 1 поколений обрезаются.
+ *
+ * @tparam Clock Тип часов со статическим now() (по умолчанию std::chrono::steady_clock).
+ * @tparam Generations Размер кольца в поколениях.
+ */
+template <class Clock = std::chrono::steady_clock, size_t Generations = 128>
+class LoadedActorsRing
+{
+public:
+	using Duration = typename Clock::duration;
+
+	/**
+	 * @param resolution Длина одного поколения. Сроки округляются вверх до поколения.
+	 */
+	explicit LoadedActorsRing(Duration resolution = std::chrono::seconds(1)) :
+		m_resolution(resolution.count() > 0 ? resolution : Duration{ 1 }),
+		m_origin(Clock::now()) {}
+
+	/**
+	 * @brief Добавить актёра без срока. Запись живёт до erase() или clear().
+	 */
+	void insert(uint32_t formId) {
+		std::unique_lock lock(m_mutex);
+		ageOut(generation());
+		m_entries.insert_or_assign(formId, PINNED);
+	}
+
+	/**
+	 * @brief Добавить актёра или продлить его запись на ttl.
+	 * @param formId FormID актёра.
+	 * @param ttl Время жизни записи.
+	 */
+	void insert(uint32_t formId, Duration ttl) {
+		std::unique_lock lock(m_mutex);
+		const auto now = generation();
+		ageOut(now);
+		const auto ticks = static_cast<uint64_t>((std::max(ttl, Duration::zero()) + m_resolution - Duration{ 1 }) / m_resolution);
+		const auto expires = now + std::clamp<uint64_t>(ticks, 1, Generations - 1);
+		m_entries.insert_or_assign(formId, expires);
+		m_ring[expires % Generations].push_back(formId);
+	}
+
+	/**
+	 * @brief Есть ли неистёкшая запись актёра.
+	 */
+	bool contains(uint32_t formId) const {
+		std::shared_lock lock(m_mutex);
+		auto it = m_entries.find(formId);
+		return it != m_entries.end() && it->second > generation();
+	}
+
+	/**
+	 * @brief Удалить запись актёра. Его id в слоте кольца станет устаревшим и отбросится при старении.
+	 * @return true если запись была.
+	 */
+	bool erase(uint32_t formId) {
+		std::unique_lock lock(m_mutex);
+		return m_entries.erase(formId) > 0;
+	}
+
+	/**
+	 * @brief Удалить все записи.
+	 */
+	void clear() {
+		std::unique_lock lock(m_mutex);
+		m_entries.clear();
+		for (auto& slot : m_ring) {
+			slot.clear();
+		}
+	}
+
+	/**
+	 * @brief Количество записей, включая истёкшие, но ещё не состаренные.
+	 */
+	size_t size() const {
+		std::shared_lock lock(m_mutex);
+		return m_entries.size();
+	}
+
+private:
+	static constexpr uint64_t PINNED = std::numeric_limits<uint64_t>::max();
+
+	uint64_t generation() const noexcept {
+		const auto now = Clock::now();
+		return now <= m_origin ? 0 : static_cast<uint64_t>((now - m_origin) / m_resolution);
+	}
+
+	void ageOut(uint64_t now) {
+		if (now <= m_agedUntil) {
+			return;
+		}
+		// После долгого простоя все слоты кольца уже истекли, каждый проходим один раз
+		const uint64_t from = now - m_agedUntil >= Generations ? now - Generations + 1 : m_agedUntil + 1;
+		for (uint64_t gen = from; gen <= now; ++gen) {
+			auto& slot = m_ring[gen % Generations];
+			for (uint32_t formId : slot) {
+				// Срок мог быть продлён (запись в другом слоте) или снят
+				if (auto it = m_entries.find(formId); it != m_entries.end() && it->second <= now) {
+					m_entries.erase(it);
+				}
+			}
+			slot.clear();
+		}
+		m_agedUntil = now;
+	}
+
+	const Duration m_resolution;
+	const typename Clock::time_point m_origin;
+	std::unordered_map<uint32_t, uint64_t> m_entries{};
+	std::array<std::vector<uint32_t>, Generations> m_ring{};
+	uint64_t m_agedUntil{ 0 };
+	mutable std::shared_mutex m_mutex;
+};
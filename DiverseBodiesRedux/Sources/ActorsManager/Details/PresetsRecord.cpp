@@ -0,0 +1,366 @@
+#include "PresetsRecord.h"
+#include <zlib.h>
+#include <algorithm>
+
+namespace PresetsRecord
+{
+	namespace
+	{
+		template <class T>
+		void put(std::vector<uint8_t>& buf, T value)
+		{
+			for (size_t i = 0; i < sizeof(T); ++i) {
+				buf.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+			}
+		}
+
+		/**
+		 * @brief Последовательное чтение с проверкой границ.
+		 */
+		class Reader
+		{
+		public:
+			explicit Reader(std::span<const uint8_t> data) :
+				m_data(data) {}
+
+			template <class T>
+			bool get(T& value) noexcept
+			{
+				if (m_data.size() - m_pos < sizeof(T)) {
+					return false;
+				}
+				uint64_t v = 0;
+				for (size_t i = 0; i < sizeof(T); ++i) {
+					v |= static_cast<uint64_t>(m_data[m_pos + i]) << (8 * i);
+				}
+				m_pos += sizeof(T);
+				value = static_cast<T>(v);
+				return true;
+			}
+
+			size_t position() const noexcept
+			{
+				return m_pos;
+			}
+
+			bool bytes(size_t size, std::string_view& out) noexcept
+			{
+				if (m_data.size() - m_pos < size) {
+					return false;
+				}
+				out = { reinterpret_cast<const char*>(m_data.data() + m_pos), size };
+				m_pos += size;
+				return true;
+			}
+
+		private:
+			std::span<const uint8_t> m_data;
+			size_t m_pos{ 0 };
+		};
+	}
+
+	void Encoder::beginActor(uint32_t formId)
+	{
+		put<uint32_t>(m_actors, formId);
+		m_countOffset = m_actors.size();
+		put<uint8_t>(m_actors, 0);
+		++m_actorsCount;
+	}
+
+	void Encoder::addPreset(uint8_t type, std::string_view id)
+	{
+		if (m_actorsCount == 0 || m_actors[m_countOffset] == UINT8_MAX) {
+			return;
+		}
+		++m_actors[m_countOffset];
+		put<uint8_t>(m_actors, type);
+		put<uint32_t>(m_actors, intern(id));
+	}
+
+	size_t Encoder::actorsCount() const noexcept
+	{
+		return m_actorsCount;
+	}
+
+	uint64_t Encoder::size() const noexcept
+	{
+		// Заголовок, количество строк, строки, количество актёров, актёры
+		return sizeof(uint32_t) + 2 * sizeof(uint16_t) + sizeof(uint32_t) + m_stringsSize + sizeof(uint32_t) + m_actors.size();
+	}
+
+	uint32_t Encoder::intern(std::string_view id)
+	{
+		if (id.size() > UINT16_MAX) {
+			id = id.substr(0, UINT16_MAX);
+		}
+		if (auto it = m_stringIndex.find(id); it != m_stringIndex.end()) {
+			return it->second;
+		}
+		auto index = static_cast<uint32_t>(m_strings.size());
+		const auto& stored = m_strings.emplace_back(id);
+		m_stringIndex.emplace(stored, index);
+		m_stringsSize += sizeof(uint16_t) + stored.size();
+		return index;
+	}
+
+	bool Encoder::write(const Sink& sink, size_t chunkSize) const
+	{
+		std::vector<uint8_t> buf;
+		buf.reserve(chunkSize + UINT16_MAX + sizeof(uint16_t));
+
+		auto flush = [&](bool force) {
+			if (buf.empty() || (!force && buf.size() < chunkSize)) {
+				return true;
+			}
+			bool ok = sink(buf.data(), buf.size());
+			buf.clear();
+			return ok;
+		};
+
+		put<uint32_t>(buf, MAGIC);
+		put<uint16_t>(buf, FORMAT_VERSION);
+		put<uint16_t>(buf, 0);
+
+		put<uint32_t>(buf, static_cast<uint32_t>(m_strings.size()));
+		for (const auto& str : m_strings) {
+			put<uint16_t>(buf, static_cast<uint16_t>(str.size()));
+			buf.insert(buf.end(), str.begin(), str.end());
+			if (!flush(false)) {
+				return false;
+			}
+		}
+
+		put<uint32_t>(buf, m_actorsCount);
+		if (!flush(true)) {
+			return false;
+		}
+
+		// Секция актёров уже в итоговом виде, отдаём её кусками без копирования
+		for (size_t pos = 0; pos < m_actors.size(); pos += chunkSize) {
+			if (!sink(m_actors.data() + pos, std::min(chunkSize, m_actors.size() - pos))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	Decoder::Decoder(ActorCallback onActor) :
+		m_onActor(std::move(onActor)) {}
+
+	bool Decoder::feed(const uint8_t* data, size_t size)
+	{
+		if (m_stage == Stage::Failed) {
+			return false;
+		}
+		m_pending.insert(m_pending.end(), data, data + size);
+		auto used = parse();
+		m_pending.erase(m_pending.begin(), m_pending.begin() + used);
+		if (m_stage == Stage::Done && !m_pending.empty()) {
+			m_stage = Stage::Failed;
+		}
+		return m_stage != Stage::Failed;
+	}
+
+	bool Decoder::finished() const noexcept
+	{
+		return m_stage == Stage::Done;
+	}
+
+	size_t Decoder::parse()
+	{
+		Reader reader(m_pending);
+		size_t used = 0;
+		// Элемент либо читается целиком, либо не читается вовсе: при нехватке данных остаёмся на used
+		while (true) {
+			switch (m_stage) {
+			case Stage::Header:
+			{
+				uint32_t magic{};
+				uint16_t version{}, reserved{};
+				if (!reader.get(magic) || !reader.get(version) || !reader.get(reserved)) {
+					return used;
+				}
+				if (magic != MAGIC || version != FORMAT_VERSION) {
+					m_stage = Stage::Failed;
+					return used;
+				}
+				m_stage = Stage::StringsCount;
+				break;
+			}
+			case Stage::StringsCount:
+				if (!reader.get(m_stringsCount)) {
+					return used;
+				}
+				m_stage = m_stringsCount ? Stage::Strings : Stage::ActorsCount;
+				break;
+			case Stage::Strings:
+			{
+				uint16_t size{};
+				std::string_view str;
+				if (!reader.get(size) || !reader.bytes(size, str)) {
+					return used;
+				}
+				m_strings.emplace_back(str);
+				if (m_strings.size() == m_stringsCount) {
+					m_stage = Stage::ActorsCount;
+				}
+				break;
+			}
+			case Stage::ActorsCount:
+				if (!reader.get(m_actorsLeft)) {
+					return used;
+				}
+				m_stage = m_actorsLeft ? Stage::Actors : Stage::Done;
+				break;
+			case Stage::Actors:
+			{
+				uint32_t formId{};
+				uint8_t count{};
+				if (!reader.get(formId) || !reader.get(count)) {
+					return used;
+				}
+				m_entries.clear();
+				for (uint8_t i = 0; i < count; ++i) {
+					uint8_t type{};
+					uint32_t index{};
+					if (!reader.get(type) || !reader.get(index)) {
+						return used;
+					}
+					if (index >= m_strings.size()) {
+						m_stage = Stage::Failed;
+						return used;
+					}
+					m_entries.push_back({ type, m_strings[index] });
+				}
+				m_onActor(formId, m_entries);
+				if (--m_actorsLeft == 0) {
+					m_stage = Stage::Done;
+				}
+				break;
+			}
+			case Stage::Done:
+			case Stage::Failed:
+				return used;
+			}
+			used = reader.position();
+		}
+	}
+
+	DeflateWriter::DeflateWriter(Sink sink, size_t chunkSize) :
+		m_sink(std::move(sink)),
+		m_stream(std::make_unique<z_stream_s>()),
+		m_out(chunkSize)
+	{
+		m_ok = deflateInit(m_stream.get(), Z_DEFAULT_COMPRESSION) == Z_OK;
+	}
+
+	DeflateWriter::~DeflateWriter()
+	{
+		deflateEnd(m_stream.get());
+	}
+
+	bool DeflateWriter::write(const uint8_t* data, size_t size)
+	{
+		if (!m_ok) {
+			return false;
+		}
+		m_stream->next_in = const_cast<Bytef*>(data);
+		m_stream->avail_in = static_cast<uInt>(size);
+		m_totalIn += size;
+		return pump(Z_NO_FLUSH);
+	}
+
+	bool DeflateWriter::finish()
+	{
+		if (!m_ok) {
+			return false;
+		}
+		m_stream->next_in = nullptr;
+		m_stream->avail_in = 0;
+		return pump(Z_FINISH);
+	}
+
+	uint64_t DeflateWriter::totalIn() const noexcept
+	{
+		return m_totalIn;
+	}
+
+	bool DeflateWriter::pump(int flush)
+	{
+		int result = Z_OK;
+		do {
+			m_stream->next_out = m_out.data();
+			m_stream->avail_out = static_cast<uInt>(m_out.size());
+			result = deflate(m_stream.get(), flush);
+			if (result == Z_STREAM_ERROR) {
+				return m_ok = false;
+			}
+			size_t produced = m_out.size() - m_stream->avail_out;
+			if (produced && !m_sink(m_out.data(), produced)) {
+				return m_ok = false;
+			}
+		} while (m_stream->avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+		return true;
+	}
+
+	InflateWriter::InflateWriter(Sink sink, uint64_t maxOut, size_t chunkSize) :
+		m_sink(std::move(sink)),
+		m_stream(std::make_unique<z_stream_s>()),
+		m_out(chunkSize),
+		m_maxOut(maxOut)
+	{
+		m_ok = inflateInit2(m_stream.get(), MAX_WBITS) == Z_OK;
+	}
+
+	InflateWriter::~InflateWriter()
+	{
+		inflateEnd(m_stream.get());
+	}
+
+	bool InflateWriter::write(const uint8_t* data, size_t size)
+	{
+		if (!m_ok) {
+			return false;
+		}
+		if (m_finished) {
+			return m_ok = size == 0;
+		}
+		m_stream->next_in = const_cast<Bytef*>(data);
+		m_stream->avail_in = static_cast<uInt>(size);
+		do {
+			m_stream->next_out = m_out.data();
+			m_stream->avail_out = static_cast<uInt>(m_out.size());
+			int result = inflate(m_stream.get(), Z_NO_FLUSH);
+			if (result == Z_BUF_ERROR) {
+				break;  // Нужны следующие входные данные
+			}
+			if (result != Z_OK && result != Z_STREAM_END) {
+				return m_ok = false;
+			}
+			size_t produced = m_out.size() - m_stream->avail_out;
+			m_totalOut += produced;
+			if (m_totalOut > m_maxOut) {
+				return m_ok = false;
+			}
+			if (produced && !m_sink(m_out.data(), produced)) {
+				return m_ok = false;
+			}
+			m_finished = result == Z_STREAM_END;
+		} while (!m_finished && (m_stream->avail_in > 0 || m_stream->avail_out == 0));
+
+		if (m_finished && m_stream->avail_in > 0) {
+			return m_ok = false;  // Данные после конца потока
+		}
+		return true;
+	}
+
+	bool InflateWriter::finished() const noexcept
+	{
+		return m_finished;
+	}
+
+	uint64_t InflateWriter::totalOut() const noexcept
+	{
+		return m_totalOut;
+	}
+}
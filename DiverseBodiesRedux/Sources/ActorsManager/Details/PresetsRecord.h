@@ -0,0 +1,227 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct z_stream_s;
+
+/**
+ * @brief Бинарный формат записи пресетов актёров в co-save.
+ *
+ * Каждая запись - полный снимок пресетов всех актёров на момент сохранения, без ссылок на прошлые сохранения.
+ *
+ * Разжатое содержимое записи (все числа little-endian):
+ *   u32 MAGIC, u16 FORMAT_VERSION, u16 зарезервировано;
+ *   u32 количество строк, для каждой строки u16 длина и байты id пресета;
+ *   u32 количество актёров, для каждого u32 formId, u8 количество пресетов
+ *   и для каждого пресета u8 тип (PresetType) и u32 индекс строки в таблице.
+ * Содержимое сжимается потоком deflate и пишется в запись кусками, после него идёт u32 размер разжатых данных.
+ */
+namespace PresetsRecord
+{
+	constexpr uint32_t MAGIC = 0x42524244; // "DBRB"
+	constexpr uint16_t FORMAT_VERSION = 1;
+
+	/**
+	 * @brief Пресет актёра в записи: тип и id.
+	 */
+	struct Entry
+	{
+		uint8_t type{};
+		std::string_view id{};
+	};
+
+	/**
+	 * @brief Приёмник байтов. Возвращает false, если записать не удалось.
+	 */
+	using Sink = std::function<bool(const uint8_t* data, size_t size)>;
+
+	/**
+	 * @brief Собирает актёров и их пресеты в компактное представление с общей таблицей строк.
+	 */
+	class Encoder
+	{
+	public:
+		/**
+		 * @brief Начать нового актёра. Следующие addPreset относятся к нему.
+		 * @param formId FormID актёра.
+		 */
+		void beginActor(uint32_t formId);
+
+		/**
+		 * @brief Добавить пресет текущему актёру. Не больше 255 пресетов на актёра.
+		 * @param type Тип пресета.
+		 * @param id Id пресета, копируется в таблицу строк один раз.
+		 */
+		void addPreset(uint8_t type, std::string_view id);
+
+		/**
+		 * @brief Количество добавленных актёров.
+		 */
+		size_t actorsCount() const noexcept;
+
+		/**
+		 * @brief Размер содержимого, которое запишет write(), в байтах. Известен до записи,
+		 * поэтому предел u32 для размера в конце записи проверяется до открытия записи.
+		 */
+		uint64_t size() const noexcept;
+
+		/**
+		 * @brief Записать содержимое в sink кусками не больше chunkSize.
+		 * @return false если sink вернул false.
+		 */
+		bool write(const Sink& sink, size_t chunkSize = 64 * 1024) const;
+
+	private:
+		uint32_t intern(std::string_view id);
+
+		std::deque<std::string> m_strings;
+		std::unordered_map<std::string_view, uint32_t> m_stringIndex;
+		std::vector<uint8_t> m_actors;
+		size_t m_countOffset{ 0 };
+		uint32_t m_actorsCount{ 0 };
+		uint64_t m_stringsSize{ 0 };
+	};
+
+	/**
+	 * @brief Обработчик разобранного актёра. id в Entry действительны только во время вызова.
+	 */
+	using ActorCallback = std::function<void(uint32_t formId, std::span<const Entry> presets)>;
+
+	/**
+	 * @brief Потоковый разбор разжатого содержимого записи.
+	 *
+	 * Данные подаются порциями любого размера, актёры выдаются по мере поступления.
+	 * В памяти держится только таблица строк и недочитанный хвост последней порции.
+	 */
+	class Decoder
+	{
+	public:
+		explicit Decoder(ActorCallback onActor);
+
+		/**
+		 * @brief Подать очередную порцию данных.
+		 * @return false если данные повреждены, версия формата неизвестна или после конца записи идут лишние байты.
+		 */
+		bool feed(const uint8_t* data, size_t size);
+
+		/**
+		 * @brief Прочитаны ли все актёры, объявленные в записи.
+		 */
+		bool finished() const noexcept;
+
+	private:
+		enum class Stage
+		{
+			Header,
+			StringsCount,
+			Strings,
+			ActorsCount,
+			Actors,
+			Done,
+			Failed
+		};
+
+		/**
+		 * @brief Разобрать столько целых элементов из m_pending, сколько есть.
+		 * @return Количество использованных байт.
+		 */
+		size_t parse();
+
+		ActorCallback m_onActor;
+		Stage m_stage{ Stage::Header };
+		std::vector<uint8_t> m_pending;
+		std::vector<std::string> m_strings;
+		std::vector<Entry> m_entries;
+		uint32_t m_stringsCount{ 0 };
+		uint32_t m_actorsLeft{ 0 };
+	};
+
+	/**
+	 * @brief Потоковое сжатие deflate с выдачей результата кусками фиксированного размера.
+	 */
+	class DeflateWriter
+	{
+	public:
+		explicit DeflateWriter(Sink sink, size_t chunkSize = 64 * 1024);
+		~DeflateWriter();
+		DeflateWriter(const DeflateWriter&) = delete;
+		DeflateWriter& operator=(const DeflateWriter&) = delete;
+
+		/**
+		 * @brief Сжать очередную порцию данных.
+		 */
+		bool write(const uint8_t* data, size_t size);
+
+		/**
+		 * @brief Завершить поток и выдать остаток.
+		 */
+		bool finish();
+
+		/**
+		 * @brief Сколько байт было подано на вход.
+		 */
+		uint64_t totalIn() const noexcept;
+
+	private:
+		bool pump(int flush);
+
+		Sink m_sink;
+		std::unique_ptr<z_stream_s> m_stream;
+		std::vector<uint8_t> m_out;
+		uint64_t m_totalIn{ 0 };
+		bool m_ok{ false };
+	};
+
+	/**
+	 * @brief Потоковая распаковка inflate с фиксированным окном и выходным буфером.
+	 *
+	 * Сжатые данные подаются порциями, распакованные отдаются в sink кусками не больше chunkSize,
+	 * поэтому расход памяти не зависит от размера записи.
+	 */
+	class InflateWriter
+	{
+	public:
+		/**
+		 * @param sink Приёмник распакованных данных.
+		 * @param maxOut Предел распакованного объёма, при превышении распаковка прерывается.
+		 * @param chunkSize Размер выходного буфера.
+		 */
+		explicit InflateWriter(Sink sink, uint64_t maxOut = UINT32_MAX, size_t chunkSize = 64 * 1024);
+		~InflateWriter();
+		InflateWriter(const InflateWriter&) = delete;
+		InflateWriter& operator=(const InflateWriter&) = delete;
+
+		/**
+		 * @brief Распаковать очередную порцию сжатых данных.
+		 * @return false если поток повреждён, превышен maxOut, sink вернул false или данные идут после конца потока.
+		 */
+		bool write(const uint8_t* data, size_t size);
+
+		/**
+		 * @brief Дошёл ли поток до конца.
+		 */
+		bool finished() const noexcept;
+
+		/**
+		 * @brief Сколько байт распаковано.
+		 */
+		uint64_t totalOut() const noexcept;
+
+	private:
+		Sink m_sink;
+		std::unique_ptr<z_stream_s> m_stream;
+		std::vector<uint8_t> m_out;
+		uint64_t m_maxOut;
+		uint64_t m_totalOut{ 0 };
+		bool m_ok{ false };
+		bool m_finished{ false };
+	};
+}
@@ -0,0 +1,220 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "PresetsRecord.h"
+
+namespace PresetsRecord
+{
+	/**
+	 * @brief Обработчик событий boost::json::basic_parser для старой JSON записи пресетов (SerializationVerJson).
+	 *
+	 * Запись имеет вид [{"formid": N, "presets": [{"type": T, "id": "..."}, ...]}, ...]. Актёр передаётся в onActor,
+	 * как только закрывается его объект, поэтому дерево документа не строится и в памяти держатся только
+	 * пресеты текущего актёра. Правила пропуска совпадают с прежним разбором через boost::json::value:
+	 * корень не массив - ничего не выдаётся; актёр без целого formid или без массива presets пропускается;
+	 * пресет без строкового id или целого type пропускается. Проверка диапазона type остаётся за onActor.
+	 * Методы-обработчики шаблонные по string_view и error_code, чтобы заголовок не тянул boost.
+	 */
+	class LegacyJsonHandler
+	{
+	public:
+		static constexpr std::size_t max_object_size = std::numeric_limits<std::size_t>::max();
+		static constexpr std::size_t max_array_size = std::numeric_limits<std::size_t>::max();
+		static constexpr std::size_t max_key_size = std::numeric_limits<std::size_t>::max();
+		static constexpr std::size_t max_string_size = std::numeric_limits<std::size_t>::max();
+
+		explicit LegacyJsonHandler(ActorCallback onActor) :
+			m_onActor(std::move(onActor)) {}
+
+		/**
+		 * @brief Количество актёров, переданных в onActor.
+		 */
+		size_t actorsCount() const noexcept {
+			return m_actorsCount;
+		}
+
+		template <class Ec> bool on_document_begin(Ec&) { return true; }
+		template <class Ec> bool on_document_end(Ec&) { return true; }
+
+		template <class Ec>
+		bool on_array_begin(Ec&) {
+			if (m_depth == 0) {
+				m_rootIsArray = true;
+			}
+			else if (inActor() && m_key == "presets") {
+				m_inPresets = true;
+				m_actor.hasPresets = true;
+			}
+			++m_depth;
+			return true;
+		}
+
+		template <class Ec>
+		bool on_array_end(std::size_t, Ec&) {
+			--m_depth;
+			if (m_inPresets && m_depth == ACTOR_DEPTH) {
+				m_inPresets = false;
+			}
+			return true;
+		}
+
+		template <class Ec>
+		bool on_object_begin(Ec&) {
+			++m_depth;
+			if (m_rootIsArray && m_depth == ACTOR_DEPTH) {
+				m_inActor = true;
+				m_actor.clear();
+			}
+			else if (m_inPresets && m_depth == PRESET_DEPTH) {
+				m_inPreset = true;
+				m_preset = {};
+			}
+			m_key.clear();
+			return true;
+		}
+
+		template <class Ec>
+		bool on_object_end(std::size_t, Ec&) {
+			if (inPreset()) {
+				m_inPreset = false;
+				if (m_preset.hasId && m_preset.type >= 0 && m_preset.type <= std::numeric_limits<uint8_t>::max()) {
+					m_actor.entries.push_back({ static_cast<uint8_t>(m_preset.type), {} });
+					m_actor.ids.push_back(std::move(m_preset.id));
+				}
+			}
+			else if (inActor()) {
+				m_inActor = false;
+				emitActor();
+			}
+			--m_depth;
+			return true;
+		}
+
+		template <class Sv, class Ec>
+		bool on_key_part(Sv s, std::size_t, Ec&) {
+			if (!m_keyPending) {
+				m_key.clear();
+				m_keyPending = true;
+			}
+			m_key.append(s.data(), s.size());
+			return true;
+		}
+
+		template <class Sv, class Ec>
+		bool on_key(Sv s, std::size_t, Ec&) {
+			if (!m_keyPending) {
+				m_key.clear();
+			}
+			m_key.append(s.data(), s.size());
+			m_keyPending = false;
+			return true;
+		}
+
+		template <class Sv, class Ec>
+		bool on_string_part(Sv s, std::size_t, Ec&) {
+			// Копятся только id пресетов, остальные строки пропускаются без буфера
+			if (inPreset() && m_key == "id") {
+				m_preset.id.append(s.data(), s.size());
+			}
+			return true;
+		}
+
+		template <class Sv, class Ec>
+		bool on_string(Sv s, std::size_t, Ec&) {
+			if (inPreset() && m_key == "id") {
+				m_preset.id.append(s.data(), s.size());
+				m_preset.hasId = true;
+			}
+			return true;
+		}
+
+		template <class Sv, class Ec> bool on_number_part(Sv, Ec&) { return true; }
+
+		template <class Sv, class Ec>
+		bool on_int64(int64_t value, Sv, Ec&) {
+			if (inActor() && m_key == "formid") {
+				m_actor.formId = static_cast<uint32_t>(value);
+				m_actor.hasFormId = true;
+			}
+			else if (inPreset() && m_key == "type") {
+				m_preset.type = value;
+			}
+			return true;
+		}
+
+		template <class Sv, class Ec> bool on_uint64(uint64_t, Sv, Ec&) { return true; }
+		template <class Sv, class Ec> bool on_double(double, Sv, Ec&) { return true; }
+		template <class Ec> bool on_bool(bool, Ec&) { return true; }
+		template <class Ec> bool on_null(Ec&) { return true; }
+		template <class Sv, class Ec> bool on_comment_part(Sv, Ec&) { return true; }
+		template <class Sv, class Ec> bool on_comment(Sv, Ec&) { return true; }
+
+	private:
+		static constexpr size_t ACTOR_DEPTH = 2;	///< [ { - объект актёра внутри корневого массива.
+		static constexpr size_t PRESET_DEPTH = 4;	///< [ { "presets": [ { - объект пресета.
+
+		struct Actor
+		{
+			uint32_t formId{ 0 };
+			bool hasFormId{ false };
+			bool hasPresets{ false };
+			std::vector<Entry> entries;
+			std::vector<std::string> ids;
+
+			void clear() {
+				formId = 0;
+				hasFormId = false;
+				hasPresets = false;
+				entries.clear();
+				ids.clear();
+			}
+		};
+
+		struct PendingPreset
+		{
+			int64_t type{ -1 };
+			std::string id;
+			bool hasId{ false };
+		};
+
+		/// Значение лежит прямо в объекте актёра, а не во вложенном контейнере.
+		bool inActor() const noexcept {
+			return m_inActor && m_depth == ACTOR_DEPTH;
+		}
+
+		/// Значение лежит прямо в объекте пресета.
+		bool inPreset() const noexcept {
+			return m_inPreset && m_depth == PRESET_DEPTH;
+		}
+
+		void emitActor() {
+			if (!m_actor.hasFormId || !m_actor.hasPresets) {
+				return;
+			}
+			// id хранятся отдельно: вектор строк мог переехать, ссылки на них ставятся перед вызовом
+			for (size_t i = 0; i < m_actor.entries.size(); ++i) {
+				m_actor.entries[i].id = m_actor.ids[i];
+			}
+			if (m_onActor) {
+				m_onActor(m_actor.formId, m_actor.entries);
+			}
+			++m_actorsCount;
+		}
+
+		ActorCallback m_onActor;
+		Actor m_actor{};
+		PendingPreset m_preset{};
+		std::string m_key{};
+		size_t m_depth{ 0 };
+		size_t m_actorsCount{ 0 };
+		bool m_rootIsArray{ false };
+		bool m_inActor{ false };
+		bool m_inPresets{ false };
+		bool m_inPreset{ false };
+		bool m_keyPending{ false };
+	};
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include "ActorsPresetHashEquals.hpp"
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+/**
+ * @brief Потокобезопасное хранилище пресетов актёров, разбитое на шарды.
+ *
+ * Актёры распределяются по SHARDS_COUNT независимым таблицам по formId, у каждой свой std::shared_mutex.
+ * Чтения берут разделяемую блокировку только своего шарда и не ждут друг друга, в том числе обход
+ * при сериализации. Запись блокирует один шард, поэтому поиск из хуков ждёт не дольше одной вставки
+ * в тот же шард, а не всю сериализацию или применение пресетов.
+ * Ссылки на элементы наружу не отдаются: чтение либо копирует набор пресетов, либо выполняется в visit под блокировкой.
+ */
+class ShardedPresetsMap
+{
+public:
+	using Presets = ActorsManagerDefs::Presets;
+	using Map = std::unordered_map<uint32_t, Presets>;
+
+	static constexpr size_t SHARDS_COUNT = 64;
+
+	/**
+	 * @brief Есть ли актёр в хранилище.
+	 * @param formId FormID актёра.
+	 */
+	inline bool contains(uint32_t formId) const {
+		const auto& shard = shardFor(formId);
+		std::shared_lock lock(shard.mutex);
+		return shard.map.contains(formId);
+	}
+
+	/**
+	 * @brief Копия набора пресетов актёра.
+	 * @param formId FormID актёра.
+	 * @return Пресеты актёра или std::nullopt, если актёра нет.
+	 */
+	inline std::optional<Presets> find(uint32_t formId) const {
+		const auto& shard = shardFor(formId);
+		std::shared_lock lock(shard.mutex);
+		if (auto it = shard.map.find(formId); it != shard.map.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Выполнить чтение пресетов актёра под разделяемой блокировкой шарда без копирования.
+	 * @param formId FormID актёра.
+	 * @param func Вызывается с const Presets&, если актёр найден. Не должна обращаться к хранилищу.
+	 * @return true если актёр найден и func была вызвана.
+	 */
+	template <class Func>
+	inline bool visit(uint32_t formId, Func&& func) const {
+		const auto& shard = shardFor(formId);
+		std::shared_lock lock(shard.mutex);
+		if (auto it = shard.map.find(formId); it != shard.map.end()) {
+			func(it->second);
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Добавить актёра или заменить его набор пресетов.
+	 * @param formId FormID актёра.
+	 * @param presets Новый набор пресетов.
+	 */
+	inline void insert_or_assign(uint32_t formId, Presets presets) {
+		auto& shard = shardFor(formId);
+		std::unique_lock lock(shard.mutex);
+		shard.map.insert_or_assign(formId, std::move(presets));
+	}
+
+	/**
+	 * @brief Изменить набор пресетов актёра под эксклюзивной блокировкой шарда. Если актёра нет, он создаётся с пустым набором.
+	 * @param formId FormID актёра.
+	 * @param func Вызывается с Presets&. Не должна обращаться к хранилищу.
+	 */
+	template <class Func>
+	inline void update(uint32_t formId, Func&& func) {
+		auto& shard = shardFor(formId);
+		std::unique_lock lock(shard.mutex);
+		func(shard.map[formId]);
+	}
+
+	/**
+	 * @brief Перенести в хранилище все записи карты, заменяя существующие.
+	 * @param presets Карта актёров и их пресетов.
+	 */
+	inline void merge(Map&& presets) {
+		for (auto& [formId, actorPresets] : presets) {
+			insert_or_assign(formId, std::move(actorPresets));
+		}
+		presets.clear();
+	}
+
+	/**
+	 * @brief Обойти всех актёров. Шарды блокируются на чтение по одному.
+	 * @param func Вызывается с (uint32_t formId, const Presets&). Не должна обращаться к хранилищу.
+	 */
+	template <class Func>
+	inline void forEach(Func&& func) const {
+		for (const auto& shard : m_shards) {
+			std::shared_lock lock(shard.mutex);
+			for (const auto& [formId, presets] : shard.map) {
+				func(formId, presets);
+			}
+		}
+	}
+
+	/**
+	 * @brief Копия всего хранилища одной картой. Для отладочных дампов.
+	 */
+	inline Map snapshot() const {
+		Map result;
+		forEach([&result](uint32_t formId, const Presets& presets) {
+			result.emplace(formId, presets);
+		});
+		return result;
+	}
+
+	/**
+	 * @brief Удалить всех актёров.
+	 */
+	inline void clear() {
+		for (auto& shard : m_shards) {
+			std::unique_lock lock(shard.mutex);
+			shard.map.clear();
+		}
+	}
+
+	/**
+	 * @brief Количество актёров. При одновременной записи значение приблизительное.
+	 */
+	inline size_t size() const {
+		size_t result = 0;
+		for (const auto& shard : m_shards) {
+			std::shared_lock lock(shard.mutex);
+			result += shard.map.size();
+		}
+		return result;
+	}
+
+	/**
+	 * @brief Пусто ли хранилище.
+	 */
+	inline bool empty() const {
+		for (const auto& shard : m_shards) {
+			std::shared_lock lock(shard.mutex);
+			if (!shard.map.empty()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	struct Shard
+	{
+		mutable std::shared_mutex mutex;
+		Map map;
+	};
+
+	// FormID последовательны внутри плагина, старший байт - индекс плагина. Перемешиваем, чтобы соседние id попадали в разные шарды.
+	static inline size_t shardIndex(uint32_t formId) noexcept {
+		return static_cast<size_t>((formId * 0x9E3779B1u) >> 26) & (SHARDS_COUNT - 1);
+	}
+
+	inline Shard& shardFor(uint32_t formId) noexcept {
+		return m_shards[shardIndex(formId)];
+	}
+
+	inline const Shard& shardFor(uint32_t formId) const noexcept {
+		return m_shards[shardIndex(formId)];
+	}
+
+	std::array<Shard, SHARDS_COUNT> m_shards;
+};
@@ -0,0 +1,158 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+/**
+ * @brief Очередь актёров, ожидающих применения пресетов, с разбором по бюджету времени.
+ *
+ * Актёр хранится один раз с расстоянием до игрока и моментом первой постановки. Расстояние считается
+ * при постановке, а очередь всё время упорядочена по нему, при равном расстоянии - по порядку постановки.
+ * drain() снимает актёров с начала очереди и останавливается, когда исчерпан бюджет времени, так что
+ * стоимость вызова зависит от числа обработанных актёров, а не от длины очереди. Необработанные остаются
+ * до следующего вызова. Актёр, удалённый через erase() во время разбора (например, уже применённый
+ * по событию загрузки), считается пропущенным.
+ * Потокобезопасна, apply вызывается вне блокировки. drain() одновременно вызывает только один поток.
+ *
+ * @tparam Clock Тип часов со статическим now() (по умолчанию std::chrono::steady_clock).
+ */
+template <class Clock = std::chrono::steady_clock>
+class WaitingActorsQueue
+{
+public:
+	using Duration = typename Clock::duration;
+	using ApplyFn = std::function<bool(uint32_t formId)>;
+
+	/**
+	 * @brief Итог одного вызова drain().
+	 */
+	struct DrainResult
+	{
+		size_t applied{ 0 };	///< apply вернул true.
+		size_t failed{ 0 };		///< apply вернул false.
+		size_t skipped{ 0 };	///< Удалены из очереди другим путём во время разбора.
+		size_t left{ 0 };		///< Осталось в очереди.
+	};
+
+	/**
+	 * @brief Поставить актёра в очередь. Повторная постановка не меняет его место и расстояние.
+	 * @param formId FormID актёра.
+	 * @param distance Расстояние до игрока на момент постановки, меньше - раньше.
+	 */
+	void push(uint32_t formId, float distance = 0.0f) {
+		std::lock_guard lock(m_mutex);
+		if (m_entries.contains(formId)) {
+			return;
+		}
+		auto it = m_order.insert({ distance, Clock::now(), m_nextSeq++, formId }).first;
+		m_entries.emplace(formId, it);
+	}
+
+	/**
+	 * @brief Убрать актёра из очереди.
+	 * @return true если актёр был в очереди.
+	 */
+	bool erase(uint32_t formId) {
+		std::lock_guard lock(m_mutex);
+		auto it = m_entries.find(formId);
+		if (it == m_entries.end()) {
+			return false;
+		}
+		m_order.erase(it->second);
+		m_entries.erase(it);
+		if (m_draining) {
+			++m_skipped;
+		}
+		return true;
+	}
+
+	void clear() {
+		std::lock_guard lock(m_mutex);
+		m_order.clear();
+		m_entries.clear();
+	}
+
+	bool empty() const {
+		std::lock_guard lock(m_mutex);
+		return m_entries.empty();
+	}
+
+	size_t size() const {
+		std::lock_guard lock(m_mutex);
+		return m_entries.size();
+	}
+
+	/**
+	 * @brief Обработать актёров в порядке приоритета, пока не исчерпан бюджет.
+	 *
+	 * Хотя бы один актёр обрабатывается всегда, поэтому очередь продвигается даже при нулевом бюджете.
+	 * За вызов обрабатывается не больше актёров, чем было в очереди к его началу: поставленные из apply
+	 * не зацикливают разбор.
+	 * @param budget Бюджет времени на вызов.
+	 * @param apply Применение пресетов актёру.
+	 */
+	DrainResult drain(Duration budget, const ApplyFn& apply) {
+		DrainResult result;
+		const auto start = Clock::now();
+
+		size_t pending;
+		{
+			std::lock_guard lock(m_mutex);
+			pending = m_entries.size();
+			m_draining = true;
+			m_skipped = 0;
+		}
+
+		for (size_t taken = 0; taken < pending; ++taken) {
+			if (taken > 0 && Clock::now() - start >= budget) {
+				break;
+			}
+			uint32_t formId;
+			{
+				std::lock_guard lock(m_mutex);
+				if (m_order.empty()) {
+					break;
+				}
+				formId = m_order.begin()->formId;
+				m_order.erase(m_order.begin());
+				m_entries.erase(formId);
+			}
+			apply(formId) ? ++result.applied : ++result.failed;
+		}
+
+		std::lock_guard lock(m_mutex);
+		m_draining = false;
+		result.skipped = m_skipped;
+		result.left = m_entries.size();
+		return result;
+	}
+
+private:
+	struct Entry
+	{
+		float distance;
+		typename Clock::time_point queuedAt;
+		uint64_t seq;
+		uint32_t formId;
+
+		bool operator<(const Entry& other) const noexcept {
+			if (distance != other.distance) {
+				return distance < other.distance;
+			}
+			if (queuedAt != other.queuedAt) {
+				return queuedAt < other.queuedAt;
+			}
+			return seq < other.seq;
+		}
+	};
+
+	std::set<Entry> m_order;
+	std::unordered_map<uint32_t, typename std::set<Entry>::iterator> m_entries;
+	uint64_t m_nextSeq{ 0 };
+	size_t m_skipped{ 0 };
+	bool m_draining{ false };
+	mutable std::mutex m_mutex;
+};
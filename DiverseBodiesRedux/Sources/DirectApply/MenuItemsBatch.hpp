@@ -0,0 +1,62 @@
+#pragma once
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Пакетная передача элементов меню DirectApply во Flash.
+ *
+ * Весь список упаковывается в один массив [[type, label, state], ...] и уходит в AS3 одним Invoke
+ * вместо отдельного вызова на каждый элемент. Со старым SWF без пакетного метода - прежние вызовы по одному. Значения GFx создаёт Sink,
+ * поэтому упаковку можно проверить с тестовым приёмником.
+ */
+namespace menuBatch {
+
+    /**
+     * @brief Упаковать элементы в один массив и отправить одним вызовом.
+     * @tparam Sink Тип с Value, Value makeArray(), append(Value&, int), append(Value&, const char*),
+     * append(Value&, const Value&) и bool invoke(const char* method, Value& argument).
+     * @tparam Items Контейнер элементов с полями type, label (std::string), state и hasState.
+     * @param sink Приёмник значений.
+     * @param method Имя метода AS3.
+     * @param items Элементы меню. Строки не копируются и должны жить до конца вызова.
+     * @return Результат invoke.
+     */
+    template <class Sink, class Items>
+    bool pushItems(Sink& sink, const char* method, const Items& items)
+    {
+        auto array = sink.makeArray();
+        for (const auto& item : items) {
+            auto element = sink.makeArray();
+            sink.append(element, static_cast<int>(item.type));
+            sink.append(element, item.label.c_str());
+            // Состояние передаётся всегда, AS3 ожидает три поля
+            sink.append(element, item.hasState ? static_cast<int>(item.state) : 0);
+            sink.append(array, element);
+        }
+        return sink.invoke(method, array);
+    }
+
+    /**
+     * @brief Отправить элементы пакетом, а если пакетного метода нет, по одному.
+     *
+     * SWF, собранный до появления пакетного метода, на Invoke отвечает false. Тогда каждый элемент уходит
+     * отдельным вызовом itemMethod(type, label, state), как раньше.
+     * @tparam Sink Как у pushItems, плюс bool invoke(const char* method, int type, const char* label, int state).
+     * @param batchMethod Имя пакетного метода AS3.
+     * @param itemMethod Имя метода AS3 для одного элемента.
+     * @return true если элементы переданы пакетом или все поэлементные вызовы прошли.
+     */
+    template <class Sink, class Items>
+    bool pushItemsOrEach(Sink& sink, const char* batchMethod, const char* itemMethod, const Items& items)
+    {
+        if (pushItems(sink, batchMethod, items)) {
+            return true;
+        }
+        bool ok = true;
+        for (const auto& item : items) {
+            ok = sink.invoke(itemMethod, static_cast<int>(item.type), item.label.c_str(), item.hasState ? static_cast<int>(item.state) : 0) && ok;
+        }
+        return ok;
+    }
+
+}
@@ -0,0 +1,236 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Отфильтрованный список имён пресетов для меню DirectApply с постраничной выдачей и поиском по имени.
+ *
+ * Имена копируются один раз в общий буфер (интернируются), рядом хранится их копия в нижнем регистре,
+ * поэтому поиск не создаёт строк и не меняет регистр на каждый запрос. Регистр понижается только у ASCII,
+ * остальные байты UTF-8 сравниваются как есть. Меню показывает окно (offset, count) текущей выборки,
+ * а не весь список. Не потокобезопасен: живёт в меню и трогается из потока UI.
+ */
+class PresetListModel
+{
+public:
+    /**
+     * @brief Режим поиска по имени.
+     */
+    enum class Match
+    {
+        Contains,   ///< Подстрока в любом месте имени.
+        Prefix      ///< Начало имени.
+    };
+
+    /**
+     * @brief Окно выборки для одной страницы меню.
+     */
+    struct Page
+    {
+        size_t index{ 0 };      ///< Номер страницы, приведённый к допустимому.
+        size_t count{ 0 };      ///< Всего страниц, не меньше 1.
+        size_t offset{ 0 };     ///< Позиция первого элемента страницы в выборке.
+        std::vector<std::string_view> names{};  ///< Имена на странице. Живут до следующего assign().
+    };
+
+    /**
+     * @brief Заменить список. Фильтр по имени сбрасывается.
+     * @param items Элементы в порядке показа.
+     * @param nameOf Возвращает имя элемента (std::string_view или то, что в него преобразуется).
+     */
+    template <class Items, class NameFn>
+    void assign(const Items& items, NameFn nameOf)
+    {
+        m_names.clear();
+        m_lower.clear();
+        m_offsets.clear();
+
+        size_t bytes = 0;
+        for (const auto& item : items) {
+            bytes += std::string_view{ nameOf(item) }.size() + 1;
+        }
+        m_names.reserve(bytes);
+        m_offsets.reserve(std::size(items) + 1);
+
+        for (const auto& item : items) {
+            m_offsets.push_back(static_cast<uint32_t>(m_names.size()));
+            m_names.append(std::string_view{ nameOf(item) });
+            // Разделитель: запрос не содержит '\0', поэтому совпадение не может перейти через границу имён
+            m_names.push_back('\0');
+        }
+        m_offsets.push_back(static_cast<uint32_t>(m_names.size()));
+
+        m_lower = m_names;
+        std::transform(m_lower.begin(), m_lower.end(), m_lower.begin(), toLower);
+
+        resetFilter();
+    }
+
+    /**
+     * @brief Отфильтровать список по имени без учёта регистра. Пустой запрос показывает всё.
+     * @param query Искомый текст.
+     * @param match Режим поиска.
+     */
+    void setFilter(std::string_view query, Match match = Match::Contains)
+    {
+        m_query.assign(query);
+        std::transform(m_query.begin(), m_query.end(), m_query.begin(), toLower);
+
+        if (m_query.empty() || m_query.find('\0') != std::string::npos) {
+            resetFilter();
+            return;
+        }
+
+        m_visible.clear();
+        const std::string_view lower{ m_lower };
+        if (match == Match::Prefix) {
+            for (uint32_t i = 0; i < total(); ++i) {
+                if (lower.compare(m_offsets[i], m_query.size(), m_query) == 0) {
+                    m_visible.push_back(i);
+                }
+            }
+            return;
+        }
+
+        // Один проход по общему буферу: после совпадения сразу переходим к следующему имени
+        uint32_t entry = 0;
+        for (size_t pos = lower.find(m_query); pos != std::string_view::npos; pos = lower.find(m_query, pos)) {
+            entry = static_cast<uint32_t>(std::upper_bound(m_offsets.begin() + entry, m_offsets.end(), pos) - m_offsets.begin() - 1);
+            m_visible.push_back(entry);
+            pos = m_offsets[entry + 1];
+        }
+    }
+
+    /**
+     * @brief Текущий запрос в нижнем регистре.
+     */
+    const std::string& query() const noexcept
+    {
+        return m_query;
+    }
+
+    /**
+     * @brief Количество имён в списке без учёта фильтра.
+     */
+    size_t total() const noexcept
+    {
+        return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+    }
+
+    /**
+     * @brief Количество имён, прошедших фильтр.
+     */
+    size_t size() const noexcept
+    {
+        return m_visible.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_visible.empty();
+    }
+
+    /**
+     * @brief Имя из выборки.
+     * @param position Позиция в выборке, меньше size().
+     */
+    std::string_view name(size_t position) const noexcept
+    {
+        const uint32_t i = m_visible[position];
+        return std::string_view{ m_names }.substr(m_offsets[i], length(i));
+    }
+
+    /**
+     * @brief Индекс элемента в исходном списке assign() по позиции в выборке.
+     */
+    size_t sourceIndex(size_t position) const noexcept
+    {
+        return m_visible[position];
+    }
+
+    /**
+     * @brief Окно выборки.
+     * @param offset Позиция первого имени.
+     * @param count Максимальное количество имён.
+     * @return Имена окна, пустой вектор если offset за концом выборки.
+     */
+    std::vector<std::string_view> window(size_t offset, size_t count) const
+    {
+        std::vector<std::string_view> result;
+        if (offset >= size()) {
+            return result;
+        }
+        const size_t end = offset + std::min(count, size() - offset);
+        result.reserve(end - offset);
+        for (size_t position = offset; position < end; ++position) {
+            result.push_back(name(position));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Страница выборки. Номер страницы за пределами приводится к последней.
+     * @param index Номер страницы с нуля.
+     * @param pageSize Размер страницы, 0 означает 1.
+     */
+    Page page(size_t index, size_t pageSize) const
+    {
+        pageSize = std::max<size_t>(pageSize, 1);
+        Page result;
+        result.count = std::max<size_t>((size() + pageSize - 1) / pageSize, 1);
+        result.index = std::min(index, result.count - 1);
+        result.offset = result.index * pageSize;
+        result.names = window(result.offset, pageSize);
+        return result;
+    }
+
+    /**
+     * @brief Различные первые символы имён в нижнем регистре по возрастанию, без учёта фильтра.
+     * Подходят как варианты фильтра Match::Prefix. Берутся только печатные ASCII-символы, кроме запятой
+     * (ей разделяются варианты свитчера), имена с другими первыми символами видны без фильтра.
+     */
+    std::vector<char> initials() const
+    {
+        bool seen[256]{};
+        for (uint32_t i = 0; i < total(); ++i) {
+            if (length(i) > 0) {
+                seen[static_cast<unsigned char>(m_lower[m_offsets[i]])] = true;
+            }
+        }
+        std::vector<char> result;
+        for (int c = '!'; c <= '~'; ++c) {
+            if (seen[c] && c != ',') {
+                result.push_back(static_cast<char>(c));
+            }
+        }
+        return result;
+    }
+
+private:
+    static char toLower(char c) noexcept
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    size_t length(uint32_t i) const noexcept
+    {
+        return m_offsets[i + 1] - m_offsets[i] - 1;
+    }
+
+    void resetFilter()
+    {
+        m_query.clear();
+        m_visible.resize(total());
+        std::iota(m_visible.begin(), m_visible.end(), 0u);
+    }
+
+    std::string m_names{};              ///< Имена подряд, каждое завершается '\0'.
+    std::string m_lower{};              ///< То же в нижнем регистре.
+    std::vector<uint32_t> m_offsets{};  ///< Начало каждого имени, последний элемент - размер буфера.
+    std::vector<uint32_t> m_visible{};  ///< Индексы имён, прошедших фильтр.
+    std::string m_query{};
+};
@@ -0,0 +1,164 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+/**
+ * @brief Один слот превью пресета в меню DirectApply: дребезг наведения с правилом "побеждает последний".
+ *
+ * hover() кладёт пресет в слот и выдаёт билет со сроком now + settle. Новое наведение заменяет ожидающий
+ * пресет и делает старые билеты недействительными. take() по истечении срока отдаёт пресет только для
+ * последнего билета, поэтому из серии быстрых наведений применяется ровно одно. Слот помнит, какой пресет
+ * сейчас показан, чтобы следующее превью заменяло его, а не применялось с нуля.
+ * Наведение на уже показанный пресет снимает ожидание и ничего не планирует.
+ * Потокобезопасен.
+ *
+ * @tparam Clock Тип часов (по умолчанию std::chrono::steady_clock).
+ */
+template <class Clock = std::chrono::steady_clock>
+class BasicPreviewDebouncer
+{
+public:
+    using Duration = typename Clock::duration;
+    using TimePoint = typename Clock::time_point;
+
+    /**
+     * @brief Билет ожидающего превью. Пустой билет (generation == 0) означает, что планировать нечего.
+     */
+    struct Ticket
+    {
+        uint64_t generation{ 0 };
+        TimePoint due{};
+
+        explicit operator bool() const noexcept
+        {
+            return generation != 0;
+        }
+    };
+
+    /**
+     * @brief Превью, которое пора применить.
+     */
+    struct Fire
+    {
+        std::string key;        ///< Пресет для применения.
+        std::string previous;   ///< Пресет, показанный до него, пусто если превью ещё не было.
+    };
+
+    /**
+     * @param settle Сколько наведение должно продержаться, прежде чем превью применится.
+     */
+    explicit BasicPreviewDebouncer(Duration settle = std::chrono::milliseconds(300)) :
+        m_settle(settle) {}
+
+    void setSettle(Duration settle)
+    {
+        std::lock_guard lock(m_mutex);
+        m_settle = settle;
+    }
+
+    Duration settle() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_settle;
+    }
+
+    /**
+     * @brief Наведение на пресет.
+     * @param key Идентификатор пресета.
+     * @param now Текущее время.
+     * @return Билет, который нужно предъявить take() не раньше ticket.due, или пустой билет.
+     */
+    Ticket hover(std::string key, TimePoint now)
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_generation;
+        if (key == m_previewed) {
+            m_pending.reset();
+            return {};
+        }
+        m_pending = Pending{ std::move(key), m_generation, now + m_settle };
+        return Ticket{ m_generation, m_pending->due };
+    }
+
+    /**
+     * @brief Забрать превью по билету. Пресет считается показанным с этого момента.
+     * @param generation Номер билета.
+     * @param now Текущее время.
+     * @return Превью, если билет последний и срок наступил, иначе std::nullopt.
+     */
+    std::optional<Fire> take(uint64_t generation, TimePoint now)
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_pending || m_pending->generation != generation || now < m_pending->due) {
+            return std::nullopt;
+        }
+        Fire fire{ std::move(m_pending->key), std::move(m_previewed) };
+        m_pending.reset();
+        m_previewed = fire.key;
+        return fire;
+    }
+
+    /**
+     * @brief Снять ожидающее превью. Показанный пресет остаётся.
+     */
+    void cancel()
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_generation;
+        m_pending.reset();
+    }
+
+    /**
+     * @brief Пресет показан в обход слота (например, выбран кнопкой). Ожидающее превью снимается.
+     */
+    void commit(std::string key)
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_generation;
+        m_pending.reset();
+        m_previewed = std::move(key);
+    }
+
+    /**
+     * @brief Начать новую сессию меню: снять ожидание и забыть показанный пресет.
+     */
+    void reset()
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_generation;
+        m_pending.reset();
+        m_previewed.clear();
+    }
+
+    bool pending() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_pending.has_value();
+    }
+
+    std::string previewed() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_previewed;
+    }
+
+private:
+    struct Pending
+    {
+        std::string key;
+        uint64_t generation;
+        TimePoint due;
+    };
+
+    Duration m_settle;
+    std::optional<Pending> m_pending{};
+    std::string m_previewed{};
+    uint64_t m_generation{ 0 };
+    mutable std::mutex m_mutex;
+};
+
+using PreviewDebouncer = BasicPreviewDebouncer<>;
@@ -648,6 +648,50 @@
         public function push(type:int, text:String, ...args):void {
                 logger.log("push() вызван - тип: " + type + ", текст: '" + text + "'", "Main");
             
+            var item:Object = createItem(type, text, args);
+            
+            if (menuManager) {
+                menuManager.addItem(item);
+                logger.log("Элемент добавлен, всего элементов: " + menuManager.getItemCount(), "Main");
+            } else {
+                logger.error("MenuManager не инициализирован", "Main");
+            }
+        }
+
+        /**
+         * @brief Добавляет массив элементов [[type, text, state], ...] одним вызовом
+         * Основной способ заполнения меню из C++ (DirectApply::pushArray): меню перестраивается
+         * один раз на весь массив, а не на каждый элемент. Если метода нет в старом SWF, C++ вызывает push() поэлементно
+         */
+        public function pushArray(items:Array):void {
+            logger.log("pushArray() вызван - элементов: " + (items ? items.length : 0), "Main");
+            
+            if (!menuManager) {
+                logger.error("MenuManager не инициализирован", "Main");
+                return;
+            }
+            if (!items || items.length == 0) {
+                return;
+            }
+            
+            var batch:Array = [];
+            for (var i:int = 0; i < items.length; i++) {
+                var element:Array = items[i] as Array;
+                if (!element || element.length < 2) {
+                    logger.error("pushArray: некорректный элемент " + i, "Main");
+                    continue;
+                }
+                batch.push(createItem(int(element[0]), String(element[1]), element.slice(2)));
+            }
+            
+            menuManager.addItems(batch);
+            logger.log("Элементы добавлены, всего элементов: " + menuManager.getItemCount(), "Main");
+        }
+
+        /**
+         * @brief Создаёт объект элемента меню по типу, тексту и дополнительным параметрам
+         */
+        private function createItem(type:int, text:String, args:Array):Object {
             var item:Object = {
                 type: type,
                 labelText: text,
@@ -682,16 +726,10 @@
                     logger.log("  - Общее количество опций: " + optionsArray.length, "Main");
                     break;
                 default:
-                    logger.log("Стандартный элемент типа: " + type, "Main");
                     break;
             }
             
-            if (menuManager) {
-                menuManager.addItem(item);
-                logger.log("Элемент добавлен, всего элементов: " + menuManager.getItemCount(), "Main");
-            } else {
-                logger.error("MenuManager не инициализирован", "Main");
-            }
+            return item;
         }
 
         /**
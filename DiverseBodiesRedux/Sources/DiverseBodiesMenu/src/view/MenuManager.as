@@ -555,6 +555,32 @@ package view {
             }
         }
 
+        /**
+         * @brief Добавляет несколько элементов в конец меню за одну перестройку
+         * @param items Массив элементов
+         */
+        public function addItems(items:Array):void {
+            log("MenuManager: Добавление " + (items ? items.length : 0) + " элементов в меню");
+            
+            if (!_scrollableMenu) {
+                log("MenuManager: ERROR - ScrollableMenu не инициализирован");
+                return;
+            }
+            if (!items || items.length == 0) {
+                return;
+            }
+            
+            try {
+                // Активный элемент сохраняется, как при addItem(); -1 выберет первый интерактивный
+                var activeIndex:int = _scrollableMenu.activeIndex;
+                _scrollableMenu.setItems(_scrollableMenu.getCurrentItems().concat(items), activeIndex);
+                log("MenuManager: Элементы добавлены успешно через setItems()");
+            } catch (error:Error) {
+                log("MenuManager: ERROR - Ошибка добавления элементов: " + error.message);
+                log("MenuManager: Stack trace: " + error.getStackTrace());
+            }
+        }
+
         /**
          * @brief Очищает все элементы меню
          */
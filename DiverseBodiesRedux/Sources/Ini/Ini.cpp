@@ -1,4 +1,5 @@
 #include "Ini.h"
+#include "Utils/Hash.hpp"
 
 namespace ini
 {
@@ -18,69 +19,157 @@ namespace ini
 	map::map(const char* path) :
 		map(std::filesystem::path(path)) {}
 
-	map::map(const map& m) :
-		m_path(m.m_path), m_inimap(m.m_inimap) {}
+	map::map(const map& m)
+	{
+		std::shared_lock lock(m.m_mutex);
+		m_path = m.m_path;
+		m_inimap = m.m_inimap;
+		m_hash = m.m_hash;
+	}
 
 	map::map(map&& m)
-		:
-		m_path(std::move(m.m_path)),
-		m_inimap(std::move(m.m_inimap))
 	{
+		std::unique_lock lock(m.m_mutex);
+		m_path = std::move(m.m_path);
+		m_inimap = std::move(m.m_inimap);
+		m_hash = m.m_hash;
 	}
 
 	map& map::operator=(const map& m)
 	{
-		m_path = m.m_path;
-		m_inimap = m.m_inimap;
+		if (this != &m) {
+			std::unique_lock lock(m_mutex, std::defer_lock);
+			std::shared_lock otherLock(m.m_mutex, std::defer_lock);
+			std::lock(lock, otherLock);
+			m_path = m.m_path;
+			m_inimap = m.m_inimap;
+			m_hash = m.m_hash;
+		}
+		return *this;
 	}
 
 	map& map::operator=(map&& m) noexcept
 	{
 		if (this != &m) { 
+			std::scoped_lock lock(m_mutex, m.m_mutex);
 			m_path = std::move(m.m_path);
 			m_inimap = std::move(m.m_inimap);               
+			m_hash = m.m_hash;
 		}
 		return *this;  // Возвращаем ссылку на текущий объект
 	}
 
 	bool map::empty() const noexcept{
+		std::shared_lock lock(m_mutex);
 		return m_inimap.empty();
 	}
 
 	bool map::exists() const noexcept{
-		return m_path.empty() || !std::filesystem::exists(m_path);
+		const auto current = path();
+		return current.empty() || !std::filesystem::exists(current);
 	}
 
 	bool map::update() noexcept {
-		if (m_path.empty() || !std::filesystem::exists(m_path)) {
-			std::cerr << "INI file does not exist: " << m_path << std::endl;
+		const auto current = path();
+		if (current.empty() || !std::filesystem::exists(current)) {
+			std::cerr << "INI file does not exist: " << current << std::endl;
 			return false;  // Возвращаем false, если файл не существует
 		}
-		return readFile(m_path);  // Обновляем данные из файла
+		return readFile(current);  // Обновляем данные из файла
 	}
 	
 	bool map::readFile(const std::filesystem::path& path)
 	{
 		if (!std::filesystem::exists(path)) {
 			std::cerr << "INI file does not exist: " << path << std::endl;
+			std::unique_lock lock(m_mutex);
 			m_path = "";
 			//throw std::runtime_error("INI file does not exist: " + std::filesystem::absolute(path).string());
 			return false;  // Возвращаем false, если файл не существует
 		}
 
-		auto file = utils::file::open_file(path, utils::FileMode::Read);
-		if (!file.get()) {
+		auto content = readContent(path);
+		if (!content) {
+			std::unique_lock lock(m_mutex);
 			m_path = "";
 			return false;
 		}
 
-		m_inimap.clear();  // Очищаем текущую карту перед загрузкой нового файла
+		{
+			std::unique_lock lock(m_mutex);
+			m_path = path.string();  // Сохраняем путь к файлу
+		}
+		parse(*content);
+		return true;
+	}
+
+	bool map::reloadIfChanged()
+	{
+		std::string current;
+		uint64_t hash = 0;
+		{
+			std::shared_lock lock(m_mutex);
+			current = m_path;
+			hash = m_hash;
+		}
+		if (current.empty() || !std::filesystem::exists(current)) {
+			return false;
+		}
+
+		auto content = readContent(current);
+		if (!content || utils::fnv1a(*content) == hash) {
+			return false;  // Файл не открылся или не изменился - оставляем текущую карту
+		}
+
+		parse(*content);
+		return true;
+	}
+
+	uint64_t map::contentHash() const noexcept
+	{
+		std::shared_lock lock(m_mutex);
+		return m_hash;
+	}
+
+	std::optional<std::string> map::value(const std::string& key, const std::string& section) const
+	{
+		std::shared_lock lock(m_mutex);
+		auto sectionIt = m_inimap.find(section);
+		if (sectionIt == m_inimap.end()) {
+			return std::nullopt;
+		}
+		auto it = sectionIt->second.find(key);
+		if (it == sectionIt->second.end()) {
+			return std::nullopt;
+		}
+		return it->second;
+	}
+
+	std::string map::path() const
+	{
+		std::shared_lock lock(m_mutex);
+		return m_path;
+	}
+
+	std::optional<std::string> map::readContent(const std::filesystem::path& path)
+	{
+		auto file = utils::file::open_file(path, utils::FileMode::Read);
+		if (!file.get()) {
+			return std::nullopt;
+		}
+		std::string content{ std::istreambuf_iterator<char>(*file), std::istreambuf_iterator<char>() };
+		file->close();
+		return content;
+	}
 
-		m_path = path.string();  // Сохраняем путь к файлу
+	void map::parse(const std::string& content)
+	{
+		IniMap inimap;  // Разбираем в новую карту без блокировки, читатели видят старую до подмены
 
+		std::istringstream stream(content);
 		std::string line;
 		std::string current_section;
-		while (std::getline(*file, line)) {
+		while (std::getline(stream, line)) {
 			// Удаляем ведущие пробелы
 			auto first_non_space = line.find_first_not_of(" \t\r\n");
 			if (first_non_space == std::string::npos)
@@ -118,7 +207,7 @@ namespace ini
 				}
 				if (end_quote != std::string::npos) {
 					std::string quoted = value.substr(1, end_quote - 1);
-					m_inimap[current_section][key] = quoted;
+					inimap[current_section][key] = quoted;
 				} else {
 					// Некорректная строка, пропускаем
 					continue;
@@ -130,11 +219,13 @@ namespace ini
 					value = value.substr(0, comment_pos);
 					value = utils::string::trim(value, " \t\r\n");
 				}
-				m_inimap[current_section][key] = value;
+				inimap[current_section][key] = value;
 			}
 		}
-		file->close();
-		return true;
+
+		std::unique_lock lock(m_mutex);
+		m_inimap = std::move(inimap);
+		m_hash = utils::fnv1a(content);
 	}
 
 	bool map::readFile(const std::string& path) {
@@ -142,12 +233,13 @@ namespace ini
 	}
 
 	bool map::reload() {
-		return readFile(m_path);
+		return readFile(path());
 	}
 
 	// Реализация метода contains
 	bool map::contains(std::string key, std::string section) const
 	{
+		std::shared_lock lock(m_mutex);
 		if (!m_inimap.contains(section))
 			return false;
 		return (m_inimap.at(section).contains(key));
@@ -155,6 +247,7 @@ namespace ini
 
 	std::ostream& operator<<(std::ostream& os, const map& m)
 	{
+		std::shared_lock lock(m.m_mutex);
 		os << "ini : " << m.m_path << "\n";
 
 		for (auto it = m.m_inimap.begin(), end = m.m_inimap.end(); it != end; ++it) {
@@ -4,7 +4,11 @@
 #include <iostream>
 #include <string>
 #include <optional>
+#include <sstream>
+#include <cstdint>
 #include <array>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include "Utils/utility.h"
@@ -13,6 +17,8 @@ namespace ini
 {	
 	/**
 	 * @brief Класс для работы с ini-файлами в виде map<секция, map<ключ, значение>>.
+	 * Потокобезопасен: чтение под разделяемой блокировкой, set() и перечитывание файла - под исключительной.
+	 * Новая карта разбирается без блокировки и подменяется целиком.
 	 */
 	class map
 	{
@@ -68,6 +74,17 @@ namespace ini
 		 */
 		bool reload();
 
+		/**
+		 * @brief Перечитывает ini-файл, только если его содержимое изменилось с последнего чтения.
+		 * @return true если содержимое изменилось и карта обновлена, иначе false.
+		 */
+		bool reloadIfChanged();
+
+		/**
+		 * @brief Хэш содержимого последнего прочитанного файла (FNV-1a, 64 бит).
+		 */
+		uint64_t contentHash() const noexcept;
+
 		/**
 		 * @brief Проверяет, существует ли ini-файл.
 		 * @return true если файл существует, иначе false.
@@ -159,6 +176,32 @@ namespace ini
 	private:
 		std::string m_path = "";
 		IniMap m_inimap;
+		uint64_t m_hash = 0;
+		mutable std::shared_mutex m_mutex;
+
+		/**
+		 * @brief Копия значения по ключу и секции под разделяемой блокировкой.
+		 * @return Строка значения или std::nullopt, если ключа нет.
+		 */
+		std::optional<std::string> value(const std::string& key, const std::string& section) const;
+
+		/**
+		 * @brief Копия пути к файлу под разделяемой блокировкой.
+		 */
+		std::string path() const;
+
+		/**
+		 * @brief Читает содержимое файла целиком.
+		 * @param path Путь к ini-файлу.
+		 * @return Содержимое файла или std::nullopt, если файл не открылся.
+		 */
+		static std::optional<std::string> readContent(const std::filesystem::path& path);
+
+		/**
+		 * @brief Разбирает содержимое ini-файла в новую карту и подменяет ею текущую.
+		 * @param content Содержимое ini-файла.
+		 */
+		void parse(const std::string& content);
 
 		/**
 		 * @brief Разделяет строку "section/key" на массив из двух строк: {section, key}.
@@ -173,14 +216,13 @@ namespace ini
 	template <class T>
 	inline std::optional<T> map::get(const std::string& key, const std::string& section) const noexcept
 	{
-		if (contains(key, section)) {
-			std::string value_str = std::string(m_inimap.at(section).at(key));  // Получаем значение как строку
-			std::istringstream iss(value_str);                          // Создаем поток для преобразования
-			T value;
-			if (!(iss >> value)) {    // Пробуем считать значение
+		if (auto value_str = value(key, section)) {                    // Получаем значение как строку
+			std::istringstream iss(*value_str);                         // Создаем поток для преобразования
+			T result;
+			if (!(iss >> result)) {    // Пробуем считать значение
 				return std::nullopt;  // Если не удалось преобразовать, возвращаем std::nullopt
 			}
-			return value;  // Возвращаем преобразованное значение
+			return result;  // Возвращаем преобразованное значение
 		}
 		return std::nullopt;  // Если не удалось преобразовать, возвращаем std::nullopt
 	}
@@ -188,20 +230,18 @@ namespace ini
 	template <>
 	inline std::optional<std::string> map::get<std::string>(const std::string& key, const std::string& section) const noexcept
 	{
-		if (contains(key, section)) {
-			return std::string(m_inimap.at(section).at(key));  // Прямое возвращение значения для std::string
-		}
-		return std::nullopt;  // Если не удалось преобразовать, возвращаем std::nullopt
+		return value(key, section);  // Прямое возвращение значения для std::string
 	}
 
 	template <>
 	inline std::optional<bool> map::get<bool>(const std::string& key, const std::string& section) const noexcept
 	{
-		if (!contains(key, section)) {
+		const auto found = value(key, section);
+		if (!found) {
 			return std::nullopt;  // Если не удалось преобразовать, возвращаем std::nullopt
 		}
 
-		const std::string& value_str = m_inimap.at(section).at(key);
+		const std::string& value_str = *found;
 
 		if (value_str == "true") {
 			return true;
@@ -249,14 +289,13 @@ namespace ini
 	template <class T>
 	inline T map::getAt(const std::string& key, const std::string& section) const
 	{
-		if (contains(key, section)) {
-			std::string value_str = std::string(m_inimap[section][key]);  // Получаем значение как строку
-			std::istringstream iss(value_str);                          // Создаем поток для преобразования
-			T value;
-			if (!(iss >> value)) {  // Пробуем считать значение
+		if (auto value_str = value(key, section)) {                    // Получаем значение как строку
+			std::istringstream iss(*value_str);                         // Создаем поток для преобразования
+			T result;
+			if (!(iss >> result)) {  // Пробуем считать значение
 				throw std::runtime_error("Failed to convert value for key: " + std::string(key) + " in section: " + std::string(section));
 			}
-			return value;  // Возвращаем преобразованное значение
+			return result;  // Возвращаем преобразованное значение
 		}
 		throw std::runtime_error("Key not found: " + std::string(key) + " in section: " + std::string(section));
 	}
@@ -264,8 +303,8 @@ namespace ini
 	template <>
 	inline std::string map::getAt<std::string>(const std::string& key, const std::string& section) const
 	{
-		if (contains(key, section)) {
-			return std::string(m_inimap.at(section).at(key));  // Прямое возвращение значения для std::string
+		if (auto found = value(key, section)) {
+			return std::move(*found);  // Прямое возвращение значения для std::string
 		}
 		throw std::runtime_error("Key not found: " + std::string(key) + " in section: " + std::string(section));
 	}
@@ -273,11 +312,12 @@ namespace ini
 	template <>
 	inline bool map::getAt<bool>(const std::string& key, const std::string& section) const
 	{
-		if (!contains(key, section)) {
+		const auto found = value(key, section);
+		if (!found) {
 			throw std::runtime_error("Key not found: " + key + " in section: " + section);
 		}
 
-		const std::string& value_str = m_inimap.at(section).at(key);
+		const std::string& value_str = *found;
 
 		if (value_str == "true") {
 			return true;
@@ -306,6 +346,8 @@ namespace ini
 		oss << val;
 		std::string value_str = oss.str();
 
+		// Исключительная блокировка и на запись файла: параллельные set() не должны перетирать изменения друг друга
+		std::unique_lock lock(m_mutex);
 		m_inimap[section][key] = value_str;  // Обновляем значение в памяти
 
 		// Читаем весь файл в память
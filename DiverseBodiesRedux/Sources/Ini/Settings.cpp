@@ -0,0 +1,41 @@
+#include "Settings.h"
+
+namespace ini
+{
+	Settings Settings::fromMap(const map& m)
+	{
+		Settings settings;
+#define DBR_INI_SETTINGS_PARSE(type, section, key, default_value) \
+		settings.key = m.at<type>(section "/" #key, settings.key);
+		DBR_INI_SETTINGS(DBR_INI_SETTINGS_PARSE)
+#undef DBR_INI_SETTINGS_PARSE
+		return settings;
+	}
+
+	SettingsSnapshot::SettingsSnapshot()
+	{
+		// Снимок по умолчанию, чтобы get() был валиден до первого чтения ini
+		m_snapshots.push_back(std::make_unique<const Settings>());
+		m_current.store(m_snapshots.back().get(), std::memory_order_release);
+	}
+
+	void SettingsSnapshot::publish(const map& m)
+	{
+		auto settings = std::make_unique<const Settings>(Settings::fromMap(m));
+		std::lock_guard lock(m_mutex);
+		m_current.store(settings.get(), std::memory_order_release);
+		m_snapshots.push_back(std::move(settings));
+	}
+
+	bool SettingsSnapshot::refresh(map& m)
+	{
+		std::lock_guard lock(m_mutex);
+		if (!m.reloadIfChanged()) {
+			return false;
+		}
+		auto settings = std::make_unique<const Settings>(Settings::fromMap(m));
+		m_current.store(settings.get(), std::memory_order_release);
+		m_snapshots.push_back(std::move(settings));
+		return true;
+	}
+}
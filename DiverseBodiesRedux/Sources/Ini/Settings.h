@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Ini.h"
+
+/**
+ * @brief Список известных ключей DiverseBodiesRedux.ini: тип, секция, ключ, значение по умолчанию.
+ * Из него генерируются поля ini::Settings и их разбор.
+ */
+#define DBR_INI_SETTINGS(X)                                             \
+	X(bool, "GENERAL", bAddChargenFlag, false)                          \
+	X(bool, "GENERAL", bResetMapOnNextLoad, false)                      \
+	X(int, "DEBUG", iLogLevel, 3)                                       \
+	X(int, "DEBUG", iLogFlush, 3)                                       \
+	X(bool, "DEBUG", bScaleformLog, false)                              \
+	X(std::string, "DEBUG", sSerializationLog, "")                      \
+	X(std::string, "DEBUG", sPrintAllPresets, "")                       \
+	X(bool, "PATCH", bLooksMenuRemoveOverlayHook, true)                 \
+	X(bool, "PATCH", bBSTransformSet, true)                             \
+	X(bool, "PATCH", bBSClothExtraDataSetSettle, true)                  \
+	X(bool, "PATCH", bSetTransformSet, true)                            \
+	X(bool, "PATCH", bCBP2507, true)                                    \
+	X(bool, "PATCH", bChangeHeadPart, true)                             \
+	X(bool, "PATCH", bDoUpdate3DModelHook, false)                       \
+	X(std::string, "PATH", sExclusions, "")                             \
+	X(int, "MENU", iPresetsPageSize, 50)                                \
+	X(int, "MENU", iPreviewSettleMs, 300)                               \
+	X(std::string, "COLORS", sTheme, "Glass")                           \
+	X(std::string, "COLORS", sScrollPane, "")                           \
+	X(std::string, "COLORS", sLabel, "")                                \
+	X(std::string, "COLORS", sButton, "")                               \
+	X(std::string, "COLORS", sCheckbox, "")                             \
+	X(std::string, "COLORS", sSwitcher, "")
+
+namespace ini
+{
+	/**
+	 * @brief Типизированный снимок настроек. Разбирается из ini::map один раз и после публикации не меняется.
+	 */
+	struct Settings
+	{
+#define DBR_INI_SETTINGS_FIELD(type, section, key, default_value) type key = default_value;
+		DBR_INI_SETTINGS(DBR_INI_SETTINGS_FIELD)
+#undef DBR_INI_SETTINGS_FIELD
+
+		/**
+		 * @brief Разобрать все известные ключи из карты. Отсутствующие и некорректные ключи получают значения по умолчанию.
+		 * @param m Карта ini-файла.
+		 * @return Заполненный снимок.
+		 */
+		static Settings fromMap(const map& m);
+	};
+
+	/**
+	 * @brief Атомарно публикуемый снимок настроек.
+	 *
+	 * Чтение - одна загрузка указателя без блокировок и разбора строк. Новый снимок публикуется
+	 * только при изменении содержимого ini-файла. Старые снимки не удаляются до завершения работы,
+	 * поэтому полученная ссылка остаётся валидной, даже если снимок успели заменить.
+	 */
+	class SettingsSnapshot
+	{
+	public:
+		SettingsSnapshot();
+		SettingsSnapshot(const SettingsSnapshot&) = delete;
+		SettingsSnapshot& operator=(const SettingsSnapshot&) = delete;
+
+		/**
+		 * @brief Текущий снимок настроек.
+		 */
+		const Settings& get() const noexcept
+		{
+			return *m_current.load(std::memory_order_acquire);
+		}
+
+		/**
+		 * @brief Разобрать карту и опубликовать новый снимок безусловно.
+		 * @param m Карта ini-файла.
+		 */
+		void publish(const map& m);
+
+		/**
+		 * @brief Перечитать ini-файл и опубликовать новый снимок, если содержимое файла изменилось.
+		 * @param m Карта ini-файла.
+		 * @return true если опубликован новый снимок.
+		 */
+		bool refresh(map& m);
+
+	private:
+		std::atomic<const Settings*> m_current;
+		std::vector<std::unique_ptr<const Settings>> m_snapshots;
+		std::mutex m_mutex;
+	};
+}
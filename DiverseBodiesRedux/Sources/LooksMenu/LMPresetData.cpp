@@ -0,0 +1,287 @@
+#include "LMPresetData.h"
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+	bool iequals(std::string_view a, std::string_view b) noexcept {
+		if (a.size() != b.size()) return false;
+		for (size_t i = 0; i < a.size(); ++i) {
+			if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+				return false;
+		}
+		return true;
+	}
+
+	std::optional<float> toFloat(const boost::json::value& value) noexcept {
+		if (value.is_double()) return static_cast<float>(value.as_double());
+		if (value.is_int64()) return static_cast<float>(value.as_int64());
+		return std::nullopt;
+	}
+
+	// Идентификаторы в LooksMenu записаны в шестнадцатеричном виде
+	std::optional<uint32_t> parseHexID(std::string_view text, std::vector<std::string>& warnings, std::string_view what) {
+		try {
+			return static_cast<uint32_t>(std::stoul(std::string(text), nullptr, 16));
+		}
+		catch (const std::exception& e) {
+			warnings.push_back(std::string(what) + ": failed to parse ID '" + std::string(text) + "': " + e.what());
+			return std::nullopt;
+		}
+	}
+
+	template <size_t N>
+	void readFloats(const boost::json::array& arr, std::array<float, N>& out, bool skipInvalid, std::vector<std::string>& warnings, std::string_view what) {
+		size_t count = 0;
+		for (const auto& item : arr) {
+			auto value = toFloat(item);
+			if (!value) {
+				warnings.push_back(std::string(what) + " value is not a number");
+				if (skipInvalid) {
+					++count;
+					continue;
+				}
+			}
+			if (count < N) {
+				out[count] = value.value_or(0.0f);
+			}
+			else {
+				warnings.push_back(std::string(what) + " array has more than " + std::to_string(N) + " elements");
+			}
+			++count;
+		}
+	}
+
+	void parseMorphs(const boost::json::object& morphs, LMPresetData& data) {
+		bool presetsSeen = false, regionsSeen = false, valuesSeen = false, intensitySeen = false;
+		for (const auto& [key, value] : morphs) {
+			if (!presetsSeen && iequals(key, "Presets")) {
+				presetsSeen = true;
+				if (!value.is_object()) continue;
+				auto& presets = data.morphPresets.emplace();
+				for (const auto& [morphKey, morphValue] : value.as_object()) {
+					auto id = parseHexID(morphKey, data.warnings, "Morphs/Presets");
+					if (!id) continue;
+					if (auto number = toFloat(morphValue))
+						presets.emplace_back(*id, *number);
+					else
+						data.warnings.push_back("Morphs/Presets: value for morph ID '" + std::string(morphKey) + "' is not a number");
+				}
+			}
+			else if (!regionsSeen && iequals(key, "Regions")) {
+				regionsSeen = true;
+				if (!value.is_object()) continue;
+				auto& regions = data.morphRegions.emplace();
+				for (const auto& [regionKey, regionValue] : value.as_object()) {
+					auto id = parseHexID(regionKey, data.warnings, "Morphs/Regions");
+					if (!id) continue;
+					if (!regionValue.is_array()) {
+						data.warnings.push_back("Morphs/Regions: value for region ID '" + std::string(regionKey) + "' is not an array");
+						continue;
+					}
+					const auto& arr = regionValue.as_array();
+					if (arr.size() < 8) {
+						data.warnings.push_back("Morphs/Regions: array for region ID '" + std::string(regionKey) + "' too small (size: " + std::to_string(arr.size()) + ")");
+						continue;
+					}
+					LMPresetData::RegionTransform transform{};
+					for (size_t i = 0; i < transform.size(); ++i) {
+						transform[i] = i < arr.size() ? toFloat(arr[i]).value_or(0.0f) : 1.0f;
+					}
+					regions.emplace_back(*id, transform);
+				}
+			}
+			else if (!valuesSeen && iequals(key, "Values")) {
+				valuesSeen = true;
+				if (!value.is_array()) continue;
+				auto& values = data.morphValues.emplace();
+				for (const auto& item : value.as_array()) {
+					if (auto number = toFloat(item))
+						values.push_back(*number);
+					else
+						data.warnings.push_back("Morphs/Values: value is not a number");
+				}
+			}
+			else if (!intensitySeen && iequals(key, "Intensity")) {
+				intensitySeen = true;
+				data.morphIntensity = toFloat(value);
+				if (!data.morphIntensity)
+					data.warnings.push_back("Morphs/Intensity: value is not a number");
+			}
+		}
+	}
+
+	void parseOverlays(const boost::json::array& overlays, LMPresetData& data) {
+		auto& result = data.overlays.emplace();
+		for (const auto& overlayJson : overlays) {
+			if (!overlayJson.is_object()) {
+				data.warnings.push_back("Overlay item is not an object");
+				continue;
+			}
+			const auto& overlayObj = overlayJson.as_object();
+			LMPresetData::OverlayData overlay{};
+			bool templateSeen = false, prioritySeen = false, tintSeen = false, offsetSeen = false, scaleSeen = false;
+			bool templateValid = false;
+
+			for (const auto& [key, value] : overlayObj) {
+				if (!templateSeen && iequals(key, "template")) {
+					templateSeen = true;
+					if (value.is_string()) {
+						templateValid = true;
+						overlay.templateName = value.as_string().c_str();
+					}
+				}
+				else if (!prioritySeen && iequals(key, "priority")) {
+					prioritySeen = true;
+					if (value.is_int64())
+						overlay.priority = static_cast<int>(value.as_int64());
+					else if (value.is_double())
+						overlay.priority = static_cast<int>(value.as_double());
+				}
+				else if (!tintSeen && iequals(key, "tint")) {
+					tintSeen = true;
+					if (value.is_array())
+						readFloats(value.as_array(), overlay.tint, true, data.warnings, "Overlay tint");
+				}
+				else if (!offsetSeen && iequals(key, "offsetUV")) {
+					offsetSeen = true;
+					if (value.is_array())
+						readFloats(value.as_array(), overlay.offsetUV, false, data.warnings, "Overlay offsetUV");
+				}
+				else if (!scaleSeen && iequals(key, "scaleUV")) {
+					scaleSeen = true;
+					if (value.is_array())
+						readFloats(value.as_array(), overlay.scaleUV, false, data.warnings, "Overlay scaleUV");
+				}
+			}
+
+			if (!templateValid) {
+				data.warnings.push_back("Overlay template value missing or not a string");
+				continue;
+			}
+			if (overlay.templateName.empty()) {
+				continue; // Пустые шаблоны пропускаются молча
+			}
+			result.push_back(std::move(overlay));
+		}
+	}
+
+	void parseTints(const boost::json::object& tints, LMPresetData& data) {
+		auto& result = data.tints.emplace();
+		for (const auto& [key, value] : tints) {
+			if (!value.is_object()) {
+				data.warnings.push_back("Tint value for key '" + std::string(key) + "' is not an object");
+				continue;
+			}
+			auto id = parseHexID(key, data.warnings, "Tints");
+			if (!id) continue;
+
+			LMPresetData::TintData tint{ *id, std::nullopt, value.as_object() };
+			for (const auto& [tintKey, tintValue] : tint.object) {
+				if (iequals(tintKey, "Type")) {
+					if (auto number = toFloat(tintValue))
+						tint.type = static_cast<int>(*number);
+					else
+						data.warnings.push_back("Tint Type for key '" + std::string(key) + "' is not a number, using default (2)");
+					break;
+				}
+			}
+			result.push_back(std::move(tint));
+		}
+	}
+}
+
+LMPresetData LMPresetData::parse(const boost::json::object& object) {
+	LMPresetData data{};
+
+	bool genderSeen = false, hairColorSeen = false, faceHairColorSeen = false, headPartsSeen = false;
+	bool bodyMorphsSeen = false, morphsSeen = false, overlaysSeen = false, tintsSeen = false;
+	bool tintOrderSeen = false, weightSeen = false, conditionsSeen = false;
+
+	for (const auto& [key, value] : object) {
+		if (!genderSeen && iequals(key, "Gender")) {
+			genderSeen = true;
+			if (value.is_int64())
+				data.gender = value.as_int64();
+		}
+		else if (!hairColorSeen && iequals(key, "HairColor")) {
+			hairColorSeen = true;
+			if (value.is_string())
+				data.hairColor = value.as_string().c_str();
+		}
+		else if (!faceHairColorSeen && iequals(key, "FaceHairColor")) {
+			faceHairColorSeen = true;
+			if (value.is_string())
+				data.faceHairColor = value.as_string().c_str();
+		}
+		else if (!headPartsSeen && iequals(key, "HeadParts")) {
+			headPartsSeen = true;
+			if (!value.is_array()) continue;
+			auto& headParts = data.headParts.emplace();
+			for (const auto& item : value.as_array()) {
+				if (item.is_string())
+					headParts.emplace_back(item.as_string().c_str());
+				else
+					data.warnings.push_back("HeadPart item is not a string");
+			}
+		}
+		else if (!bodyMorphsSeen && iequals(key, "BodyMorphs")) {
+			bodyMorphsSeen = true;
+			data.empty = false;
+			if (!value.is_object()) continue;
+			auto& bodyMorphs = data.bodyMorphs.emplace();
+			for (const auto& [morph, morphValue] : value.as_object()) {
+				if (auto number = toFloat(morphValue))
+					bodyMorphs[std::string(morph)] = *number;
+				else
+					data.warnings.push_back("BodyMorphs: value for key '" + std::string(morph) + "' is not a number");
+			}
+		}
+		else if (!morphsSeen && iequals(key, "Morphs")) {
+			morphsSeen = true;
+			data.empty = false;
+			if (!value.is_object()) continue;
+			data.hasMorphs = true;
+			parseMorphs(value.as_object(), data);
+		}
+		else if (!overlaysSeen && iequals(key, "Overlays")) {
+			overlaysSeen = true;
+			data.empty = false;
+			if (value.is_array())
+				parseOverlays(value.as_array(), data);
+		}
+		else if (!tintsSeen && iequals(key, "Tints")) {
+			tintsSeen = true;
+			data.empty = false;
+			if (value.is_object())
+				parseTints(value.as_object(), data);
+		}
+		else if (!tintOrderSeen && iequals(key, "TintOrder")) {
+			tintOrderSeen = true;
+			if (!value.is_array()) continue;
+			auto& tintOrder = data.tintOrder.emplace();
+			for (const auto& item : value.as_array()) {
+				if (!item.is_string()) {
+					data.warnings.push_back("TintOrder item is not a string");
+					continue;
+				}
+				const auto& text = item.as_string();
+				if (auto id = parseHexID(std::string_view(text.data(), text.size()), data.warnings, "TintOrder"))
+					tintOrder.push_back(*id);
+			}
+		}
+		else if (!weightSeen && iequals(key, "Weight")) {
+			weightSeen = true;
+			data.empty = false;
+			if (!value.is_array()) continue;
+			auto& weight = data.weight.emplace(std::array<float, 3>{ 0.0f, 0.0f, 0.0f });
+			readFloats(value.as_array(), weight, false, data.warnings, "Weight");
+		}
+		else if (!conditionsSeen && iequals(key, "Conditions")) {
+			conditionsSeen = true;
+			if (value.is_object())
+				data.conditions = value.as_object();
+		}
+	}
+
+	return data;
+}
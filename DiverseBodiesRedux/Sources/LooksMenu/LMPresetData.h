@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/json.hpp>
+
+/**
+ * @brief Разобранный LooksMenu пресет в виде простых данных.
+ *
+ * Заполняется за один проход по JSON-документу в parse(), после чего сам документ не нужен.
+ * Ссылки на формы хранятся строками "plugin.esp|FormID" и
+ * разрешаются в ParseLMPreset. Отсутствующее или неверного типа поле хранится как std::nullopt.
+ * Ключи верхнего уровня ищутся без учёта регистра, при повторе берётся первый, как в find_ci.
+ */
+struct LMPresetData {
+	/**
+	 * @brief Наложение из массива "Overlays".
+	 */
+	struct OverlayData {
+		std::string templateName{};
+		int priority{ 0 };
+		std::array<float, 4> tint{ 0.0f, 0.0f, 0.0f, 1.0f };
+		std::array<float, 2> offsetUV{ 0.0f, 0.0f };
+		std::array<float, 2> scaleUV{ 1.0f, 1.0f };
+	};
+
+	/**
+	 * @brief Тинт из объекта "Tints". Объект тинта остаётся в JSON: его разбирают конструкторы Tint.
+	 */
+	struct TintData {
+		uint32_t id{};
+		std::optional<int> type{};			///< Поле "Type", std::nullopt если его нет или оно не число
+		boost::json::object object{};
+	};
+
+	/// Трансформация региона лица: позиция (3), поворот (3), масштаб; недостающие элементы равны 1.0
+	using RegionTransform = std::array<float, 9>;
+
+	std::optional<int64_t> gender{};
+	std::optional<std::string> hairColor{};
+	std::optional<std::string> faceHairColor{};
+	std::optional<std::vector<std::string>> headParts{};
+	std::optional<std::unordered_map<std::string, float>> bodyMorphs{};
+
+	bool hasMorphs{ false };				///< "Morphs" есть и является объектом
+	std::optional<std::vector<std::pair<uint32_t, float>>> morphPresets{};
+	std::optional<std::vector<std::pair<uint32_t, RegionTransform>>> morphRegions{};
+	std::optional<std::vector<float>> morphValues{};
+	std::optional<float> morphIntensity{};
+
+	std::optional<std::vector<OverlayData>> overlays{};
+	std::optional<std::vector<TintData>> tints{};
+	std::optional<std::vector<uint32_t>> tintOrder{};
+	std::optional<std::array<float, 3>> weight{};
+	std::optional<boost::json::object> conditions{};
+
+	/**
+	 * @brief В документе нет ни одного ключа с данными пресета (BodyMorphs, Morphs, Overlays, Tints, Weight).
+	 */
+	bool empty{ true };
+
+	/**
+	 * @brief Замечания о неверных элементах, найденные при разборе. Выводятся в лог владельцем.
+	 */
+	std::vector<std::string> warnings{};
+
+	/**
+	 * @brief Разобрать JSON-объект пресета.
+	 * @param object Корневой объект пресета.
+	 * @return Заполненная структура.
+	 */
+	static LMPresetData parse(const boost::json::object& object);
+};
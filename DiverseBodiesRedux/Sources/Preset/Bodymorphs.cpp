@@ -1,5 +1,5 @@
 #include "Bodymorphs.h"
-#include "PugiXML/pugixml.hpp"
+#include "Details/SliderPresetCache.h"
 #include "LooksMenu/LooksMenuInterfaces.h"
 #include "Ini/ini.h"
 #include "globals.h"
@@ -66,7 +66,18 @@ CoincidenceLevel BodymorphsPreset::check(const RE::Actor* actor, Filter filter)
 }
 
 // @brief Применяет пресет к актеру, устанавливая морфы тела. Перед применением удаляет ранее применённые морфы тела, чтобы избежать конфликтов.
-bool BodymorphsPreset::apply(RE::Actor* actor, bool reset3d) const
+bool BodymorphsPreset::apply(RE::Actor* actor, ApplyTransaction& transaction) const
+{
+	return applyImpl(actor, transaction, nullptr);
+}
+
+// @brief Меняет морфы предыдущего пресета на морфы этого: без снятия всех морфов и без повторной установки совпадающих значений.
+bool BodymorphsPreset::replace(RE::Actor* actor, const BodymorphsPreset& previous, ApplyTransaction& transaction) const
+{
+	return applyImpl(actor, transaction, &previous);
+}
+
+bool BodymorphsPreset::applyImpl(RE::Actor* actor, ApplyTransaction& transaction, const BodymorphsPreset* previous) const
 {
 	if (!actor) {
 		logger::info("BodyMorphs Apply no actor provided!");
@@ -101,22 +112,35 @@ bool BodymorphsPreset::apply(RE::Actor* actor, bool reset3d) const
 		return false;
 	}
 
-	remove(actor);
+	if (!previous) {
+		remove(actor);
+	}
 
 	if (!actor->GetFullyLoaded3D()) {
 		processingActors.erase(actor); // Удаляем актёра из списка обрабатываемых
 		return false;
 	}
 
-	for (const auto& [morphName, morphValue] : m_morphs) {
-		auto Interface = LooksMenuInterfaces<BodyMorphInterface>::GetInterface();
-		if (!Interface) {
-			logger::critical("BodyMorphInterface is nullptr!");
-			processingActors.erase(actor); // Удаляем актёра из списка обрабатываемых
-			return false;
-		}
-		Interface->SetMorph(actor, actor->GetSex() == RE::Actor::Sex::Female, morphName, globals::kwd_diversed, morphValue);
+	// Интерфейс и пол берём один раз на актёра, а не на каждый морф
+	auto Interface = LooksMenuInterfaces<BodyMorphInterface>::GetInterface();
+	if (!Interface) {
+		logger::critical("BodyMorphInterface is nullptr!");
+		processingActors.erase(actor); // Удаляем актёра из списка обрабатываемых
+		return false;
 	}
+	const bool isFemale = actor->GetSex() == RE::Actor::Sex::Female;
+	auto getMorph = [&](const RE::BSFixedString& name) {
+		return Interface->GetMorph(actor, isFemale, name, globals::kwd_diversed);
+	};
+	auto setMorph = [&](const RE::BSFixedString& name, float value) {
+		Interface->SetMorph(actor, isFemale, name, globals::kwd_diversed, value);
+	};
+
+	if (previous) {
+		// Имена из общего пула строк: одинаковые имена - один и тот же указатель
+		clearStaleMorphs(m_morphs, previous->m_morphs, [](const RE::BSFixedString& name) { return name.data(); }, setMorph);
+	}
+	setMorphs(m_morphs, previous != nullptr, getMorph, setMorph);
 	
 	{
 		static std::unordered_map<uint32_t, std::mutex> npc_mutexes;
@@ -132,13 +156,10 @@ bool BodymorphsPreset::apply(RE::Actor* actor, bool reset3d) const
 			return true;
 		}
 
-		// Вызывает T-позу пока отключу.
-		// Сброс 3D модели актера
+		// Сброс 3D модели актера выполнит транзакция, общий для всех пресетов
 		using R3D = RE::RESET_3D_FLAGS;
-		if (reset3d && actor->GetFullyLoaded3D()) {
-			if (!RE::UI::GetSingleton()->GetMenuOpen(DirectApply::MENU_NAME)) actor->EvaluatePackageAfter3DLoaded(true);
-			actor->Reset3D(true, R3D::kModel | R3D::kScale, true, R3D::kNone);
-		}
+		if (!RE::UI::GetSingleton()->GetMenuOpen(DirectApply::MENU_NAME)) transaction.requestPackageEvaluation();
+		transaction.requestReset(R3D::kModel | R3D::kScale, /*reloadAll=*/true);
 
 		npc_mutexes.erase(npc->formID); // Удаляем мьютекс для этого NPC, чтобы избежать утечек памяти
 	}
@@ -186,8 +207,8 @@ std::future<bool> BodymorphsPreset::isValidAsync() const noexcept {
 	bool hasMorphs = !m_morphs.empty();
 	bool hasConds = !m_conditions.empty();
 
-	// Возвращаем future, который выполнит проверку асинхронно
-	return std::async(std::launch::async, [isEmpty, hasMorphs, hasConds]() {
+	// Проверка тривиальна, отдельный поток для неё не нужен
+	return std::async(std::launch::deferred, [isEmpty, hasMorphs, hasConds]() {
 		return !isEmpty && hasMorphs && hasConds;
 	});
 }
@@ -252,7 +273,7 @@ bool BodymorphsPreset::loadFromFile(const std::string& presetFile)
 			m_conditions.setGender(sex); // Устанавливаем пол из пресета, т.к. пресет не может быть применён к актёру другого пола.
 		}
 
-		m_morphs = preset.bodyMorphs();
+		m_morphs = internMorphs<RE::BSFixedString>(preset.bodyMorphs());
 		m_morphWeight = preset.morphWeight();
 		
 	} else if (path.extension() == ".xml") {
@@ -265,28 +286,13 @@ bool BodymorphsPreset::loadFromFile(const std::string& presetFile)
 			return false;
 		}
 
-		pugi::xml_document doc;
-		pugi::xml_parse_result result = doc.load_file(path.string().c_str());
-
-		if (!result) {
+		auto sliders = SliderPresetCache::get().sliders(path);
+		if (!sliders) {
 			logger::info("...FAILED : {} wrong xml format", presetFile);
 			return false;
 		}
 
-		pugi::xml_node presetNode = doc.child("SliderPresets").child("Preset");
-		if (presetNode) {
-			for (pugi::xml_node sliderNode = presetNode.child("SetSlider"); sliderNode; sliderNode = sliderNode.next_sibling("SetSlider")) {
-				auto nameAttr = sliderNode.attribute("name");
-				auto valueAttr = sliderNode.attribute("value");
-				if (!nameAttr || !valueAttr) {
-					logger::info("...FAILED : missing name or value attribute in slider");
-					continue;
-				}
-				std::string key = nameAttr.value();
-				float value = valueAttr.as_float() / 100.0f;
-				m_morphs.emplace(std::move(key), value);
-			}
-		}
+		m_morphs = internMorphs<RE::BSFixedString>(*sliders);
 	}
 
 	if (m_morphs.empty() || m_conditions.empty()) {
@@ -321,7 +327,7 @@ std::string BodymorphsPreset::print() const
 	else {
 		oss << "\n";
 		for (const auto& [name, value] : m_morphs) {
-			oss << "    " << name << " = " << value << "\n";
+			oss << "    " << name.c_str() << " = " << value << "\n";
 		}
 	}
 	oss << "  Conditions: ";
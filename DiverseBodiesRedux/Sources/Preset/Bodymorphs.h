@@ -1,5 +1,6 @@
 #pragma once
 #include "Preset.h"
+#include "Details/MorphBatch.hpp"
 
 /**
  * @brief Пресет морфов тела для актёров.
@@ -59,9 +60,21 @@ public:
 
 	/// @copydoc Preset::check
 	CoincidenceLevel check(const RE::Actor* actor, Filter filter = AllFilters) const noexcept override;
+	using Preset::check;
 
 	/// @copydoc Preset::apply
-	bool apply(RE::Actor*, bool reset3d = true) const override;
+	bool apply(RE::Actor*, ApplyTransaction& transaction) const override;
+	using Preset::apply;
+
+	/**
+	 * @brief Заменить на актёре морфы предыдущего пресета этим без снятия всех морфов мода.
+	 * Морфы с тем же значением не переставляются, морфы previous, которых нет в этом пресете, обнуляются.
+	 * @param actor Актёр.
+	 * @param previous Пресет, морфы которого сейчас на актёре.
+	 * @param transaction Транзакция сброса 3D.
+	 * @return true если морфы выставлены.
+	 */
+	bool replace(RE::Actor* actor, const BodymorphsPreset& previous, ApplyTransaction& transaction) const;
 
 	/// @copydoc Preset::remove
 	bool remove(RE::Actor*) const override;
@@ -81,11 +94,17 @@ public:
 private:
 
 	/**
-	 * @brief Морфы тела (имя морфа -> значение).
+	 * @brief Морфы тела. Имена интернируются в BSFixedString при загрузке, применение только проходит по вектору.
 	 */
-	std::unordered_map<std::string, float> m_morphs;
+	MorphList<RE::BSFixedString> m_morphs;
 	RE::NiPoint3 m_morphWeight{};
 
+	/**
+	 * @brief Общая часть apply() и replace().
+	 * @param previous Пресет, морфы которого сейчас на актёре; nullptr - снять все морфы мода и выставить заново.
+	 */
+	bool applyImpl(RE::Actor* actor, ApplyTransaction& transaction, const BodymorphsPreset* previous) const;
+
 	/// @copydoc Preset::loadFromFile
 	bool loadFromFile(const std::string& presetFile) override;
 
@@ -0,0 +1,126 @@
+#pragma once
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Транзакция применения пресетов к одному актёру с одним общим сбросом 3D.
+ *
+ * Пресеты не вызывают Reset3D сами, а сообщают транзакции, что им нужно сбросить: флаги объединяются,
+ * полная перезагрузка (reloadAll) запрашивается, если её попросил хоть один пресет. commit() выполняет
+ * подготовительные действия в порядке добавления, переоценку пакета ИИ, если её просили, и ровно один
+ * Reset3D. Если сбрасывать нечего, 3D актёра не загружено или транзакция уже завершена, commit() ничего не делает.
+ * Без commit() запросы просто отбрасываются. Не потокобезопасна: живёт на стеке одного вызова применения.
+ * Актёр и флаги - параметры шаблона, поэтому транзакция проверяется с тестовым актёром.
+ *
+ * @tparam Actor Тип актёра с методами GetFullyLoaded3D(), EvaluatePackageAfter3DLoaded(bool) и Reset3D(bool, Flags, bool, Flags).
+ * @tparam Flags Тип флагов сброса с операторами | и |=, Flags{} означает отсутствие флагов.
+ */
+template <class Actor, class Flags>
+class BasicApplyTransaction
+{
+public:
+	using Action = std::function<void()>;
+
+	/**
+	 * @param actor Актёр, к которому применяются пресеты.
+	 */
+	explicit BasicApplyTransaction(Actor* actor) noexcept :
+		m_actor(actor) {}
+
+	BasicApplyTransaction(const BasicApplyTransaction&) = delete;
+	BasicApplyTransaction& operator=(const BasicApplyTransaction&) = delete;
+
+	/**
+	 * @brief Актёр транзакции.
+	 */
+	Actor* actor() const noexcept {
+		return m_actor;
+	}
+
+	/**
+	 * @brief Запросить сброс 3D. Флаги объединяются с уже запрошенными.
+	 * @param flags Что сбросить.
+	 * @param reloadAll Нужна полная перезагрузка модели (первый аргумент Reset3D).
+	 */
+	void requestReset(Flags flags, bool reloadAll = false) noexcept {
+		m_flags |= flags;
+		m_reloadAll = m_reloadAll || reloadAll;
+	}
+
+	/**
+	 * @brief Запросить переоценку пакета ИИ перед сбросом, чтобы актёр не остался в T-позе.
+	 */
+	void requestPackageEvaluation() noexcept {
+		m_evaluatePackage = true;
+	}
+
+	/**
+	 * @brief Добавить действие, которое выполнится перед Reset3D и только если сброс действительно будет.
+	 * @param action Действие, например пересборка головы.
+	 */
+	void beforeReset(Action action) {
+		if (action) {
+			m_beforeReset.push_back(std::move(action));
+		}
+	}
+
+	/**
+	 * @brief Объединённые флаги сброса.
+	 */
+	Flags flags() const noexcept {
+		return m_flags;
+	}
+
+	/**
+	 * @brief Запрошена ли полная перезагрузка модели.
+	 */
+	bool reloadAll() const noexcept {
+		return m_reloadAll;
+	}
+
+	/**
+	 * @brief Есть ли что сбрасывать.
+	 */
+	bool dirty() const noexcept {
+		return !m_done && m_flags != Flags{};
+	}
+
+	/**
+	 * @brief Выполнить один объединённый сброс 3D.
+	 * @return true если Reset3D был вызван.
+	 */
+	bool commit() {
+		if (!dirty() || !m_actor || !m_actor->GetFullyLoaded3D()) {
+			discard();
+			return false;
+		}
+		m_done = true;
+
+		for (auto& action : m_beforeReset) {
+			action();
+		}
+		m_beforeReset.clear();
+		if (m_evaluatePackage) {
+			m_actor->EvaluatePackageAfter3DLoaded(true);
+		}
+		m_actor->Reset3D(m_reloadAll, m_flags, true, Flags{});
+		return true;
+	}
+
+	/**
+	 * @brief Отбросить все запросы без сброса.
+	 */
+	void discard() noexcept {
+		m_done = true;
+		m_beforeReset.clear();
+	}
+
+private:
+	Actor* m_actor{ nullptr };
+	Flags m_flags{};
+	bool m_reloadAll{ false };
+	bool m_evaluatePackage{ false };
+	bool m_done{ false };
+	std::vector<Action> m_beforeReset{};
+};
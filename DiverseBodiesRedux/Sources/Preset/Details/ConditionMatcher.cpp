@@ -0,0 +1,189 @@
+#include "ConditionMatcher.h"
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+namespace {
+	void sortUnique(std::vector<uint32_t>& vec) {
+		std::sort(vec.begin(), vec.end());
+		vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+	}
+
+	bool contains(const std::vector<uint32_t>& sorted, uint32_t value) noexcept {
+		return std::binary_search(sorted.begin(), sorted.end(), value);
+	}
+
+	// Оба вектора отсортированы, условия обычно короче снимка актёра
+	bool intersects(const std::vector<uint32_t>& conditions, const std::vector<uint32_t>& facts) noexcept {
+		auto a = conditions.begin();
+		auto b = facts.begin();
+		while (a != conditions.end() && b != facts.end()) {
+			if (*a == *b) return true;
+			if (*a < *b) ++a;
+			else b = std::lower_bound(b, facts.end(), *a);
+		}
+		return false;
+	}
+}
+
+void ActorFacts::normalize() {
+	sortUnique(keywords);
+	sortUnique(factions);
+}
+
+ActorFacts ActorFacts::signature() const {
+	ActorFacts result = *this;
+	if (!formIDReferenced)
+		result.formID = 0;
+	return result;
+}
+
+size_t ActorFactsHash::operator()(const ActorFacts& facts) const noexcept {
+	size_t seed = 0;
+	auto combine = [&seed](uint64_t value) {
+		seed ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+	};
+	combine(facts.formID);
+	combine(facts.baseFormID);
+	combine(static_cast<uint32_t>(facts.sex));
+	combine(facts.formIDReferenced);
+	for (auto id : facts.keywords)
+		combine(id);
+	combine(facts.keywords.size());
+	for (auto id : facts.factions)
+		combine(id);
+	combine(facts.factions.size());
+	return seed;
+}
+
+ConditionMatcher::ConditionMatcher(int32_t sex,
+	std::vector<uint32_t> formIDs, std::vector<uint32_t> notFormIDs,
+	std::vector<uint32_t> hasKeyword, std::vector<uint32_t> hasNotKeyword,
+	std::vector<uint32_t> inFaction, std::vector<uint32_t> notInFaction) :
+	m_formIDs(std::move(formIDs)),
+	m_notFormIDs(std::move(notFormIDs)),
+	m_hasKeyword(std::move(hasKeyword)),
+	m_hasNotKeyword(std::move(hasNotKeyword)),
+	m_inFaction(std::move(inFaction)),
+	m_notInFaction(std::move(notInFaction))
+{
+	switch (sex) {
+	case ActorFacts::SEX_MALE:
+		m_genderMask = GENDER_MALE;
+		break;
+	case ActorFacts::SEX_FEMALE:
+		m_genderMask = GENDER_FEMALE;
+		break;
+	default:
+		m_genderMask = GENDER_ANY;
+		break;
+	}
+
+	sortUnique(m_formIDs);
+	sortUnique(m_notFormIDs);
+	sortUnique(m_hasKeyword);
+	sortUnique(m_hasNotKeyword);
+	sortUnique(m_inFaction);
+	sortUnique(m_notInFaction);
+}
+
+CoincidenceLevel ConditionMatcher::match(const ActorFacts& facts, Filter filter) const noexcept {
+	CoincidenceLevel coincidenceLevel = CoincidenceLevel::NONE;
+
+	// Проверка пола
+	if ((filter & Filter::Gender) != Filter::None) {
+		if (m_genderMask != GENDER_ANY) {
+			uint8_t actorMask = 0;
+			if (facts.sex == ActorFacts::SEX_MALE) actorMask = GENDER_MALE;
+			else if (facts.sex == ActorFacts::SEX_FEMALE) actorMask = GENDER_FEMALE;
+			if ((m_genderMask & actorMask) == 0)
+				return CoincidenceLevel::NONE;
+		}
+		coincidenceLevel |= CoincidenceLevel::GENDER;
+	}
+
+	// Проверка formID
+	if ((filter & Filter::FormIDs) != Filter::None && !m_formIDs.empty()) {
+		if (contains(m_formIDs, facts.formID) || contains(m_formIDs, facts.baseFormID))
+			return CoincidenceLevel::FULL;
+		else
+			return CoincidenceLevel::NONE;
+	}
+
+	// Проверка notFormID
+	if ((filter & Filter::NotFormIDs) != Filter::None && !m_notFormIDs.empty()) {
+		if (contains(m_notFormIDs, facts.formID) || contains(m_notFormIDs, facts.baseFormID))
+			return CoincidenceLevel::NONE;
+	}
+
+	// Ключевые слова
+	if ((filter & Filter::HasKeyword) != Filter::None && !m_hasKeyword.empty()) {
+		if (!intersects(m_hasKeyword, facts.keywords))
+			return CoincidenceLevel::NONE;
+		coincidenceLevel |= CoincidenceLevel::KEYWORDS;
+	}
+
+	if ((filter & Filter::HasNotKeyword) != Filter::None && !m_hasNotKeyword.empty()) {
+		if (intersects(m_hasNotKeyword, facts.keywords))
+			return CoincidenceLevel::NONE;
+	}
+
+	// Фракции
+	if ((filter & Filter::InFaction) != Filter::None && !m_inFaction.empty()) {
+		if (!intersects(m_inFaction, facts.factions))
+			return CoincidenceLevel::NONE;
+		coincidenceLevel |= CoincidenceLevel::FACTIONS;
+	}
+
+	if ((filter & Filter::NotInFaction) != Filter::None && !m_notInFaction.empty()) {
+		if (intersects(m_notInFaction, facts.factions))
+			return CoincidenceLevel::NONE;
+	}
+
+	return coincidenceLevel;
+}
+
+CoincidenceLevel operator|(CoincidenceLevel a, CoincidenceLevel b) noexcept {
+	return static_cast<CoincidenceLevel>(static_cast<int>(a) | static_cast<int>(b));
+}
+
+CoincidenceLevel& operator|=(CoincidenceLevel& a, CoincidenceLevel b) noexcept {
+	a = a | b;
+	return a;
+}
+
+bool operator<(CoincidenceLevel lhs, CoincidenceLevel rhs) noexcept {
+	return static_cast<int>(lhs) < static_cast<int>(rhs);
+}
+
+Filter operator|(Filter a, Filter b) noexcept {
+	return static_cast<Filter>(static_cast<int>(a) | static_cast<int>(b));
+}
+
+Filter& operator|=(Filter& a, Filter b) noexcept {
+	a = a | b;
+	return a;
+}
+
+Filter operator&(Filter a, Filter b) noexcept {
+	return static_cast<Filter>(static_cast<int>(a) & static_cast<int>(b));
+}
+
+Filter& operator&=(Filter& a, Filter b) noexcept {
+	a = a & b;
+	return a;
+}
+
+Filter operator~(Filter a) noexcept
+{
+	return static_cast<Filter>(~static_cast<std::underlying_type_t<Filter>>(a));
+}
+
+Filter operator^(Filter a, Filter b) noexcept {
+	return static_cast<Filter>(static_cast<int>(a) ^ static_cast<int>(b));
+}
+
+Filter& operator^=(Filter& a, Filter b) noexcept {
+	a = a ^ b;
+	return a;
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Флаги уровня совпадения условий для объекта Actor.
+ * Используется для определения степени соответствия объекта Actor заданным условиям.
+ * NONE - не совпадает ни с одним условием, KEYWORDS - совпадает по ключевым словам,
+ * FACTIONS - совпадает по фракциям, FULL - полное совпадение (например, по formID или editorID). KEYWORDS и FACTIONS добавляются как флаги к результату. has и hasNot имеют один флаг для каждого из них, но проваленная проверка hasNot всё равно вернёт NONE, даже если есть совпадение по has.
+ */
+enum class CoincidenceLevel : int {
+	NONE = 0, // Не совпадает ни с одним условием
+	GENDER = 1 << 0,
+	KEYWORDS = 1 << 1,
+	FACTIONS = 1 << 2,
+	FULL = static_cast<int>(0x7FFFFFFF) // Полное совпадение, например, по formID или editorID
+};
+
+CoincidenceLevel operator|(CoincidenceLevel a, CoincidenceLevel b) noexcept;
+CoincidenceLevel& operator|=(CoincidenceLevel& a, CoincidenceLevel b) noexcept;
+bool operator<(CoincidenceLevel lhs, CoincidenceLevel rhs) noexcept;
+
+// @brief Флаги фильтров для условий, применяемых к объекту Actor. Что бы всё работало корректно при добавлении новых фильтров, нужно добавлять их только в AllFilters, getFilterFromString и метод Check.
+enum class Filter : int {
+	None = 0,				// Нет фильтра
+	Gender = 1 << 0,		// Пол
+	HasKeyword = 1 << 1,	// Имеет ключевое слово
+	HasNotKeyword = 1 << 2, // Не имеет ключевого слова
+	InFaction = 1 << 3,		// В фракции
+	NotInFaction = 1 << 4,  // Не в фракции
+	FormIDs = 1 << 5,		// По formID
+	NotFormIDs = 1 << 6		// Кроме formID
+};
+
+Filter operator|(Filter a, Filter b) noexcept;
+Filter& operator|=(Filter& a, Filter b) noexcept;
+Filter operator&(Filter a, Filter b) noexcept;
+Filter& operator&=(Filter& a, Filter b) noexcept;
+Filter operator~(Filter a) noexcept;
+Filter operator^(Filter a, Filter b) noexcept;
+Filter& operator^=(Filter& a, Filter b) noexcept;
+
+const Filter AllFilters = Filter::Gender | Filter::HasKeyword | Filter::HasNotKeyword | Filter::InFaction | Filter::NotInFaction | Filter::FormIDs | Filter::NotFormIDs;
+
+/**
+ * @brief Снимок данных актёра, нужных для проверки условий. Собирается один раз и используется для проверки любого количества пресетов.
+ *
+ * Хранит только formID, без указателей на формы, поэтому переживает выгрузку актёра. Ключевые слова и фракции хранятся отсортированными,
+ * в снимок попадают только те, что упоминаются в условиях загруженных пресетов (см. ConditionSettings::gatherFacts).
+ */
+struct ActorFacts {
+	static constexpr int32_t SEX_NONE = -1; ///< Пол не определён (значения совпадают с RE::Actor::Sex)
+	static constexpr int32_t SEX_MALE = 0;
+	static constexpr int32_t SEX_FEMALE = 1;
+
+	uint32_t formID{};					///< FormID актёра
+	uint32_t baseFormID{};				///< FormID базы актёра (левельной формы или TESNPC)
+	int32_t sex{ SEX_NONE };			///< Пол актёра
+	std::vector<uint32_t> keywords{};	///< Отсортированные formID ключевых слов, которые есть у актёра
+	std::vector<uint32_t> factions{};	///< Отсортированные formID фракций, в которых состоит актёр
+	bool formIDReferenced{ true };		///< formID актёра упоминается в условиях. Если false, formID не влияет на результат проверки
+
+	/**
+	 * @brief Отсортировать и убрать дубликаты в keywords и factions. Нужно вызвать после ручного заполнения.
+	 */
+	void normalize();
+
+	/**
+	 * @brief Сигнатура снимка: копия без formID актёра, если он не упоминается в условиях.
+	 * Актёры с равными сигнатурами получают одинаковый результат проверки любого пресета.
+	 */
+	ActorFacts signature() const;
+
+	bool operator==(const ActorFacts&) const noexcept = default;
+};
+
+/**
+ * @brief Хэш для ActorFacts, учитывает все поля снимка.
+ */
+struct ActorFactsHash {
+	size_t operator()(const ActorFacts& facts) const noexcept;
+};
+
+/**
+ * @brief Скомпилированные условия пресета: отсортированные векторы formID и маска пола.
+ *
+ * Строится один раз при загрузке пресета из ConditionSettings. Проверка сводится к сравнению маски пола,
+ * бинарному поиску formID актёра и пересечению отсортированных векторов с ActorFacts, без обращений к игре.
+ */
+class ConditionMatcher {
+public:
+	static constexpr uint8_t GENDER_MALE = 1 << 0;
+	static constexpr uint8_t GENDER_FEMALE = 1 << 1;
+	static constexpr uint8_t GENDER_ANY = GENDER_MALE | GENDER_FEMALE;
+
+	ConditionMatcher() noexcept = default;
+
+	/**
+	 * @brief Конструктор. Векторы сортируются и очищаются от дубликатов.
+	 * @param sex Требуемый пол (ActorFacts::SEX_*), SEX_NONE - любой.
+	 * @param formIDs Актёр или его база должны быть в списке.
+	 * @param notFormIDs Актёр и его база не должны быть в списке.
+	 * @param hasKeyword У актёра должно быть хотя бы одно ключевое слово из списка.
+	 * @param hasNotKeyword У актёра не должно быть ни одного ключевого слова из списка.
+	 * @param inFaction Актёр должен состоять хотя бы в одной фракции из списка.
+	 * @param notInFaction Актёр не должен состоять ни в одной фракции из списка.
+	 */
+	ConditionMatcher(int32_t sex,
+		std::vector<uint32_t> formIDs, std::vector<uint32_t> notFormIDs,
+		std::vector<uint32_t> hasKeyword, std::vector<uint32_t> hasNotKeyword,
+		std::vector<uint32_t> inFaction, std::vector<uint32_t> notInFaction);
+
+	/**
+	 * @brief Проверяет снимок актёра. Порядок и результат совпадают с ConditionSettings::check.
+	 * @param facts Снимок актёра.
+	 * @param filter Какие условия проверять.
+	 * @return Уровень совпадения.
+	 */
+	CoincidenceLevel match(const ActorFacts& facts, Filter filter = AllFilters) const noexcept;
+
+	/**
+	 * @brief Маска допустимых полов.
+	 */
+	uint8_t genderMask() const noexcept { return m_genderMask; }
+
+	bool operator==(const ConditionMatcher&) const noexcept = default;
+
+private:
+	uint8_t m_genderMask{ GENDER_ANY };
+	std::vector<uint32_t> m_formIDs{};
+	std::vector<uint32_t> m_notFormIDs{};
+	std::vector<uint32_t> m_hasKeyword{};
+	std::vector<uint32_t> m_hasNotKeyword{};
+	std::vector<uint32_t> m_inFaction{};
+	std::vector<uint32_t> m_notInFaction{};
+};
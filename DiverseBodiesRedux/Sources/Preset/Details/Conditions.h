@@ -11,50 +11,11 @@
 
 #include <boost/json.hpp>
 #include "PresetEnums.h"
+#include "ConditionMatcher.h"
 
 using namespace boost::json;
 namespace logger = F4SE::log;
 
-/**
- * @brief Флаги уровня совпадения условий для объекта Actor.
- * Используется для определения степени соответствия объекта Actor заданным условиям.
- * NONE - не совпадает ни с одним условием, KEYWORDS - совпадает по ключевым словам,
- * FACTIONS - совпадает по фракциям, FULL - полное совпадение (например, по formID или editorID). KEYWORDS и FACTIONS добавляются как флаги к результату. has и hasNot имеют один флаг для каждого из них, но проваленная проверка hasNot всё равно вернёт NONE, даже если есть совпадение по has.
- */
-enum class CoincidenceLevel : int {
-	NONE = 0, // Не совпадает ни с одним условием  
-	GENDER = 1 << 0,
-	KEYWORDS = 1 << 1,
-	FACTIONS = 1 << 2,
-	FULL = static_cast<int>(0x7FFFFFFF) // Полное совпадение, например, по formID или editorID  
-};
-
-CoincidenceLevel operator|(CoincidenceLevel a, CoincidenceLevel b) noexcept;
-CoincidenceLevel& operator|=(CoincidenceLevel& a, CoincidenceLevel b) noexcept;
-bool operator<(CoincidenceLevel lhs, CoincidenceLevel rhs) noexcept;
-
-// @brief Флаги фильтров для условий, применяемых к объекту Actor. Что бы всё работало корректно при добавлении новых фильтров, нужно добавлять их только в AllFilters, getFilterFromString и метод Check.
-enum class Filter : int {
-	None = 0,				// Нет фильтра
-	Gender = 1 << 0,		// Пол
-	HasKeyword = 1 << 1,	// Имеет ключевое слово
-	HasNotKeyword = 1 << 2, // Не имеет ключевого слова
-	InFaction = 1 << 3,		// В фракции
-	NotInFaction = 1 << 4,  // Не в фракции
-	FormIDs = 1 << 5,		// По formID
-	NotFormIDs = 1 << 6		// Кроме formID
-};
-
-Filter operator|(Filter a, Filter b) noexcept;
-Filter& operator|=(Filter& a, Filter b) noexcept;
-Filter operator&(Filter a, Filter b) noexcept;
-Filter& operator&=(Filter& a, Filter b) noexcept;
-Filter operator~(Filter a) noexcept;
-Filter operator^(Filter a, Filter b) noexcept;
-Filter& operator^=(Filter& a, Filter b) noexcept;
-
-const Filter AllFilters = Filter::Gender | Filter::HasKeyword | Filter::HasNotKeyword | Filter::InFaction | Filter::NotInFaction | Filter::FormIDs | Filter::NotFormIDs;
-
 /**
  * @brief Преобразует строковое представление фильтра в enum Filter.
  * @param filterString Строка, представляющая фильтр.
@@ -138,6 +99,22 @@ public:
 	CoincidenceLevel check(const RE::Actor* actor, Filter filter
 		= AllFilters)  const noexcept;
 
+	/**
+	 * @brief Проверяет снимок актёра по скомпилированным условиям, без обращений к игре.
+	 * @param facts Снимок актёра, полученный из gatherFacts().
+	 * @param filter параметр для указания, какие условия проверять. По умолчанию проверяются все условия.
+	 * @return Уровень совпадения, как у check(const RE::Actor*, Filter).
+	 */
+	CoincidenceLevel check(const ActorFacts& facts, Filter filter = AllFilters) const noexcept;
+
+	/**
+	 * @brief Собирает снимок актёра для пакетной проверки условий. Ключевые слова и фракции опрашиваются один раз,
+	 * и только те, что упоминаются в условиях загруженных пресетов.
+	 * @param actor Указатель на объект Actor.
+	 * @return Снимок актёра. Для nullptr возвращается пустой снимок.
+	 */
+	static ActorFacts gatherFacts(const RE::Actor* actor);
+
 	/**
      * @brief Проверяет на пустоту.
      */
@@ -193,6 +170,16 @@ private:
 	//только для NPCPreset
 	bool m_onlyTints{};
 
+	/**
+	 * @brief Скомпилированная версия условий выше, пересобирается через compile().
+	 */
+	ConditionMatcher m_matcher{};
+
+	/**
+	 * @brief Собирает m_matcher из текущих условий и регистрирует ключевые слова и фракции для gatherFacts().
+	 */
+	void compile();
+
 	/**
      * @brief Загрузить условия из файла.
      * @param path Путь к JSON-файлу.
@@ -0,0 +1,100 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Морф пресета с уже интернированным именем (RE::BSFixedString в игре).
+ */
+template <class Name>
+struct MorphEntry {
+	Name name;
+	float value;
+};
+
+/**
+ * @brief Морфы пресета подряд в памяти, в порядке применения.
+ */
+template <class Name>
+using MorphList = std::vector<MorphEntry<Name>>;
+
+/**
+ * @brief Интернировать имена морфов один раз при загрузке пресета.
+ * Повторы имени отбрасываются, остаётся первое значение.
+ *
+ * @param morphs Пары (имя, значение), имя - std::string или то, что в него преобразуется.
+ * @return Список, где Name построен из имени.
+ */
+template <class Name, class Pairs>
+MorphList<Name> internMorphs(const Pairs& morphs) {
+	MorphList<Name> result;
+	result.reserve(std::size(morphs));
+	std::unordered_set<std::string_view> seen;
+	seen.reserve(std::size(morphs));
+	for (const auto& [name, value] : morphs) {
+		const std::string_view view{ name };
+		if (seen.insert(view).second) {
+			result.push_back(MorphEntry<Name>{ Name{ std::string{ view }.c_str() }, static_cast<float>(value) });
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief Совпадает ли значение морфа с уже выставленным. Допуск покрывает округление при разборе слайдеров (/100).
+ */
+inline bool sameMorphValue(float lhs, float rhs) noexcept {
+	return std::fabs(lhs - rhs) <= 1e-5f;
+}
+
+/**
+ * @brief Выставить морфы.
+ *
+ * @param morphs Морфы пресета.
+ * @param incremental Сначала прочитать текущее значение через get и не вызывать set, если оно совпадает.
+ * @param get Функция float(const Name&) - текущее значение морфа на актёре.
+ * @param set Функция void(const Name&, float).
+ * @return Количество вызовов set.
+ */
+template <class Name, class GetFn, class SetFn>
+size_t setMorphs(const MorphList<Name>& morphs, bool incremental, GetFn&& get, SetFn&& set) {
+	size_t calls = 0;
+	for (const auto& morph : morphs) {
+		if (incremental && sameMorphValue(get(morph.name), morph.value)) {
+			continue;
+		}
+		set(morph.name, morph.value);
+		++calls;
+	}
+	return calls;
+}
+
+/**
+ * @brief Обнулить морфы previous, которых нет в current. Нужно при инкрементальной замене пресета без снятия всех морфов.
+ *
+ * @param keyOf Функция ключа имени для сравнения (для BSFixedString - указатель на строку в пуле).
+ * @param set Функция void(const Name&, float).
+ * @return Количество вызовов set.
+ */
+template <class Name, class KeyFn, class SetFn>
+size_t clearStaleMorphs(const MorphList<Name>& current, const MorphList<Name>& previous, KeyFn&& keyOf, SetFn&& set) {
+	using Key = std::decay_t<decltype(keyOf(current.front().name))>;
+	std::unordered_set<Key> keep;
+	keep.reserve(current.size());
+	for (const auto& morph : current) {
+		keep.insert(keyOf(morph.name));
+	}
+
+	size_t calls = 0;
+	for (const auto& morph : previous) {
+		if (!keep.contains(keyOf(morph.name))) {
+			set(morph.name, 0.0f);
+			++calls;
+		}
+	}
+	return calls;
+}
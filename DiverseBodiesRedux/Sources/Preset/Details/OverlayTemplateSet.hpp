@@ -0,0 +1,30 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+/**
+ * @brief Прозрачный хеш строк: поиск по std::string_view и const char* без создания std::string.
+ */
+struct OverlayTemplateHash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view value) const noexcept {
+		return std::hash<std::string_view>{}(value);
+	}
+};
+
+/**
+ * @brief Множество имён шаблонов оверлеев. Строится один раз при загрузке пресета, проверка имени - один поиск в хеш-таблице.
+ */
+using OverlayTemplateSet = std::unordered_set<std::string, OverlayTemplateHash, std::equal_to<>>;
+
+/**
+ * @brief Множество шаблонов, общее для потоков хуков. Читатель берёт снимок через load(), писатель
+ * не меняет множество на месте, а публикует новое через store().
+ */
+using SharedOverlayTemplateSet = std::atomic<std::shared_ptr<const OverlayTemplateSet>>;
@@ -0,0 +1,242 @@
+#include "SliderPresetCache.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <type_traits>
+#include <mmio/mmio.hpp>
+#include "PugiXML/pugixml.hpp"
+#include "Utils/Hash.hpp"
+#include "globals.h"
+
+namespace {
+	struct FileStamp {
+		uint64_t size{};
+		int64_t mtime{};
+	};
+
+	std::optional<FileStamp> stamp(const std::filesystem::path& path) {
+		std::error_code ec;
+		auto size = std::filesystem::file_size(path, ec);
+		if (ec) return std::nullopt;
+		auto time = std::filesystem::last_write_time(path, ec);
+		if (ec) return std::nullopt;
+		return FileStamp{ static_cast<uint64_t>(size), static_cast<int64_t>(time.time_since_epoch().count()) };
+	}
+
+	std::optional<std::string> readFile(const std::filesystem::path& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) return std::nullopt;
+		return std::string{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	}
+
+	/**
+	 * @brief Последовательное чтение из отображённого файла с проверкой границ.
+	 */
+	class Reader {
+	public:
+		Reader(const std::byte* data, size_t size) noexcept : m_data(data), m_size(size) {}
+
+		template <typename T>
+		bool read(T& value) noexcept {
+			static_assert(std::is_trivially_copyable_v<T>);
+			if (m_size - m_offset < sizeof(T)) return false;
+			std::memcpy(&value, m_data + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+			return true;
+		}
+
+		bool read(std::string& value) {
+			uint32_t length = 0;
+			if (!read(length) || m_size - m_offset < length) return false;
+			value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+			m_offset += length;
+			return true;
+		}
+
+	private:
+		const std::byte* m_data;
+		size_t m_size;
+		size_t m_offset{ 0 };
+	};
+
+	template <typename T>
+	void write(std::ostream& out, const T& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void write(std::ostream& out, const std::string& value) {
+		write(out, static_cast<uint32_t>(value.size()));
+		out.write(value.data(), static_cast<std::streamsize>(value.size()));
+	}
+}
+
+SliderPresetCache& SliderPresetCache::get() {
+	static SliderPresetCache instance{ std::filesystem::current_path() / "Data" / "F4SE" / "Plugins" / "DiverseBodiesRedux.slidercache" };
+	return instance;
+}
+
+SliderPresetCache::SliderPresetCache(std::filesystem::path cachePath) :
+	m_cachePath(std::move(cachePath)) {}
+
+std::optional<SliderPresetCache::Sliders> SliderPresetCache::parse(std::string_view content) {
+	pugi::xml_document doc;
+	if (!doc.load_buffer(content.data(), content.size())) return std::nullopt;
+
+	Sliders sliders{};
+	pugi::xml_node presetNode = doc.child("SliderPresets").child("Preset");
+	for (pugi::xml_node sliderNode = presetNode.child("SetSlider"); sliderNode; sliderNode = sliderNode.next_sibling("SetSlider")) {
+		auto nameAttr = sliderNode.attribute("name");
+		auto valueAttr = sliderNode.attribute("value");
+		if (!nameAttr || !valueAttr) {
+			logger::info("...FAILED : missing name or value attribute in slider");
+			continue;
+		}
+		sliders.emplace_back(nameAttr.value(), valueAttr.as_float() / 100.0f);
+	}
+	return sliders;
+}
+
+std::optional<SliderPresetCache::Sliders> SliderPresetCache::sliders(const std::filesystem::path& path) {
+	if (auto cached = find(path)) return cached;
+
+	auto content = readFile(path);
+	if (!content) return std::nullopt;
+	auto parsed = parse(*content);
+	if (parsed) store(path, *content, *parsed);
+	return parsed;
+}
+
+std::optional<SliderPresetCache::Sliders> SliderPresetCache::find(const std::filesystem::path& path) {
+	auto fileStamp = stamp(path);
+	if (!fileStamp) return std::nullopt;
+
+	std::lock_guard lock(m_mutex);
+	if (!m_loaded) load();
+
+	auto it = m_entries.find(path.string());
+	if (it == m_entries.end() || it->second.size != fileStamp->size) return std::nullopt;
+
+	auto& entry = it->second;
+	if (entry.mtime != fileStamp->mtime) {
+		// Время изменилось, но содержимое могло остаться прежним (копирование, распаковка архива)
+		auto content = readFile(path);
+		if (!content || utils::fnv1a(*content) != entry.hash) return std::nullopt;
+		entry.mtime = fileStamp->mtime;
+		m_dirty = true;
+	}
+	entry.used = true;
+	return entry.sliders;
+}
+
+void SliderPresetCache::store(const std::filesystem::path& path, std::string_view content, Sliders sliders) {
+	auto fileStamp = stamp(path);
+	if (!fileStamp || fileStamp->size != content.size()) return; // файл изменился во время разбора
+
+	std::lock_guard lock(m_mutex);
+	if (!m_loaded) load();
+
+	m_entries.insert_or_assign(path.string(), Entry{ fileStamp->size, fileStamp->mtime, utils::fnv1a(content), std::move(sliders), true });
+	m_dirty = true;
+}
+
+void SliderPresetCache::load() {
+	m_loaded = true;
+
+	std::error_code ec;
+	if (!std::filesystem::exists(m_cachePath, ec)) return;
+
+	mmio::mapped_file_source file;
+	if (auto result = file.open(m_cachePath); !result || file.empty()) {
+		logger::warn("SliderPresetCache: failed to map {}", m_cachePath.string());
+		return;
+	}
+
+	Reader reader{ file.data(), file.size() };
+	uint32_t magic = 0, version = 0, count = 0;
+	if (!reader.read(magic) || !reader.read(version) || !reader.read(count) || magic != MAGIC || version != VERSION) {
+		logger::info("SliderPresetCache: {} has unknown format, ignoring", m_cachePath.string());
+		return;
+	}
+
+	std::unordered_map<std::string, Entry> entries;
+	entries.reserve(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		std::string path;
+		Entry entry{};
+		uint32_t sliders = 0;
+		if (!reader.read(path) || !reader.read(entry.size) || !reader.read(entry.mtime) || !reader.read(entry.hash) || !reader.read(sliders)) {
+			logger::warn("SliderPresetCache: {} is truncated, ignoring", m_cachePath.string());
+			return;
+		}
+		for (uint32_t s = 0; s < sliders; ++s) {
+			std::string name;
+			float value = 0.0f;
+			if (!reader.read(name) || !reader.read(value)) {
+				logger::warn("SliderPresetCache: {} is truncated, ignoring", m_cachePath.string());
+				return;
+			}
+			entry.sliders.emplace_back(std::move(name), value);
+		}
+		entries.insert_or_assign(std::move(path), std::move(entry));
+	}
+
+	m_entries = std::move(entries);
+	logger::info("SliderPresetCache: loaded {} entries from {}", m_entries.size(), m_cachePath.string());
+}
+
+bool SliderPresetCache::save() {
+	std::lock_guard lock(m_mutex);
+
+	uint32_t count = 0;
+	for (const auto& [path, entry] : m_entries) {
+		if (entry.used) ++count;
+	}
+	// Записи для удалённых файлов тоже повод перезаписать кэш
+	if (!m_dirty && count == m_entries.size()) return true;
+
+	auto tempPath = m_cachePath;
+	tempPath += ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			logger::error("SliderPresetCache: failed to open {} for writing", tempPath.string());
+			return false;
+		}
+
+		write(out, MAGIC);
+		write(out, VERSION);
+		write(out, count);
+		for (const auto& [path, entry] : m_entries) {
+			if (!entry.used) continue;
+			write(out, path);
+			write(out, entry.size);
+			write(out, entry.mtime);
+			write(out, entry.hash);
+			write(out, static_cast<uint32_t>(entry.sliders.size()));
+			for (const auto& [name, value] : entry.sliders) {
+				write(out, name);
+				write(out, value);
+			}
+		}
+
+		if (!out) {
+			logger::error("SliderPresetCache: failed to write {}", tempPath.string());
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tempPath, m_cachePath, ec);
+	if (ec) {
+		logger::error("SliderPresetCache: failed to replace {}: {}", m_cachePath.string(), ec.message());
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+
+	std::erase_if(m_entries, [](const auto& item) { return !item.second.used; });
+	m_dirty = false;
+	logger::info("SliderPresetCache: saved {} entries to {}", count, m_cachePath.string());
+	return true;
+}
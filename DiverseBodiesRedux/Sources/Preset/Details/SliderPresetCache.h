@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Бинарный кэш разобранных BodySlide XML пресетов (SliderPresets).
+ *
+ * Для каждого файла хранит путь, размер, время изменения, хэш содержимого и уже разобранные слайдеры.
+ * При совпадении размера и времени изменения файл не читается вовсе, при совпадении только размера
+ * сравнивается хэш содержимого. Кэш читается через отображение файла в память при первом обращении
+ * и сохраняется после загрузки всех пресетов методом save(). В файл попадают только записи,
+ * к которым обращались в этой сессии, поэтому удалённые пресеты из кэша исчезают сами.
+ * Потокобезопасен: пресеты грузятся параллельно.
+ */
+class SliderPresetCache {
+public:
+	/**
+	 * @brief Слайдеры в порядке следования в XML (имя -> значение, уже делённое на 100).
+	 */
+	using Sliders = std::vector<std::pair<std::string, float>>;
+
+	/**
+	 * @brief Получить единственный экземпляр кэша (Singleton).
+	 */
+	static SliderPresetCache& get();
+
+	/**
+	 * @brief Кэш в файле cachePath. Плагин работает через get(), отдельный экземпляр нужен для проверки на временном каталоге.
+	 * @param cachePath Путь к файлу кэша, читается при первом обращении.
+	 */
+	explicit SliderPresetCache(std::filesystem::path cachePath);
+	SliderPresetCache(const SliderPresetCache&) = delete;
+	SliderPresetCache& operator=(const SliderPresetCache&) = delete;
+
+	/**
+	 * @brief Получить слайдеры XML пресета: из кэша, а если файл новый или изменился, разобрать и сохранить в кэш.
+	 * @param path Путь к XML пресету.
+	 * @return Слайдеры или std::nullopt, если файл не читается или это не XML.
+	 */
+	std::optional<Sliders> sliders(const std::filesystem::path& path);
+
+	/**
+	 * @brief Разобрать BodySlide XML пресет без обращения к кэшу.
+	 * @param content Содержимое файла.
+	 * @return Слайдеры первого Preset (пустые, если его нет) или std::nullopt, если это не XML.
+	 */
+	static std::optional<Sliders> parse(std::string_view content);
+
+	/**
+	 * @brief Найти слайдеры для файла.
+	 * @param path Путь к XML пресету.
+	 * @return Слайдеры, если запись есть и файл не изменился, иначе std::nullopt.
+	 */
+	std::optional<Sliders> find(const std::filesystem::path& path);
+
+	/**
+	 * @brief Сохранить слайдеры для файла.
+	 * @param path Путь к XML пресету.
+	 * @param content Содержимое файла, из которого были разобраны слайдеры (для хэша).
+	 * @param sliders Разобранные слайдеры.
+	 */
+	void store(const std::filesystem::path& path, std::string_view content, Sliders sliders);
+
+	/**
+	 * @brief Записать кэш на диск, если он изменился.
+	 * @return true если кэш записан или записывать нечего.
+	 */
+	bool save();
+
+private:
+	struct Entry {
+		uint64_t size{};
+		int64_t mtime{};
+		uint64_t hash{};
+		Sliders sliders{};
+		bool used{ false };
+	};
+
+	/**
+	 * @brief Прочитать кэш с диска. Повреждённый или устаревший по версии файл игнорируется целиком.
+	 */
+	void load();
+
+	static constexpr uint32_t MAGIC = 0x43524244; // "DBRC"
+	static constexpr uint32_t VERSION = 1;
+
+	std::filesystem::path m_cachePath;
+	std::unordered_map<std::string, Entry> m_entries;
+	bool m_loaded{ false };
+	bool m_dirty{ false };
+	std::mutex m_mutex;
+};
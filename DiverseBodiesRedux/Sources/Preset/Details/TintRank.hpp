@@ -0,0 +1,60 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Упорядочить элементы по таблице порядка (TintOrder из пресета LooksMenu) без сравнения сортировкой.
+ *
+ * Ранг id - позиция его первого вхождения в order. Элементы раскладываются подсчётом по рангам за O(n + m),
+ * при равном ранге сохраняется исходный порядок. Элементы, которых нет в order, идут в конце по возрастанию id.
+ * Вызывается один раз при загрузке пресета, применение использует готовый вектор.
+ *
+ * @param items Элементы (обычно указатели на тинты).
+ * @param order Порядок id.
+ * @param idOf Возвращает uint32_t id элемента.
+ * @return Элементы в порядке применения.
+ */
+template <class Item, class IdFn>
+std::vector<Item> orderByRank(const std::vector<Item>& items, const std::vector<uint32_t>& order, IdFn idOf) {
+	if (order.empty()) {
+		return items;
+	}
+
+	std::unordered_map<uint32_t, size_t> rankOf;
+	rankOf.reserve(order.size());
+	for (size_t rank = 0; rank < order.size(); ++rank) {
+		rankOf.try_emplace(order[rank], rank);
+	}
+
+	// Ранг каждого элемента, order.size() - нет в порядке
+	std::vector<size_t> ranks(items.size());
+	std::vector<size_t> offsets(order.size() + 1, 0);
+	for (size_t i = 0; i < items.size(); ++i) {
+		auto it = rankOf.find(idOf(items[i]));
+		ranks[i] = it != rankOf.end() ? it->second : order.size();
+		if (ranks[i] < order.size()) {
+			++offsets[ranks[i] + 1];
+		}
+	}
+	for (size_t rank = 1; rank <= order.size(); ++rank) {
+		offsets[rank] += offsets[rank - 1];
+	}
+
+	std::vector<Item> result(offsets[order.size()]);
+	std::vector<Item> unordered;
+	for (size_t i = 0; i < items.size(); ++i) {
+		if (ranks[i] < order.size()) {
+			result[offsets[ranks[i]]++] = items[i];
+		} else {
+			unordered.push_back(items[i]);
+		}
+	}
+
+	std::stable_sort(unordered.begin(), unordered.end(), [&idOf](const Item& lhs, const Item& rhs) {
+		return idOf(lhs) < idOf(rhs);
+	});
+	result.insert(result.end(), unordered.begin(), unordered.end());
+	return result;
+}
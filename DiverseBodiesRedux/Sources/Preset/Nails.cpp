@@ -5,26 +5,32 @@
 
 std::set<std::string> NailsPreset::ALL_ITEMS_M{};
 std::set<std::string> NailsPreset::ALL_ITEMS_F{};
+SharedOverlayTemplateSet NailsPreset::ALL_TEMPLATES_M{ std::make_shared<const OverlayTemplateSet>() };
+SharedOverlayTemplateSet NailsPreset::ALL_TEMPLATES_F{ std::make_shared<const OverlayTemplateSet>() };
 
 void NailsPreset::addOverlaysFromThisToPossibleOverlays() {
 	if (!empty()) {
-		auto& store = m_conditions.gender() == RE::Actor::Sex::Male ? ALL_ITEMS_M : ALL_ITEMS_F;
-		for (auto& el : m_overlays)
-			store.emplace(el.id());
+		const bool isMale = m_conditions.gender() == RE::Actor::Sex::Male;
+		auto& store = isMale ? ALL_ITEMS_M : ALL_ITEMS_F;
+		auto& templates = isMale ? ALL_TEMPLATES_M : ALL_TEMPLATES_F;
+		bool added = false;
+		for (auto& el : m_overlays) {
+			added = store.emplace(el.id()).second || added;
+		}
+		// Хуки читают шаблоны без блокировки: множество не меняется на месте, публикуется новая копия
+		if (added) {
+			templates.store(std::make_shared<const OverlayTemplateSet>(store.begin(), store.end()));
+		}
 	}
 }
 
 NailsPreset::NailsPreset() : OverlayPreset() {}
 
 NailsPreset::NailsPreset(const std::filesystem::path& path) :
-	OverlayPreset(path.string()) {
-	addOverlaysFromThisToPossibleOverlays();
-}
+	OverlayPreset(path.string()) {}
 
 NailsPreset::NailsPreset(const std::string& path) :
-	OverlayPreset(path) {
-	addOverlaysFromThisToPossibleOverlays();
-}
+	OverlayPreset(path) {}
 
 const std::set<std::string> NailsPreset::getAllPossibleMaleOverlays() noexcept {
 	return ALL_ITEMS_M;
@@ -71,7 +77,8 @@ bool NailsPreset::remove(RE::Actor* actor) const {
 		return false;
 	
 	bool isFemale = actor->GetSex() == RE::Actor::Sex::Female;
-	auto overlaysUIDs = findOverlaysUid(actor, isFemale ? ALL_ITEMS_F : ALL_ITEMS_M);
+	const auto templates = (isFemale ? ALL_TEMPLATES_F : ALL_TEMPLATES_M).load();
+	auto overlaysUIDs = findOverlaysUid(actor, *templates);
 
 	auto Interface = LooksMenuInterfaces<OverlayInterface>::GetInterface();
 	if (!Interface) {
@@ -95,14 +102,14 @@ bool NailsPreset::remove(RE::Actor* actor) const {
 	return once;
 }
 
-bool NailsPreset::apply(RE::Actor* actor, bool reset3d) const {
+bool NailsPreset::apply(RE::Actor* actor, ApplyTransaction& transaction) const {
 	static std::unordered_set<RE::Actor*> processingActors{};
 	if (processingActors.contains(actor)) {
 		return false; // Предотвращаем повторную обработку одного и того же актёра
 	}
 	processingActors.insert(actor); // Добавляем актёра в список обрабатываемых
 
-	auto res = OverlayPreset::apply(actor, reset3d); // Используем базовый метод для применения оверлеев
+	auto res = OverlayPreset::apply(actor, transaction); // Используем базовый метод для применения оверлеев
 
 	processingActors.erase(actor); // Удаляем актёра из списка обрабатываемых
 
@@ -132,6 +139,8 @@ std::future<bool> NailsPreset::isValidAsync() const noexcept {
 		}
 		ALL_ITEMS_M.swap(validM);
 		ALL_ITEMS_F.swap(validF);
+		ALL_TEMPLATES_M.store(std::make_shared<const OverlayTemplateSet>(ALL_ITEMS_M.begin(), ALL_ITEMS_M.end()));
+		ALL_TEMPLATES_F.store(std::make_shared<const OverlayTemplateSet>(ALL_ITEMS_F.begin(), ALL_ITEMS_F.end()));
 	}
 	return OverlayPreset::isValidAsync(); // Вызов базового метода для проверки валидности оверлеев
 }
\ No newline at end of file
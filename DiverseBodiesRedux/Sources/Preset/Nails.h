@@ -61,10 +61,11 @@ public:
 	bool remove(RE::Actor* actor) const override;
 
 	/// @copydoc OverlayPreset::apply
-	bool apply(RE::Actor* actor, bool reset3d = true) const override;
+	bool apply(RE::Actor* actor, ApplyTransaction& transaction) const override;
+	using Preset::apply;
 
 	/**
-	* @brief Добавляет все оверлеи из этого пресета в ALL_ITEMS_M и ALL_ITEMS_F. После всех добавлений нужно ревалидировать ALL_ITEMS_M и ALL_ITEMS_F с помощью revalidateAllPossibleOverlays. Метод создан для использования в конструкторе при создании объекта.
+	* @brief Добавляет все оверлеи из этого пресета в ALL_ITEMS_M и ALL_ITEMS_F. После всех добавлений нужно ревалидировать ALL_ITEMS_M и ALL_ITEMS_F с помощью revalidateAllPossibleOverlays. Вызывается PresetsManager последовательно после параллельной загрузки пресетов: наборы не защищены мьютексом.
 	**/
 	void addOverlaysFromThisToPossibleOverlays();
 
@@ -81,4 +82,10 @@ private:
 
 	/// @brief Переменная, которая хранит абсолютно все пресеты, которые могут быть применены к телу женского актёра.
 	static std::set<std::string> ALL_ITEMS_F;
+
+	/// @brief ALL_ITEMS_M в виде хеш-множества для поиска uid оверлеев. Читается из хуков, заменяется целиком.
+	static SharedOverlayTemplateSet ALL_TEMPLATES_M;
+
+	/// @brief ALL_ITEMS_F в виде хеш-множества для поиска uid оверлеев. Читается из хуков, заменяется целиком.
+	static SharedOverlayTemplateSet ALL_TEMPLATES_F;
 };
\ No newline at end of file
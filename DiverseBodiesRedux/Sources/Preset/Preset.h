@@ -1,4 +1,5 @@
 #pragma once
+#include "Details/ApplyTransaction.hpp"
 #include "Details/Conditions.h"
 #include "Details/Overlay.h"
 #include <F4SE/F4SE.h>
@@ -21,6 +22,11 @@ class NailsPreset;
 class NPCPreset;
 class DirectApply;
 
+/**
+ * @brief Транзакция применения пресетов к игровому актёру: один Reset3D на все пресеты.
+ */
+using ApplyTransaction = BasicApplyTransaction<RE::Actor, RE::RESET_3D_FLAGS>;
+
 /**
  * @brief Абстрактный базовый класс для всех пресетов.
  * 
@@ -77,13 +83,30 @@ public:
 	 */
 	virtual CoincidenceLevel check(const RE::Actor* actor, Filter filter = AllFilters) const noexcept;
 
+	/**
+	 * @brief Проверить пресет по заранее собранному снимку актёра (ConditionSettings::gatherFacts). Используется при проверке многих пресетов для одного актёра.
+	 * @param facts Снимок актёра.
+	 * @param filter Какие условия проверять.
+	 * @return Уровень совпадения, как у check(const RE::Actor*, Filter).
+	 */
+	CoincidenceLevel check(const ActorFacts& facts, Filter filter = AllFilters) const noexcept;
+
 	/**
 	 * @brief Применить пресет к актеру с защитой от двойной обработки.
+	 * Обёртка над apply(RE::Actor*, ApplyTransaction&) с собственной транзакцией.
 	 * @param actor Указатель на актера.
 	 * @param reset3d Если true, сбрасывает 3D актёра после применения пресетов.
 	 * @return true, если успешно.
 	 */
-	virtual bool apply(RE::Actor* actor, bool reset3d = true) const = 0;
+	bool apply(RE::Actor* actor, bool reset3d = true) const;
+
+	/**
+	 * @brief Применить пресет к актеру в рамках транзакции. Пресет не сбрасывает 3D сам, а запрашивает сброс у транзакции.
+	 * @param actor Указатель на актера.
+	 * @param transaction Транзакция, общая для всех пресетов актёра. Сброс выполняет вызывающий через commit().
+	 * @return true, если успешно.
+	 */
+	virtual bool apply(RE::Actor* actor, ApplyTransaction& transaction) const = 0;
 
 	/**
 	 * @brief Удалить эффекты пресета с актера с защитой от двойной обработки.
@@ -0,0 +1,88 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include "Preset/Preset.h"
+
+/**
+ * @brief Индекс пресетов по id, отдельная хэш-таблица для каждого PresetType.
+ *
+ * Ключи ссылаются на Preset::id() самих пресетов, поэтому индекс действителен, пока живы пресеты,
+ * по которым он построен. Поиск идёт по std::string_view без создания временных строк.
+ * Не потокобезопасен: синхронизация — забота владельца (см. PresetsManager::m_presetsMutex).
+ */
+class PresetsIndex
+{
+public:
+	/**
+	 * @brief Пересобрать индекс.
+	 * @param presets Пресеты в порядке m_presets (по типу, затем по id). При повторе пары (тип, id) остаётся первый.
+	 */
+	template <class Range>
+	void rebuild(const Range& presets) {
+		for (auto& map : m_maps) {
+			map.clear();
+		}
+		for (const auto& preset : presets) {
+			if (!preset) continue;
+			auto typeIndex = static_cast<size_t>(preset->type());
+			if (typeIndex >= m_maps.size()) continue;
+			m_maps[typeIndex].try_emplace(preset->id(), preset);
+		}
+	}
+
+	/**
+	 * @brief Найти пресет по id среди всех типов.
+	 * Типы обходятся в том же порядке, что и в m_presets, поэтому при совпадении id у разных типов
+	 * находится тот же пресет, что и при переборе.
+	 */
+	std::shared_ptr<Preset> find(std::string_view id) const noexcept {
+		for (const auto& map : m_maps) {
+			if (auto it = map.find(id); it != map.end()) {
+				return it->second;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * @brief Найти пресет по id и типу одним поиском в хэш-таблице.
+	 */
+	std::shared_ptr<Preset> find(std::string_view id, PresetType type) const noexcept {
+		auto typeIndex = static_cast<size_t>(type);
+		if (typeIndex >= m_maps.size()) {
+			return nullptr;
+		}
+		const auto& map = m_maps[typeIndex];
+		auto it = map.find(id);
+		return it != map.end() ? it->second : nullptr;
+	}
+
+	/**
+	 * @brief Количество пресетов в индексе.
+	 */
+	size_t size() const noexcept {
+		size_t result = 0;
+		for (const auto& map : m_maps) {
+			result += map.size();
+		}
+		return result;
+	}
+
+private:
+	/**
+	 * @brief Хэш для гетерогенного поиска по std::string_view.
+	 */
+	struct IdHash {
+		using is_transparent = void;
+		size_t operator()(std::string_view id) const noexcept {
+			return std::hash<std::string_view>{}(id);
+		}
+	};
+
+	using Map = std::unordered_map<std::string_view, std::shared_ptr<Preset>, IdHash, std::equal_to<>>;
+
+	std::array<Map, static_cast<size_t>(PresetType::END)> m_maps;
+};
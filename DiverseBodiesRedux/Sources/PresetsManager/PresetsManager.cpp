@@ -1,6 +1,11 @@
 #include "PresetsManager.h"
 #include "Ini/ini.h"
 #include "MainMenuHandler/MainMenuHandler.h"
+#include "Utils/ParallelFor.hpp"
+#include "Preset/Details/SliderPresetCache.h"
+#include "Validate/ValidateOverlay.h"
+#include "Validate/ValidateTint.h"
+#include <atomic>
 #include <sstream>
 
 
@@ -9,22 +14,87 @@ namespace globals {
 }
 
 PresetsManager::PresetsManager() {
-    loadPresets<BodymorphsPreset>("PATH/sBodymorphsFolders");
-    loadPresets<BodyhairsPreset>("PATH/sBodyhairsFolders");
-    loadPresets<BodyTattoosPreset>("PATH/sBodyTattoosFolders"); 
-    loadPresets<NailsPreset>("PATH/sNailsFolders");
-	loadPresets<NPCPreset>("PATH/sNPCPresetsFolders");
+    // Сначала собираем список файлов, затем разбираем их параллельно
+    PresetsLoadPlan plan;
+    collectPresets<BodymorphsPreset>("PATH/sBodymorphsFolders", plan);
+    collectPresets<BodyhairsPreset>("PATH/sBodyhairsFolders", plan);
+    collectPresets<BodyTattoosPreset>("PATH/sBodyTattoosFolders", plan);
+    collectPresets<NailsPreset>("PATH/sNailsFolders", plan);
+	collectPresets<NPCPreset>("PATH/sNPCPresetsFolders", plan);
+    loadCollectedPresets(plan);
+    {
+        std::lock_guard lock(m_presetsMutex);
+        rebuildIndex();
+    }
     MenuLoaderListener::get().AddFunction("PresetsManager::clearNPCMap", []() {
         NPCPreset::clearNpcMap();
     });
 }
 
+void PresetsManager::loadCollectedPresets(const PresetsLoadPlan& plan) {
+    std::vector<int> counts(plan.folders.size(), 0);
+    size_t folder = 0;
+    // Итог по папкам пишется, когда слияние перешло к следующей папке, как при последовательной загрузке
+    auto finishFolders = [&plan, &counts, &folder](size_t end) {
+        for (; folder < end; ++folder) {
+            const auto& [path, typeName] = plan.folders[folder];
+            if (counts[folder]) {
+                logger::info("Successfully loaded {} {} presets from folder: {}", counts[folder], typeName, path.string());
+            }
+            else {
+                logger::error("No valid {} presets found in folder: {}", typeName, path.string());
+            }
+        }
+    };
+
+    // Сливаем в порядке обхода папок, чтобы при совпадающих пресетах оставался тот же, что и при последовательной загрузке
+    utils::parallelLoadOrdered(globals::executor(), plan.sources.size(), utils::defaultWorkers(),
+        [&plan](size_t i) -> std::shared_ptr<Preset> {
+            const auto& source = plan.sources[i];
+            try {
+                return source.load(source.path);
+            }
+            catch (const std::exception& e) {
+                logger::error("Exception while loading preset {}: {}", source.path.string(), e.what());
+                return nullptr;
+            }
+        },
+        [this, &plan, &counts, &finishFolders](size_t i, std::shared_ptr<Preset>&& preset) {
+            const auto& source = plan.sources[i];
+            finishFolders(source.folder);
+            if (preset && !preset->empty()) {
+                ++counts[source.folder];
+                source.registerItems(*preset);
+                m_presets.insert(std::move(preset));
+            }
+            else {
+                logger::error("Failed to load {} from file: {}", plan.folders[source.folder].typeName, source.path.string());
+            }
+        });
+    finishFolders(plan.folders.size());
+
+    SliderPresetCache::get().save();
+}
+
 PresetsManager& PresetsManager::get() {
     static PresetsManager instance;
     return instance;
 }
 
 void PresetsManager::validatePresets() {
+    // Сбор результатов ставится в пул, когда готовы оба валидатора: последний готовый валидатор ставит задачу сам,
+    // поэтому ни поток пула, ни отдельный поток не ждут обновления списков
+    auto pending = std::make_shared<std::atomic<int>>(2);
+    auto onReady = [this, pending]() {
+        if (pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            globals::executor().post([this]() { collectValidPresets(); }, utils::TaskPriority::Low);
+        }
+    };
+    ValidateTint::validateTint().whenReady(onReady);
+    ValidateOverlay::validateOverlay().whenReady(onReady);
+}
+
+void PresetsManager::collectValidPresets() {
     // Копируем пресеты под мьютексом
     std::vector<std::shared_ptr<Preset>> presetsCopy;
     {
@@ -32,49 +102,41 @@ void PresetsManager::validatePresets() {
         presetsCopy.assign(m_presets.begin(), m_presets.end());
     }
 
-    // Для каждого пресета запускаем асинхронную проверку
-    std::vector<std::pair<std::shared_ptr<Preset>, std::future<bool>>> futures;
+    // Валидаторы уже обновлены, поэтому отложенные future пресетов отвечают по готовым спискам без ожидания
+    decltype(m_presets) validPresets;
     for (const auto& preset : presetsCopy) {
-        if (preset) {
-            futures.emplace_back(preset, preset->isValidAsync());
+        if (preset && preset->isValidAsync().get()) {
+            validPresets.insert(preset);
         }
     }
 
-    // Запускаем отдельный detached thread для сбора результатов и обновления коллекции
-    std::thread([this, futures = std::move(futures)]() mutable {
-        decltype(m_presets) validPresets;
-        for (auto& [preset, fut] : futures) {
-            if (fut.valid() && fut.get()) {
-                validPresets.insert(preset);
-            }
-        }
-        // Обновляем коллекцию под мьютексом
-        {
-            std::lock_guard lock(m_presetsMutex);
-            m_presets.swap(validPresets);
-            m_presetsValidated = true;
-        }
-
-        // Уведомляем всех подписчиков о завершении валидации
-        {
-            std::lock_guard lock(m_callbacksMutex);
+    // Обновляем коллекцию под мьютексом
+    {
+        std::lock_guard lock(m_presetsMutex);
+        m_presets.swap(validPresets);
+        rebuildIndex();
+        m_presetsValidated = true;
+    }
 
-            // Сначала вызываем все колбэки
-            for (const auto& [id, cb, once] : m_validationCallbacks) {
-                if (cb) cb();
-            }
+    // Уведомляем всех подписчиков о завершении валидации
+    {
+        std::lock_guard lock(m_callbacksMutex);
 
-            // Затем удаляем одноразовые подписки
-            m_validationCallbacks.erase(
-                std::remove_if(
-                    m_validationCallbacks.begin(), m_validationCallbacks.end(),
-                    [](const CallbackEntry& entry) { return entry.oneShot; }
-                ),
-                m_validationCallbacks.end()
-            );
+        // Сначала вызываем все колбэки
+        for (const auto& [id, cb, once] : m_validationCallbacks) {
+            if (cb) cb();
         }
-        // validPresets уничтожается вне lock'а
-        }).detach();
+
+        // Затем удаляем одноразовые подписки
+        m_validationCallbacks.erase(
+            std::remove_if(
+                m_validationCallbacks.begin(), m_validationCallbacks.end(),
+                [](const CallbackEntry& entry) { return entry.oneShot; }
+            ),
+            m_validationCallbacks.end()
+        );
+    }
+    // validPresets уничтожается вне lock'а
 }
 
 bool PresetsManager::isReady() {
@@ -99,15 +161,24 @@ bool PresetsManager::unsubscribeFromValidated(CallbackId id) {
     );
 }
 
-inline std::shared_ptr<Preset> PresetsManager::getPreset(const std::string& id) const noexcept {
-    auto it = std::find_if(m_presets.begin(), m_presets.end(),
-        [&id](const std::shared_ptr<Preset>& preset) {
-            return preset && preset->id() == id;
-	});
-	return (it != m_presets.end()) ? *it : nullptr;
+std::shared_ptr<Preset> PresetsManager::getPreset(std::string_view id) const noexcept {
+    std::lock_guard lock(m_presetsMutex);
+    return m_presetsIndex.find(id);
+}
+
+std::shared_ptr<Preset> PresetsManager::getPreset(std::string_view id, PresetType type) const noexcept {
+    std::lock_guard lock(m_presetsMutex);
+    return m_presetsIndex.find(id, type);
 }
 
+void PresetsManager::rebuildIndex() {
+    m_presetsIndex.rebuild(m_presets);
+    m_generation.fetch_add(1, std::memory_order_release);
+}
 
+uint64_t PresetsManager::generation() const noexcept {
+    return m_generation.load(std::memory_order_acquire);
+}
 
 std::shared_ptr<Preset> PresetsManager::operator[](const std::string& id) const noexcept {
     return getPreset(id);
@@ -117,12 +188,7 @@ std::vector<std::shared_ptr<Preset>> PresetsManager::getPresets(const RE::Actor*
 	std::vector<std::shared_ptr<Preset>> applicablePresets;
    
     if (filter == nullptr) {
-        for (const auto& preset : m_presets) {
-            if (preset && preset->check(actor) != CoincidenceLevel::NONE) {
-                applicablePresets.push_back(preset);
-            }
-        }
-
+        return getPresets(ConditionSettings::gatherFacts(actor));
     } else {
         for (const auto& preset : m_presets) {
             if (preset && filter(actor, preset)) {
@@ -139,6 +205,20 @@ std::vector<std::shared_ptr<Preset>> PresetsManager::getPresets(const RE::Actor*
     return applicablePresets;
 }
 
+std::vector<std::shared_ptr<Preset>> PresetsManager::getPresets(const ActorFacts& facts) const noexcept {
+    std::vector<std::shared_ptr<Preset>> applicablePresets;
+    {
+        std::lock_guard lock(m_presetsMutex);
+        // m_presets уже упорядочен так же, как сортирует getPresets(actor, filter), сортировка не нужна
+        for (const auto& preset : m_presets) {
+            if (preset && preset->check(facts) != CoincidenceLevel::NONE) {
+                applicablePresets.push_back(preset);
+            }
+        }
+    }
+    return applicablePresets;
+}
+
 std::vector<std::shared_ptr<Preset>> PresetsManager::operator[](const RE::Actor* actor) const noexcept {
 	return getPresets(actor);
 }
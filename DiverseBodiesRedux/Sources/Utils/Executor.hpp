@@ -0,0 +1,496 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * @brief Количество рабочих потоков по умолчанию.
+     * @param maxWorkers Верхняя граница.
+     * @return hardware_concurrency, ограниченное сверху maxWorkers, но не меньше 1.
+     */
+    inline size_t defaultWorkers(size_t maxWorkers = 8) noexcept {
+        size_t hw = std::thread::hardware_concurrency();
+        return std::clamp<size_t>(hw, 1, std::max<size_t>(maxWorkers, 1));
+    }
+
+    /**
+     * @brief Приоритет задачи Executor. Задачи старшей полосы всегда забираются раньше младших.
+     */
+    enum class TaskPriority : uint8_t
+    {
+        High = 0,   ///< Видимое игроку: превью в меню, актёры рядом с игроком.
+        Normal,     ///< Обычная фоновая работа.
+        Low,        ///< Сбор результатов, отладочные дампы.
+        Count
+    };
+
+    /**
+     * @brief Обработчик исключения, вылетевшего из задачи. Получает what() исключения или "unknown exception".
+     */
+    using TaskErrorHandler = std::function<void(const char* what)>;
+
+    /**
+     * @brief Выполнить задачу и передать её исключение обработчику. Исключение самого обработчика подавляется,
+     * чтобы не остановить рабочий поток или разбор пачки в главном потоке.
+     * @param task Задача.
+     * @param onError Обработчик, может быть пустым.
+     */
+    inline void runReportingErrors(const std::function<void()>& task, const TaskErrorHandler& onError) noexcept {
+        try {
+            try {
+                task();
+            }
+            catch (const std::exception& e) {
+                if (onError) {
+                    onError(e.what());
+                }
+            }
+            catch (...) {
+                if (onError) {
+                    onError("unknown exception");
+                }
+            }
+        }
+        catch (...) {
+        }
+    }
+
+    /**
+     * @brief Признак отмены задачи. Токен по умолчанию никогда не отменяется.
+     */
+    class CancellationToken
+    {
+    public:
+        CancellationToken() = default;
+
+        /**
+         * @brief Отменена ли задача.
+         */
+        bool cancelled() const noexcept {
+            return m_flag && m_flag->load(std::memory_order_acquire);
+        }
+
+    private:
+        friend class CancellationSource;
+        explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> flag) noexcept : m_flag(std::move(flag)) {}
+
+        std::shared_ptr<const std::atomic<bool>> m_flag{};
+    };
+
+    /**
+     * @brief Источник отмены: выдаёт токены и отменяет их все разом.
+     */
+    class CancellationSource
+    {
+    public:
+        CancellationSource() : m_flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+        CancellationToken token() const noexcept {
+            return CancellationToken{ m_flag };
+        }
+
+        void cancel() noexcept {
+            m_flag->store(true, std::memory_order_release);
+        }
+
+        bool cancelled() const noexcept {
+            return m_flag->load(std::memory_order_acquire);
+        }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_flag;
+    };
+
+    /**
+     * @brief Пул с фиксированным числом рабочих потоков и полосами приоритетов.
+     *
+     * Замена потоков, которые создавались на каждый вызов. Задачи одной полосы выполняются в порядке постановки,
+     * отложенные задачи ждут своего срока в общей куче и попадают в полосу по истечении. Отменённые задачи
+     * пропускаются без вызова. Токен сессии отменяется resetSession() при загрузке сохранения, поэтому задачи,
+     * привязанные к старой сессии, не доживают до новой.
+     * Задача не должна блокироваться в ожидании другой задачи этого же пула: потоков фиксированное число.
+     * Исключения задач из post() передаются обработчику onError и дальше не идут, чтобы получить их, используйте submit().
+     */
+    class Executor
+    {
+    public:
+        using Task = std::function<void()>;
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Конструктор. Потоки создаются сразу.
+         * @param workers Количество рабочих потоков, не меньше 1.
+         * @param onError Обработчик исключений задач, вызывается в рабочем потоке. Может быть пустым.
+         */
+        explicit Executor(size_t workers = defaultWorkers(4), TaskErrorHandler onError = nullptr) :
+            m_onError(std::move(onError)) {
+            workers = std::max<size_t>(workers, 1);
+            m_workers.reserve(workers);
+            for (size_t i = 0; i < workers; ++i) {
+                m_workers.emplace_back([this]() { run(); });
+            }
+        }
+
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        ~Executor() {
+            shutdown();
+        }
+
+        /**
+         * @brief Поставить задачу в очередь.
+         * @param task Задача.
+         * @param priority Полоса приоритета.
+         * @param token Токен отмены, проверяется перед запуском.
+         * @return false если пул остановлен.
+         */
+        bool post(Task task, TaskPriority priority = TaskPriority::Normal, CancellationToken token = {}) {
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_stop) {
+                    return false;
+                }
+                m_lanes[static_cast<size_t>(priority)].push_back(Item{ std::move(task), std::move(token) });
+            }
+            m_cv.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Поставить задачу в очередь после задержки. Поток на время ожидания не занимается.
+         * @param task Задача.
+         * @param delay Задержка.
+         * @param priority Полоса, в которую задача попадёт по истечении задержки.
+         * @param token Токен отмены, проверяется перед запуском.
+         * @return false если пул остановлен.
+         */
+        bool postDelayed(Task task, Clock::duration delay, TaskPriority priority = TaskPriority::Normal, CancellationToken token = {}) {
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_stop) {
+                    return false;
+                }
+                m_delayed.push(Delayed{ Clock::now() + delay, m_delayedSeq++, priority, Item{ std::move(task), std::move(token) } });
+            }
+            // Новый срок может оказаться раньше того, до которого спят потоки
+            m_cv.notify_all();
+            return true;
+        }
+
+        /**
+         * @brief Поставить задачу и получить её результат через future.
+         *
+         * Если задача отменена или пул остановлен до её запуска, future завершается исключением std::future_error (broken_promise).
+         * @param fn Функция без аргументов.
+         * @param priority Полоса приоритета.
+         * @param token Токен отмены.
+         * @return Future результата fn.
+         */
+        template <class Fn>
+        auto submit(Fn&& fn, TaskPriority priority = TaskPriority::Normal, CancellationToken token = {}) -> std::future<std::invoke_result_t<Fn>> {
+            using Result = std::invoke_result_t<Fn>;
+            // std::function требует копируемости, packaged_task - только перемещаемый
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+            auto future = task->get_future();
+            post([task]() { (*task)(); }, priority, std::move(token));
+            return future;
+        }
+
+        /**
+         * @brief Токен текущей игровой сессии.
+         */
+        CancellationToken sessionToken() const {
+            std::lock_guard lock(m_mutex);
+            return m_session.token();
+        }
+
+        /**
+         * @brief Отменить все задачи текущей сессии и начать новую. Ожидающие задачи сессии удаляются из очередей сразу,
+         * выполняющиеся доработают сами и могут проверить свой токен.
+         */
+        void resetSession() {
+            std::lock_guard lock(m_mutex);
+            m_session.cancel();
+            m_session = CancellationSource{};
+            for (auto& lane : m_lanes) {
+                std::erase_if(lane, [](const Item& item) { return item.token.cancelled(); });
+            }
+            std::vector<Delayed> delayed;
+            delayed.reserve(m_delayed.size());
+            while (!m_delayed.empty()) {
+                if (!m_delayed.top().item.token.cancelled()) {
+                    delayed.push_back(m_delayed.top());
+                }
+                m_delayed.pop();
+            }
+            for (auto& entry : delayed) {
+                m_delayed.push(std::move(entry));
+            }
+        }
+
+        /**
+         * @brief Остановить пул: ожидающие задачи отбрасываются, выполняющиеся дорабатывают, потоки присоединяются.
+         * Повторный вызов ничего не делает.
+         */
+        void shutdown() {
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_stop) {
+                    return;
+                }
+                m_stop = true;
+                m_session.cancel();
+                for (auto& lane : m_lanes) {
+                    lane.clear();
+                }
+                m_delayed = {};
+            }
+            m_cv.notify_all();
+            for (auto& worker : m_workers) {
+                if (worker.get_id() == std::this_thread::get_id()) {
+                    worker.detach();
+                }
+                else if (worker.joinable()) {
+                    worker.join();
+                }
+            }
+        }
+
+        /**
+         * @brief Количество рабочих потоков.
+         */
+        size_t workersCount() const noexcept {
+            return m_workers.size();
+        }
+
+        /**
+         * @brief Количество задач в очередях, включая отложенные.
+         */
+        size_t pending() const {
+            std::lock_guard lock(m_mutex);
+            size_t result = m_delayed.size();
+            for (const auto& lane : m_lanes) {
+                result += lane.size();
+            }
+            return result;
+        }
+
+    private:
+        struct Item
+        {
+            Task task;
+            CancellationToken token;
+        };
+
+        struct Delayed
+        {
+            Clock::time_point due;
+            uint64_t seq;
+            TaskPriority priority;
+            Item item;
+
+            // Для min-кучи: раньше срок - выше, при равных сроках сохраняется порядок постановки
+            bool operator>(const Delayed& other) const noexcept {
+                return due != other.due ? due > other.due : seq > other.seq;
+            }
+        };
+
+        void promoteDue(Clock::time_point now) {
+            while (!m_delayed.empty() && m_delayed.top().due <= now) {
+                auto& top = m_delayed.top();
+                m_lanes[static_cast<size_t>(top.priority)].push_back(top.item);
+                m_delayed.pop();
+            }
+        }
+
+        bool popNext(Item& item) {
+            for (auto& lane : m_lanes) {
+                if (!lane.empty()) {
+                    item = std::move(lane.front());
+                    lane.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run() {
+            std::unique_lock lock(m_mutex);
+            while (!m_stop) {
+                promoteDue(Clock::now());
+
+                Item item;
+                if (popNext(item)) {
+                    lock.unlock();
+                    if (item.task && !item.token.cancelled()) {
+                        runReportingErrors(item.task, m_onError);
+                    }
+                    // Захваченное задачей освобождается вне блокировки
+                    item = {};
+                    lock.lock();
+                    continue;
+                }
+
+                if (m_delayed.empty()) {
+                    m_cv.wait(lock);
+                }
+                else {
+                    // Копия срока: пока поток спит, postDelayed может перестроить кучу и ссылка на top() повиснет
+                    const auto due = m_delayed.top().due;
+                    m_cv.wait_until(lock, due);
+                }
+            }
+        }
+
+        std::array<std::deque<Item>, static_cast<size_t>(TaskPriority::Count)> m_lanes{};
+        std::priority_queue<Delayed, std::vector<Delayed>, std::greater<>> m_delayed{};
+        uint64_t m_delayedSeq{ 0 };
+        CancellationSource m_session{};
+        const TaskErrorHandler m_onError;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::vector<std::thread> m_workers;
+        bool m_stop{ false };
+    };
+
+    /**
+     * @brief Очередь работы, которую можно выполнять только в главном потоке игры.
+     *
+     * Задачи копятся в очереди, а в главный поток через dispatcher уходит один вызов drain() на пачку,
+     * вместо отдельной задачи на каждый вызов. drain() выполняет не больше batchLimit задач за раз,
+     * остаток переносится следующим вызовом dispatcher, чтобы не растягивать один кадр.
+     * Задачи, поставленные во время drain(), попадают в следующую пачку. Исключения задач передаются onError,
+     * остальные задачи пачки выполняются как обычно.
+     * Способ попасть в главный поток передаётся снаружи.
+     */
+    class MainThreadQueue
+    {
+    public:
+        using Task = std::function<void()>;
+        /// Передаёт задачу в главный поток. Возвращает false, если это сейчас невозможно.
+        using Dispatcher = std::function<bool(Task)>;
+
+        /**
+         * @brief Конструктор.
+         * @param dispatcher Способ передать вызов в главный поток.
+         * @param batchLimit Сколько задач выполнять за один вызов drain(), не меньше 1.
+         * @param onError Обработчик исключений задач, вызывается в главном потоке. Может быть пустым.
+         */
+        explicit MainThreadQueue(Dispatcher dispatcher, size_t batchLimit = 64, TaskErrorHandler onError = nullptr) :
+            m_dispatcher(std::move(dispatcher)),
+            m_batchLimit(std::max<size_t>(batchLimit, 1)),
+            m_onError(std::move(onError)) {}
+
+        MainThreadQueue(const MainThreadQueue&) = delete;
+        MainThreadQueue& operator=(const MainThreadQueue&) = delete;
+
+        /**
+         * @brief Поставить задачу для главного потока.
+         * @param task Задача.
+         * @param token Токен отмены, проверяется перед запуском.
+         * @return false если передать пачку в главный поток не удалось. Задача при этом остаётся в очереди до следующей попытки.
+         */
+        bool post(Task task, CancellationToken token = {}) {
+            {
+                std::lock_guard lock(m_mutex);
+                m_queue.push_back(Item{ std::move(task), std::move(token) });
+                if (m_scheduled) {
+                    return true;
+                }
+                m_scheduled = true;
+            }
+            return dispatch();
+        }
+
+        /**
+         * @brief Выполнить очередную пачку задач. Вызывается в главном потоке через dispatcher.
+         * @return Количество выполненных задач.
+         */
+        size_t drain() {
+            std::vector<Item> batch;
+            {
+                std::lock_guard lock(m_mutex);
+                size_t count = std::min(m_batchLimit, m_queue.size());
+                batch.reserve(count);
+                for (size_t i = 0; i < count; ++i) {
+                    batch.push_back(std::move(m_queue.front()));
+                    m_queue.pop_front();
+                }
+            }
+
+            size_t executed = 0;
+            for (auto& item : batch) {
+                if (item.task && !item.token.cancelled()) {
+                    runReportingErrors(item.task, m_onError);
+                    ++executed;
+                }
+            }
+
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_queue.empty()) {
+                    m_scheduled = false;
+                    return executed;
+                }
+            }
+            dispatch();
+            return executed;
+        }
+
+        /**
+         * @brief Удалить все ожидающие задачи.
+         */
+        void clear() {
+            std::lock_guard lock(m_mutex);
+            m_queue.clear();
+        }
+
+        /**
+         * @brief Количество ожидающих задач.
+         */
+        size_t pending() const {
+            std::lock_guard lock(m_mutex);
+            return m_queue.size();
+        }
+
+    private:
+        struct Item
+        {
+            Task task;
+            CancellationToken token;
+        };
+
+        bool dispatch() {
+            if (m_dispatcher && m_dispatcher([this]() { drain(); })) {
+                return true;
+            }
+            std::lock_guard lock(m_mutex);
+            m_scheduled = false;
+            return false;
+        }
+
+        Dispatcher m_dispatcher;
+        const size_t m_batchLimit;
+        const TaskErrorHandler m_onError;
+        std::deque<Item> m_queue{};
+        mutable std::mutex m_mutex;
+        bool m_scheduled{ false };
+    };
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+namespace utils
+{
+    /**
+     * @brief Хэш FNV-1a, 64 бит. Используется для проверки, изменилось ли содержимое файла (ini, кэш слайдеров).
+     * @param content Данные.
+     * @return Хэш.
+     */
+    inline uint64_t fnv1a(std::string_view content) noexcept {
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : content) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Executor.hpp"
+
+namespace utils
+{
+    /**
+     * @brief Вызвать fn(i) для каждого i из [0, count) на рабочих потоках executor.
+     *
+     * Индексы раздаются через общий атомарный счётчик: освободившийся поток сразу берёт следующий,
+     * поэтому медленные элементы не тормозят остальные. Вызывающий поток тоже участвует в работе,
+     * в пул ставится не больше workers - 1 помощников. Помощник, которого пул запустил уже после того,
+     * как вызывающий поток разобрал все индексы, ничего не делает. Вызывающий поток ждёт только помощников,
+     * которые успели начать, поэтому вызов из задачи того же пула не блокирует его даже при занятых потоках.
+     * Функция возвращает управление после обработки всех элементов. Порядок вызовов не определён,
+     * поэтому результаты нужно складывать по индексу и собирать после возврата.
+     * Если fn бросила исключение, оставшиеся элементы пропускаются, а первое исключение пробрасывается дальше.
+     *
+     * @tparam Fn Тип функции void(size_t).
+     * @param executor Пул, в который ставятся помощники.
+     * @param count Количество элементов.
+     * @param workers Максимальное количество потоков, включая вызывающий.
+     * @param fn Функция обработки элемента.
+     */
+    template<typename Fn>
+    void parallelFor(Executor& executor, size_t count, size_t workers, Fn&& fn) {
+        if (count == 0) {
+            return;
+        }
+        workers = std::clamp<size_t>(workers, 1, count);
+
+        // Помощники могут стартовать после возврата, поэтому общее состояние живёт в shared_ptr,
+        // а к fn они обращаются только пока closed не выставлен
+        struct State
+        {
+            std::atomic<size_t> next{ 0 };
+            std::atomic<bool> failed{ false };
+            std::exception_ptr error{};
+            std::mutex mutex;
+            std::condition_variable done;
+            size_t active{ 0 };
+            bool closed{ false };
+        };
+        auto state = std::make_shared<State>();
+
+        auto work = [count, &fn](State& s) {
+            while (!s.failed.load(std::memory_order_relaxed)) {
+                size_t i = s.next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= count) {
+                    return;
+                }
+                try {
+                    fn(i);
+                }
+                catch (...) {
+                    std::lock_guard lock(s.mutex);
+                    if (!s.error) {
+                        s.error = std::current_exception();
+                    }
+                    s.failed.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        for (size_t i = 1; i < workers; ++i) {
+            executor.post([state, work]() {
+                {
+                    std::lock_guard lock(state->mutex);
+                    if (state->closed) {
+                        return;
+                    }
+                    ++state->active;
+                }
+                work(*state);
+                {
+                    std::lock_guard lock(state->mutex);
+                    --state->active;
+                }
+                state->done.notify_one();
+            }, TaskPriority::High);
+        }
+
+        work(*state);
+
+        std::unique_lock lock(state->mutex);
+        state->closed = true;
+        state->done.wait(lock, [&state]() { return state->active == 0; });
+
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+    /**
+     * @brief Вычислить load(i) для каждого i из [0, count) параллельно, затем передать результаты в merge(i, result)
+     * по возрастанию i в вызывающем потоке.
+     *
+     * Итог совпадает с последовательным циклом merge(i, load(i)), если load не зависит от других элементов:
+     * слияние видит результаты в том же порядке, поэтому при совпадающих ключах побеждает тот же элемент,
+     * и сообщения merge в логе идут в том же порядке. Если load бросила исключение, оно пробрасывается
+     * как в parallelFor, и merge не вызывается ни разу.
+     *
+     * @tparam Load Тип функции Result(size_t), Result должен конструироваться по умолчанию.
+     * @tparam Merge Тип функции void(size_t, Result&&).
+     * @param executor Пул, в который ставятся помощники.
+     * @param count Количество элементов.
+     * @param workers Максимальное количество потоков, включая вызывающий.
+     * @param load Функция обработки элемента, вызывается параллельно.
+     * @param merge Функция слияния, вызывается последовательно.
+     */
+    template<typename Load, typename Merge>
+    void parallelLoadOrdered(Executor& executor, size_t count, size_t workers, Load&& load, Merge&& merge) {
+        using Result = std::invoke_result_t<Load&, size_t>;
+        std::vector<Result> results(count);
+        parallelFor(executor, count, workers, [&results, &load](size_t i) {
+            results[i] = load(i);
+        });
+        for (size_t i = 0; i < count; ++i) {
+            merge(i, std::move(results[i]));
+        }
+    }
+}
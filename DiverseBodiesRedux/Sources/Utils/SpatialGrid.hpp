@@ -0,0 +1,292 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * @brief Точка в игровых координатах.
+     */
+    struct SpatialPoint
+    {
+        float x{ 0.0f };
+        float y{ 0.0f };
+        float z{ 0.0f };
+    };
+
+    /**
+     * @brief Оставить k ближайших результатов по возрастанию расстояния частичным выбором (nth_element), без полной сортировки.
+     * @param results Пары (id, квадрат расстояния).
+     * @param k Сколько оставить.
+     */
+    template<typename Id>
+    void selectNearest(std::vector<std::pair<Id, float>>& results, size_t k)
+    {
+        auto closer = [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; };
+        if (k < results.size()) {
+            std::nth_element(results.begin(), results.begin() + k, results.end(), closer);
+            results.resize(k);
+        }
+        std::sort(results.begin(), results.end(), closer);
+    }
+
+    /**
+     * @brief Равномерная сетка по плоскости XY для поиска объектов в радиусе.
+     *
+     * Объект хранится в ячейке своей XY-позиции, расстояние считается в 3D. upsert() переносит объект
+     * между ячейками только при смене ячейки, erase() удаляет за O(1) перестановкой с последним в ячейке.
+     * Поиск в радиусе обходит только ячейки, пересекающие квадрат радиуса, а если таких ячеек больше,
+     * чем объектов, - все объекты. Сверка (beginSweep/endSweep) удаляет объекты, не обновлённые с начала сверки.
+     * Класс не потокобезопасен, синхронизация — забота владельца (см. SpatialGrid).
+     *
+     * @tparam Id Тип идентификатора объекта (должен поддерживать std::hash).
+     */
+    template<typename Id>
+    class SpatialGridCore
+    {
+    public:
+        using Result = std::pair<Id, float>;   ///< id и квадрат расстояния до центра поиска.
+
+        /**
+         * @param cellSize Сторона ячейки в игровых единицах.
+         */
+        explicit SpatialGridCore(float cellSize = 4096.0f) noexcept :
+            m_cellSize(cellSize > 0.0f ? cellSize : 1.0f) {}
+
+        /**
+         * @brief Добавить объект или обновить его позицию.
+         */
+        void upsert(const Id& id, SpatialPoint point) {
+            const uint64_t cell = cellOf(point.x, point.y);
+            auto [it, inserted] = m_records.try_emplace(id);
+            auto& record = it->second;
+            record.point = point;
+            record.sweep = m_sweep;
+            if (!inserted && record.cell == cell) {
+                return;
+            }
+            if (!inserted) {
+                detach(record);
+            }
+            auto& bucket = m_cells[cell];
+            record.cell = cell;
+            record.slot = bucket.size();
+            bucket.push_back(id);
+        }
+
+        /**
+         * @brief Удалить объект.
+         * @return true если объект был.
+         */
+        bool erase(const Id& id) {
+            auto it = m_records.find(id);
+            if (it == m_records.end()) {
+                return false;
+            }
+            detach(it->second);
+            m_records.erase(it);
+            return true;
+        }
+
+        bool contains(const Id& id) const {
+            return m_records.contains(id);
+        }
+
+        void clear() {
+            m_records.clear();
+            m_cells.clear();
+        }
+
+        size_t size() const noexcept {
+            return m_records.size();
+        }
+
+        /**
+         * @brief Начать сверку: всё, что не будет обновлено через upsert() до endSweep(), удалится.
+         */
+        void beginSweep() noexcept {
+            ++m_sweep;
+        }
+
+        /**
+         * @brief Закончить сверку.
+         * @return Количество удалённых объектов.
+         */
+        size_t endSweep() {
+            std::vector<Id> stale;
+            for (const auto& [id, record] : m_records) {
+                if (record.sweep != m_sweep) {
+                    stale.push_back(id);
+                }
+            }
+            for (const auto& id : stale) {
+                erase(id);
+            }
+            return stale.size();
+        }
+
+        /**
+         * @brief Все объекты в радиусе, без порядка.
+         * @param center Центр поиска.
+         * @param radius Радиус.
+         * @return Пары (id, квадрат расстояния).
+         */
+        std::vector<Result> queryRadius(SpatialPoint center, float radius) const {
+            std::vector<Result> results;
+            if (radius < 0.0f || m_records.empty()) {
+                return results;
+            }
+            const float radiusSq = radius * radius;
+            auto consider = [&](const Id& id, const SpatialPoint& point) {
+                const float dx = point.x - center.x;
+                const float dy = point.y - center.y;
+                const float dz = point.z - center.z;
+                const float distanceSq = dx * dx + dy * dy + dz * dz;
+                if (distanceSq <= radiusSq) {
+                    results.emplace_back(id, distanceSq);
+                }
+            };
+
+            const int64_t minX = coord(center.x - radius);
+            const int64_t maxX = coord(center.x + radius);
+            const int64_t minY = coord(center.y - radius);
+            const int64_t maxY = coord(center.y + radius);
+            const auto cellsToVisit = static_cast<double>(maxX - minX + 1) * static_cast<double>(maxY - minY + 1);
+
+            // Радиус шире всей заселённой области - дешевле пройти объекты напрямую
+            if (cellsToVisit >= static_cast<double>(m_records.size())) {
+                for (const auto& [id, record] : m_records) {
+                    consider(id, record.point);
+                }
+                return results;
+            }
+
+            for (int64_t x = minX; x <= maxX; ++x) {
+                for (int64_t y = minY; y <= maxY; ++y) {
+                    auto it = m_cells.find(key(x, y));
+                    if (it == m_cells.end()) {
+                        continue;
+                    }
+                    for (const auto& id : it->second) {
+                        consider(id, m_records.find(id)->second.point);
+                    }
+                }
+            }
+            return results;
+        }
+
+        /**
+         * @brief k ближайших объектов в радиусе по возрастанию расстояния.
+         */
+        std::vector<Result> nearest(SpatialPoint center, float radius, size_t k) const {
+            auto results = queryRadius(center, radius);
+            selectNearest(results, k);
+            return results;
+        }
+
+    private:
+        struct Record
+        {
+            SpatialPoint point{};
+            uint64_t cell{ 0 };
+            size_t slot{ 0 };       ///< Позиция в векторе ячейки.
+            uint64_t sweep{ 0 };
+        };
+
+        int64_t coord(float value) const noexcept {
+            return static_cast<int64_t>(std::floor(value / m_cellSize));
+        }
+
+        static uint64_t key(int64_t x, int64_t y) noexcept {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+        }
+
+        uint64_t cellOf(float x, float y) const noexcept {
+            return key(coord(x), coord(y));
+        }
+
+        void detach(const Record& record) {
+            auto it = m_cells.find(record.cell);
+            if (it == m_cells.end()) {
+                return;
+            }
+            auto& bucket = it->second;
+            if (record.slot + 1 != bucket.size()) {
+                bucket[record.slot] = bucket.back();
+                m_records.find(bucket[record.slot])->second.slot = record.slot;
+            }
+            bucket.pop_back();
+            if (bucket.empty()) {
+                m_cells.erase(it);
+            }
+        }
+
+        const float m_cellSize;
+        std::unordered_map<Id, Record> m_records{};
+        std::unordered_map<uint64_t, std::vector<Id>> m_cells{};
+        uint64_t m_sweep{ 0 };
+    };
+
+    /**
+     * @brief Потокобезопасная обёртка над SpatialGridCore.
+     * @tparam Id Тип идентификатора объекта.
+     */
+    template<typename Id>
+    class SpatialGrid
+    {
+    public:
+        using Core = SpatialGridCore<Id>;
+        using Result = typename Core::Result;
+
+        explicit SpatialGrid(float cellSize = 4096.0f) :
+            m_core(cellSize) {}
+
+        void upsert(const Id& id, SpatialPoint point) {
+            std::lock_guard lock(m_mutex);
+            m_core.upsert(id, point);
+        }
+
+        bool erase(const Id& id) {
+            std::lock_guard lock(m_mutex);
+            return m_core.erase(id);
+        }
+
+        void clear() {
+            std::lock_guard lock(m_mutex);
+            m_core.clear();
+        }
+
+        size_t size() const {
+            std::lock_guard lock(m_mutex);
+            return m_core.size();
+        }
+
+        /**
+         * @brief Сверить индекс с полным списком текущих позиций под одной блокировкой.
+         * @param current Все объекты, которые сейчас существуют, с позициями. Остальные удаляются.
+         * @return Количество удалённых объектов.
+         */
+        size_t sweep(const std::vector<std::pair<Id, SpatialPoint>>& current) {
+            std::lock_guard lock(m_mutex);
+            m_core.beginSweep();
+            for (const auto& [id, point] : current) {
+                m_core.upsert(id, point);
+            }
+            return m_core.endSweep();
+        }
+
+        std::vector<Result> queryRadius(SpatialPoint center, float radius) const {
+            std::lock_guard lock(m_mutex);
+            return m_core.queryRadius(center, radius);
+        }
+
+    private:
+        Core m_core;
+        mutable std::mutex m_mutex;
+    };
+}
@@ -0,0 +1,373 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "Utils/ParallelFor.hpp"
+
+/**
+ * @brief Сохраняемый между сессиями кэш проверки материалов оверлеев (bgsm из overlays.json).
+ *
+ * Хранит размер и время изменения каждого overlays.json и множество материалов, которые были найдены.
+ * Материал берётся из кэша, только если все ссылающиеся на него overlays.json не менялись, иначе
+ * проверяется заново. Отсутствующие материалы не кэшируются и проверяются каждый раз: их мало, а
+ * доустановленный материал сразу станет видимым. В файл попадают только источники и материалы,
+ * к которым обращались в этой сессии. Не потокобезопасен: им владеет
+ * однопоточное обновление ValidateOverlay.
+ */
+class MaterialValidityCache
+{
+public:
+    /**
+     * @brief Счётчики одного вызова resolve().
+     */
+    struct Stats
+    {
+        size_t cached{ 0 };     ///< Взято из кэша.
+        size_t loose{ 0 };      ///< Найдено отдельным файлом.
+        size_t archived{ 0 };   ///< Найдено в архивах.
+        size_t missing{ 0 };    ///< Не найдено.
+    };
+
+    /**
+     * @param cachePath Путь к файлу кэша.
+     */
+    explicit MaterialValidityCache(std::filesystem::path cachePath) :
+        m_cachePath(std::move(cachePath)) {}
+
+    /**
+     * @brief Ключ материала: нижний регистр, прямые слэши, без ведущих слэшей и префикса "materials/".
+     * Пути в игре регистронезависимы, поэтому разные написания одного файла проверяются один раз.
+     */
+    static std::string normalize(std::string_view material)
+    {
+        std::string key;
+        key.reserve(material.size());
+        for (char c : material) {
+            key.push_back(c == '\\' ? '/' : c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c);
+        }
+        key.erase(0, std::min(key.find_first_not_of('/'), key.size()));
+        if (key.starts_with("materials/")) {
+            key.erase(0, std::char_traits<char>::length("materials/"));
+        }
+        return key;
+    }
+
+    /**
+     * @brief Отметить overlays.json, прочитанный в этой сессии.
+     * @param source Путь к файлу.
+     * @return true если файл не менялся с прошлой проверки и его материалам можно верить из кэша.
+     */
+    bool touchSource(const std::filesystem::path& source)
+    {
+        if (!m_loaded) {
+            load();
+        }
+        const auto current = stamp(source);
+        auto& entry = m_sources[source.string()];
+        entry.used = true;
+        if (current && entry.known && entry.size == current->size && entry.mtime == current->mtime) {
+            return true;
+        }
+        entry.known = current.has_value();
+        entry.size = current ? current->size : 0;
+        entry.mtime = current ? current->mtime : 0;
+        m_dirty = true;
+        return false;
+    }
+
+    /**
+     * @brief Проверить материалы.
+     *
+     * Сначала берутся записи кэша, затем оставшиеся материалы ищутся отдельными файлами параллельно,
+     * а не найденные уходят одним пакетом в inArchives.
+     *
+     * @param materials Уникальные ключи normalize().
+     * @param changed Ключи из изменившихся overlays.json, их кэш не используется.
+     * @param looseRoot Папка Data/materials.
+     * @param executor Пул, на потоках которого проверяются файлы.
+     * @param workers Количество потоков для проверки файлов, включая вызывающий.
+     * @param inArchives Функция std::vector<uint8_t>(const std::vector<std::string>&): для каждого ключа 1, если материал есть в архивах.
+     * @param stats Счётчики, можно nullptr.
+     * @return Ключ -> найден ли материал.
+     */
+    template <class ArchiveFn>
+    std::unordered_map<std::string, bool> resolve(const std::vector<std::string>& materials, const std::unordered_set<std::string>& changed,
+        const std::filesystem::path& looseRoot, utils::Executor& executor, size_t workers, ArchiveFn&& inArchives, Stats* stats = nullptr)
+    {
+        if (!m_loaded) {
+            load();
+        }
+        Stats local{};
+        std::unordered_map<std::string, bool> result;
+        result.reserve(materials.size());
+
+        std::vector<const std::string*> toCheck;
+        for (const auto& material : materials) {
+            auto it = m_valid.find(material);
+            if (it != m_valid.end() && !changed.contains(material)) {
+                it->second = true;
+                result.emplace(material, true);
+                ++local.cached;
+            }
+            else {
+                toCheck.push_back(&material);
+            }
+        }
+
+        std::vector<uint8_t> loose(toCheck.size(), 0);
+        utils::parallelFor(executor, toCheck.size(), workers, [&](size_t i) {
+            std::error_code ec;
+            loose[i] = std::filesystem::exists(looseRoot / *toCheck[i], ec) ? 1 : 0;
+        });
+
+        std::vector<std::string> batch;
+        for (size_t i = 0; i < toCheck.size(); ++i) {
+            if (!loose[i]) {
+                batch.push_back(*toCheck[i]);
+            }
+        }
+        std::vector<uint8_t> archived;
+        if (!batch.empty()) {
+            archived = inArchives(batch);
+            archived.resize(batch.size(), 0);
+        }
+
+        for (size_t i = 0, next = 0; i < toCheck.size(); ++i) {
+            const auto& material = *toCheck[i];
+            bool found = loose[i] != 0;
+            if (found) {
+                ++local.loose;
+            }
+            else if (archived[next++]) {
+                found = true;
+                ++local.archived;
+            }
+            else {
+                ++local.missing;
+            }
+            store(material, found);
+            result.emplace(material, found);
+        }
+
+        if (stats) {
+            *stats = local;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Записать кэш на диск, если он изменился.
+     * @return true если кэш записан или записывать нечего.
+     */
+    bool save()
+    {
+        if (!m_loaded) {
+            load();
+        }
+        const bool stale = std::any_of(m_sources.begin(), m_sources.end(), [](const auto& item) { return !item.second.used; })
+            || std::any_of(m_valid.begin(), m_valid.end(), [](const auto& item) { return !item.second; });
+        if (!m_dirty && !stale) {
+            return true;
+        }
+
+        auto tempPath = m_cachePath;
+        tempPath += ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                return false;
+            }
+            write(out, MAGIC);
+            write(out, VERSION);
+            write(out, static_cast<uint32_t>(std::count_if(m_sources.begin(), m_sources.end(), [](const auto& item) { return item.second.used && item.second.known; })));
+            for (const auto& [path, entry] : m_sources) {
+                if (entry.used && entry.known) {
+                    write(out, path);
+                    write(out, entry.size);
+                    write(out, entry.mtime);
+                }
+            }
+            write(out, static_cast<uint32_t>(std::count_if(m_valid.begin(), m_valid.end(), [](const auto& item) { return item.second; })));
+            for (const auto& [material, used] : m_valid) {
+                if (used) {
+                    write(out, material);
+                }
+            }
+            if (!out) {
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, m_cachePath, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        std::erase_if(m_sources, [](const auto& item) { return !item.second.used || !item.second.known; });
+        std::erase_if(m_valid, [](const auto& item) { return !item.second; });
+        m_dirty = false;
+        return true;
+    }
+
+    /**
+     * @brief Количество найденных материалов в кэше.
+     */
+    size_t size()
+    {
+        if (!m_loaded) {
+            load();
+        }
+        return m_valid.size();
+    }
+
+private:
+    struct FileStamp
+    {
+        uint64_t size{};
+        int64_t mtime{};
+    };
+
+    struct Source
+    {
+        uint64_t size{};
+        int64_t mtime{};
+        bool known{ false };
+        bool used{ false };
+    };
+
+    static std::optional<FileStamp> stamp(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        auto time = std::filesystem::last_write_time(path, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        return FileStamp{ static_cast<uint64_t>(size), static_cast<int64_t>(time.time_since_epoch().count()) };
+    }
+
+    void store(const std::string& material, bool found)
+    {
+        if (found) {
+            m_dirty |= m_valid.insert_or_assign(material, true).second;
+        }
+        else {
+            m_dirty |= m_valid.erase(material) > 0;
+        }
+    }
+
+    /**
+     * @brief Прочитать кэш с диска. Повреждённый или устаревший по версии файл игнорируется целиком.
+     */
+    void load()
+    {
+        m_loaded = true;
+
+        std::ifstream file(m_cachePath, std::ios::binary);
+        if (!file) {
+            return;
+        }
+        const std::string data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        size_t offset = 0;
+
+        auto read = [&](auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                uint32_t length = 0;
+                if (!readRaw(data, offset, length) || data.size() - offset < length) {
+                    return false;
+                }
+                value.assign(data, offset, length);
+                offset += length;
+                return true;
+            }
+            else {
+                return readRaw(data, offset, value);
+            }
+        };
+
+        uint32_t magic = 0, version = 0, sources = 0;
+        if (!read(magic) || !read(version) || magic != MAGIC || version != VERSION || !read(sources)) {
+            return;
+        }
+
+        std::unordered_map<std::string, Source> loadedSources;
+        for (uint32_t i = 0; i < sources; ++i) {
+            std::string path;
+            Source entry{};
+            if (!read(path) || !read(entry.size) || !read(entry.mtime)) {
+                return;
+            }
+            entry.known = true;
+            loadedSources.insert_or_assign(std::move(path), entry);
+        }
+
+        uint32_t materials = 0;
+        if (!read(materials)) {
+            return;
+        }
+        std::unordered_map<std::string, bool> loadedValid;
+        loadedValid.reserve(materials);
+        for (uint32_t i = 0; i < materials; ++i) {
+            std::string material;
+            if (!read(material)) {
+                return;
+            }
+            loadedValid.insert_or_assign(std::move(material), false);
+        }
+
+        m_sources = std::move(loadedSources);
+        m_valid = std::move(loadedValid);
+    }
+
+    template <class T>
+    static bool readRaw(const std::string& data, size_t& offset, T& value) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <class T>
+    static void write(std::ostream& out, const T& value)
+    {
+        if constexpr (std::is_same_v<T, std::string>) {
+            write(out, static_cast<uint32_t>(value.size()));
+            out.write(value.data(), static_cast<std::streamsize>(value.size()));
+        }
+        else {
+            static_assert(std::is_trivially_copyable_v<T>);
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+    }
+
+    static constexpr uint32_t MAGIC = 0x434D4244; // "DBMC"
+    static constexpr uint32_t VERSION = 1;
+
+    std::filesystem::path m_cachePath;
+    std::unordered_map<std::string, Source> m_sources{};
+    std::unordered_map<std::string, bool> m_valid{};    ///< Найденные материалы -> обращались ли в этой сессии.
+    bool m_loaded{ false };
+    bool m_dirty{ false };
+};
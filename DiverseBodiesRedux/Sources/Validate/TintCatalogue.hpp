@@ -0,0 +1,194 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Вид шаблона тинта. Значения совпадают с Tint::Type.
+ */
+enum class TintKind : uint8_t
+{
+    Mask = 0,
+    Palette = 1,
+    TextureSet = 2
+};
+
+/**
+ * @brief Запись шаблона тинта в том виде, в каком её отдаёт источник.
+ */
+struct TintTemplateItem
+{
+    /**
+     * @brief Откуда запись.
+     */
+    enum class Origin : uint8_t
+    {
+        Template,   ///< Группы tintingTemplate расы.
+        Actor       ///< Тинты, уже надетые на актёра (могут ссылаться на шаблоны из плагинов).
+    };
+
+    uint32_t id{ 0 };
+    std::optional<TintKind> kind{};     ///< Пусто, если вид не распознан.
+    Origin origin{ Origin::Template };
+    std::string_view group{};           ///< Имя группы, только для сообщений.
+    std::string_view name{};
+    uint32_t templateKey{ 0 };          ///< Номер шаблона (раса и пол) для записей Template, 0 для остальных.
+};
+
+/**
+ * @brief Источник шаблонов тинтов. Игровая реализация обходит tintingTemplate обоих полов подходящих рас
+ * и тинты игрока, тестовая отдаёт заранее подготовленный список.
+ */
+class TintTemplateSource
+{
+public:
+    virtual ~TintTemplateSource() = default;
+
+    /**
+     * @brief Передать все записи в visit. Строки в записи живут только до возврата из visit.
+     */
+    virtual void forEach(const std::function<void(const TintTemplateItem&)>& visit) const = 0;
+};
+
+/**
+ * @brief Индекс шаблонов тинтов: id -> вид.
+ *
+ * Строится один раз обходом источника, после чего проверка тинта - один поиск в хэш-таблице.
+ * Записи без имени, с нулевым id, нераспознанного вида и повторы id отбрасываются, причина
+ * возвращается в отчёте. Повтором считается тот же id внутри одного шаблона или с другим видом:
+ * мужской и женский шаблоны и тинты актёра обычно делят id, это не ошибка.
+ * После построения только читается.
+ */
+class TintCatalogue
+{
+public:
+    struct Entry
+    {
+        TintKind kind;
+        uint32_t templateKey;   ///< Шаблон первой записи с этим id.
+    };
+
+    /**
+     * @brief Отброшенная запись.
+     */
+    struct Rejected
+    {
+        enum class Reason : uint8_t
+        {
+            EmptyName,
+            ZeroId,
+            Duplicate,
+            UnknownKind
+        };
+
+        Reason reason;
+        uint32_t id;
+        std::string group;
+        std::string name;
+    };
+
+    /**
+     * @brief Построить индекс.
+     * @param source Источник шаблонов.
+     * @param rejected Куда сложить отброшенные записи, можно nullptr.
+     */
+    static TintCatalogue build(const TintTemplateSource& source, std::vector<Rejected>* rejected = nullptr)
+    {
+        TintCatalogue catalogue;
+        auto reject = [&](Rejected::Reason reason, const TintTemplateItem& item) {
+            if (rejected) {
+                rejected->push_back({ reason, item.id, std::string{ item.group }, std::string{ item.name } });
+            }
+        };
+
+        source.forEach([&](const TintTemplateItem& item) {
+            const bool fromTemplate = item.origin == TintTemplateItem::Origin::Template;
+            if (fromTemplate && item.name.empty()) {
+                reject(Rejected::Reason::EmptyName, item);
+                return;
+            }
+            if (item.id == 0) {
+                reject(Rejected::Reason::ZeroId, item);
+                return;
+            }
+            if (!item.kind) {
+                reject(Rejected::Reason::UnknownKind, item);
+                return;
+            }
+            auto [it, inserted] = catalogue.m_entries.try_emplace(item.id, Entry{ *item.kind, item.templateKey });
+            if (!inserted && (it->second.kind != *item.kind || (fromTemplate && it->second.templateKey == item.templateKey))) {
+                reject(Rejected::Reason::Duplicate, item);
+            }
+        });
+        return catalogue;
+    }
+
+    /**
+     * @brief Найти шаблон по id.
+     * @return Указатель на запись или nullptr. Живёт, пока жив индекс.
+     */
+    const Entry* find(uint32_t id) const
+    {
+        auto it = m_entries.find(id);
+        return it != m_entries.end() ? &it->second : nullptr;
+    }
+
+    bool contains(uint32_t id) const
+    {
+        return m_entries.contains(id);
+    }
+
+    /**
+     * @brief Есть ли шаблон id нужного вида.
+     */
+    bool contains(uint32_t id, TintKind kind) const
+    {
+        const auto entry = find(id);
+        return entry && entry->kind == kind;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_entries.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_entries.empty();
+    }
+
+    static std::string_view toString(TintKind kind) noexcept
+    {
+        switch (kind) {
+        case TintKind::Mask:
+            return "Mask";
+        case TintKind::Palette:
+            return "Palette";
+        case TintKind::TextureSet:
+            return "TextureSet";
+        }
+        return "Unknown";
+    }
+
+    static std::string_view toString(Rejected::Reason reason) noexcept
+    {
+        switch (reason) {
+        case Rejected::Reason::EmptyName:
+            return "empty name";
+        case Rejected::Reason::ZeroId:
+            return "null uniqueID";
+        case Rejected::Reason::Duplicate:
+            return "uniqueID is not unique";
+        case Rejected::Reason::UnknownKind:
+            return "unknown type";
+        }
+        return "unknown reason";
+    }
+
+private:
+    std::unordered_map<uint32_t, Entry> m_entries{};
+};
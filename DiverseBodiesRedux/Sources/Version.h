@@ -6,5 +6,6 @@ namespace Version {
 	constexpr auto VersionCount = 1;
 	constexpr auto Date = "2025-09-16";
 	constexpr const size_t UID = 'DBR2';
-	constexpr auto SerializationVer = 200;
+	constexpr auto SerializationVer = 201;		// бинарная запись PresetsRecord
+	constexpr auto SerializationVerJson = 200;	// старая JSON запись, поддерживается только на чтение
 }
\ No newline at end of file
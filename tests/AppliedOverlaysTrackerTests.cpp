@@ -0,0 +1,160 @@
+#include "Check.h"
+#include "ActorsManager/Details/AppliedOverlaysTracker.hpp"
+#include <string>
+
+namespace
+{
+    using Decision = AppliedOverlaysTracker::Decision;
+
+    /**
+     * @brief Поддельный интерфейс оверлеев: текущие uid актёра и наличие корня, плюс счётчики обращений.
+     */
+    struct MockOverlays
+    {
+        AppliedOverlaysTracker::Uids uids{};
+        bool root{ true };
+        mutable int uidCalls{ 0 };
+        mutable int rootCalls{ 0 };
+
+        AppliedOverlaysTracker::Uids overlayUids() const
+        {
+            ++uidCalls;
+            return uids;
+        }
+
+        bool hasOverlayRoot() const
+        {
+            ++rootCalls;
+            return root;
+        }
+    };
+
+    constexpr uint32_t actor = 0x0001F00D;
+
+    /**
+     * @brief Как Hooked_DoUpdate3DModel: решить и при Reapply записать отпечаток.
+     */
+    Decision update(AppliedOverlaysTracker& tracker, const std::string& presetId, MockOverlays& overlays)
+    {
+        const auto generation = tracker.generation(actor);
+        const auto decision = tracker.decide(actor, presetId, generation, overlays);
+        if (decision == Decision::Reapply) {
+            tracker.record(actor, presetId, generation, overlays.uids);
+        }
+        return decision;
+    }
+}
+
+TEST_CASE(FirstUpdateReappliesThenSkipsWithoutWalkingOverlays)
+{
+    AppliedOverlaysTracker tracker;
+    MockOverlays overlays{ { 7, 3, 5 } };
+    CHECK(tracker.generation(actor) == 0);
+    CHECK(tracker.bumpGeneration(actor) == 1);
+
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Reapply);
+    CHECK(tracker.size() == 1);
+    CHECK(overlays.uidCalls == 0);
+
+    // Поколение то же: обновления 3D от смены экипировки и попаданий не трогают оверлеи
+    for (int i = 0; i < 100; ++i) {
+        CHECK(update(tracker, "Hairy", overlays) == Decision::Skip);
+    }
+    CHECK(overlays.uidCalls == 0);
+    CHECK(overlays.rootCalls == 0);
+}
+
+TEST_CASE(ApplyThenFirst3DUpdateDoesNotReapply)
+{
+    AppliedOverlaysTracker tracker;
+    MockOverlays overlays{ { 4, 8 } };
+
+    // Загрузка актёра, затем обычное применение: отпечаток пишется с текущим поколением, как в recordAppliedBodyhairs
+    tracker.bumpGeneration(actor);
+    tracker.record(actor, "Hairy", tracker.generation(actor), overlays.uids);
+
+    // Первое обновление 3D после применения без пересборки модели
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Skip);
+    CHECK(overlays.uidCalls == 0);
+
+    // Reset3D из commit() применения пересобирает модель, оверлеи на месте
+    tracker.bumpGeneration(actor);
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Refresh);
+    CHECK(overlays.uidCalls == 1);
+}
+
+TEST_CASE(RebuiltModelWithSameOverlaysRefreshes)
+{
+    AppliedOverlaysTracker tracker;
+    MockOverlays overlays{ { 1, 2, 3 } };
+    tracker.bumpGeneration(actor);
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Reapply);
+
+    // Пересборка модели: поколение растёт, оверлеи на месте в другом порядке и с повтором
+    CHECK(tracker.bumpGeneration(actor) == 2);
+    overlays.uids = { 3, 1, 2, 2 };
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Refresh);
+    CHECK(overlays.rootCalls == 1);
+    CHECK(overlays.uidCalls == 1);
+
+    // Refresh обновил поколение отпечатка
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Skip);
+    CHECK(overlays.uidCalls == 1);
+}
+
+TEST_CASE(ChangedPresetOrOverlaysReapply)
+{
+    AppliedOverlaysTracker tracker;
+    MockOverlays overlays{ { 1, 2 } };
+    tracker.bumpGeneration(actor);
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Reapply);
+
+    // Другой пресет - без обращения к оверлеям, даже при том же поколении
+    CHECK(update(tracker, "Smooth", overlays) == Decision::Reapply);
+    CHECK(overlays.rootCalls == 0);
+
+    // Оверлеи пропали после пересборки
+    tracker.bumpGeneration(actor);
+    overlays.uids = { 1 };
+    CHECK(update(tracker, "Smooth", overlays) == Decision::Reapply);
+
+    // Корня оверлеев нет
+    tracker.bumpGeneration(actor);
+    overlays.root = false;
+    CHECK(update(tracker, "Smooth", overlays) == Decision::Reapply);
+    CHECK(overlays.uidCalls == 1);
+}
+
+TEST_CASE(PresetsAreComparedByIdNotHash)
+{
+    AppliedOverlaysTracker tracker;
+    MockOverlays overlays{ { 4 } };
+    tracker.record(actor, "Preset_A", 0, overlays.uids);
+    CHECK(tracker.decide(actor, "Preset_A", 0, overlays) == Decision::Skip);
+    CHECK(tracker.decide(actor, "Preset_B", 0, overlays) == Decision::Reapply);
+    CHECK(tracker.decide(actor, "preset_a", 0, overlays) == Decision::Reapply);
+    CHECK(tracker.decide(actor, "", 0, overlays) == Decision::Reapply);
+}
+
+TEST_CASE(UnloadErasesFingerprintAndGeneration)
+{
+    AppliedOverlaysTracker tracker;
+    MockOverlays overlays{ { 9 } };
+    tracker.bumpGeneration(actor);
+    tracker.bumpGeneration(actor);
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Reapply);
+    CHECK(tracker.generation(actor) == 2);
+
+    CHECK(tracker.erase(actor));
+    CHECK(!tracker.erase(actor));
+    CHECK(tracker.size() == 0);
+    CHECK(tracker.generation(actor) == 0);
+
+    // Поколение после повторной загрузки начинается заново, пресет переприменяется
+    CHECK(tracker.bumpGeneration(actor) == 1);
+    CHECK(update(tracker, "Hairy", overlays) == Decision::Reapply);
+
+    tracker.clear();
+    CHECK(tracker.size() == 0);
+    CHECK(tracker.generation(actor) == 0);
+}
@@ -0,0 +1,159 @@
+#include "Check.h"
+#include "Preset/Details/ApplyTransaction.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Флаги сброса как RE::RESET_3D_FLAGS: битовое перечисление с | и |=.
+     */
+    enum class Flags : uint32_t
+    {
+        None = 0,
+        Model = 1 << 0,
+        Skin = 1 << 1,
+        Head = 1 << 2,
+        Face = 1 << 3
+    };
+
+    constexpr Flags operator|(Flags a, Flags b) noexcept
+    {
+        return static_cast<Flags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+    }
+
+    constexpr Flags& operator|=(Flags& a, Flags b) noexcept
+    {
+        return a = a | b;
+    }
+
+    /**
+     * @brief Тестовый актёр: считает вызовы и записывает их порядок.
+     */
+    struct MockActor
+    {
+        struct ResetCall
+        {
+            bool reloadAll;
+            Flags flags;
+        };
+
+        bool loaded3D{ true };
+        std::vector<ResetCall> resets;
+        std::vector<std::string> calls;
+
+        bool GetFullyLoaded3D() const noexcept { return loaded3D; }
+
+        void EvaluatePackageAfter3DLoaded(bool)
+        {
+            calls.push_back("evaluate");
+        }
+
+        void Reset3D(bool reloadAll, Flags flags, bool, Flags)
+        {
+            resets.push_back({ reloadAll, flags });
+            calls.push_back("reset");
+        }
+    };
+
+    using Transaction = BasicApplyTransaction<MockActor, Flags>;
+}
+
+TEST_CASE(CommitMergesRequestsIntoOneReset)
+{
+    MockActor actor;
+    Transaction transaction(&actor);
+    // Как в ActorsManager::applyActorPresets: голова, волосы на теле, оверлеи, ногти
+    transaction.requestReset(Flags::Head | Flags::Face);
+    transaction.requestReset(Flags::Skin);
+    transaction.requestReset(Flags::Skin);
+    transaction.requestReset(Flags::Model, true);
+    CHECK(transaction.dirty());
+
+    CHECK(transaction.commit());
+    REQUIRE(actor.resets.size() == 1);
+    CHECK(actor.resets[0].reloadAll);
+    CHECK(actor.resets[0].flags == (Flags::Head | Flags::Face | Flags::Skin | Flags::Model));
+
+    // Повторный commit не сбрасывает второй раз
+    CHECK(!transaction.dirty());
+    CHECK(!transaction.commit());
+    CHECK(actor.resets.size() == 1);
+}
+
+TEST_CASE(DiscardedBodymorphTransactionDoesNotReset)
+{
+    // Путь BODYMORPHS при нескольких пресетах: его запрос полной перезагрузки уходит в отдельную
+    // транзакцию без commit(), общий сброс делают остальные пресеты
+    MockActor actor;
+    {
+        Transaction transaction(&actor);
+        {
+            Transaction bodymorphs(&actor);
+            bodymorphs.requestReset(Flags::Model, true);
+            bodymorphs.requestPackageEvaluation();
+        }
+        CHECK(actor.resets.empty());
+        CHECK(actor.calls.empty());
+
+        transaction.requestReset(Flags::Skin);
+        CHECK(transaction.commit());
+    }
+    REQUIRE(actor.resets.size() == 1);
+    CHECK(!actor.resets[0].reloadAll);
+    CHECK(actor.resets[0].flags == Flags::Skin);
+    CHECK((actor.calls == std::vector<std::string>{ "reset" }));
+
+    // Явный discard() тоже отбрасывает запросы
+    Transaction discarded(&actor);
+    discarded.requestReset(Flags::Model, true);
+    discarded.discard();
+    CHECK(!discarded.commit());
+    CHECK(actor.resets.size() == 1);
+}
+
+TEST_CASE(NoResetWithoutFlagsOr3D)
+{
+    MockActor actor;
+    bool ran = false;
+    {
+        Transaction transaction(&actor);
+        transaction.requestPackageEvaluation();
+        transaction.beforeReset([&ran] { ran = true; });
+        CHECK(!transaction.dirty());
+        CHECK(!transaction.commit());
+    }
+
+    actor.loaded3D = false;
+    {
+        Transaction transaction(&actor);
+        transaction.requestReset(Flags::Skin);
+        transaction.beforeReset([&ran] { ran = true; });
+        CHECK(!transaction.commit());
+    }
+
+    {
+        Transaction transaction(nullptr);
+        transaction.requestReset(Flags::Skin);
+        CHECK(!transaction.commit());
+    }
+
+    CHECK(!ran);
+    CHECK(actor.resets.empty());
+    CHECK(actor.calls.empty());
+}
+
+TEST_CASE(ActionsRunInOrderBeforeReset)
+{
+    MockActor actor;
+    Transaction transaction(&actor);
+    transaction.beforeReset([&actor] { actor.calls.push_back("head"); });
+    transaction.beforeReset({});
+    transaction.requestReset(Flags::Head);
+    transaction.beforeReset([&actor] { actor.calls.push_back("face"); });
+    transaction.requestPackageEvaluation();
+
+    CHECK(transaction.commit());
+    CHECK((actor.calls == std::vector<std::string>{ "head", "face", "evaluate", "reset" }));
+}
@@ -0,0 +1,100 @@
+#include "Check.h"
+#include "Preset/Details/ConditionMatcher.h"
+#include "ActorsManager/Details/CandidatesCache.hpp"
+#include <memory>
+
+namespace
+{
+    using Key = CandidatesCache::Key;
+    using Candidates = CandidatesCache::Candidates;
+
+    /**
+     * @brief Кэш - синглтон, поэтому каждый случай начинает с нового поколения, сбрасывающего прежние записи.
+     */
+    uint64_t freshGeneration()
+    {
+        static uint64_t generation = 0;
+        return ++generation;
+    }
+
+    Key makeKey(uint32_t baseFormID, uint32_t raceFormID)
+    {
+        ActorFacts facts{ 0x14, baseFormID, ActorFacts::SEX_FEMALE, { 0x30, 0x31 }, { 0x40 } };
+        facts.formIDReferenced = false;
+        return Key{ facts.signature(), raceFormID };
+    }
+
+    std::shared_ptr<const Candidates> makeCandidates(const char* id)
+    {
+        auto candidates = std::make_shared<Candidates>();
+        auto& morphs = (*candidates)[static_cast<size_t>(PresetType::BODYMORPHS)];
+        morphs.level = CoincidenceLevel::KEYWORDS;
+        morphs.presets.push_back(std::make_shared<Preset>(PresetType::BODYMORPHS, id));
+        return candidates;
+    }
+}
+
+TEST_CASE(EqualKeysHitAndOtherRacesMiss)
+{
+    auto& cache = CandidatesCache::get();
+    const auto generation = freshGeneration();
+    auto stored = makeCandidates("Raider");
+    cache.store(makeKey(0x100, 0x13746), stored, generation);
+
+    // Другой актёр той же базы: formID не упоминается в условиях и не входит в сигнатуру
+    ActorFacts other{ 0x99, 0x100, ActorFacts::SEX_FEMALE, { 0x30, 0x31 }, { 0x40 } };
+    other.formIDReferenced = false;
+    CHECK(cache.find(Key{ other.signature(), 0x13746 }, generation) == stored);
+
+    CHECK(cache.find(makeKey(0x100, 0x11D83F), generation) == nullptr);
+    CHECK(cache.find(makeKey(0x101, 0x13746), generation) == nullptr);
+}
+
+TEST_CASE(GenerationBumpClearsEntries)
+{
+    auto& cache = CandidatesCache::get();
+    const auto generation = freshGeneration();
+    cache.store(makeKey(0x100, 0x13746), makeCandidates("Settler"), generation);
+    CHECK(cache.find(makeKey(0x100, 0x13746), generation) != nullptr);
+
+    const auto next = freshGeneration();
+    CHECK(cache.find(makeKey(0x100, 0x13746), next) == nullptr);
+    // Запрос со старым поколением после сброса тоже ничего не находит
+    CHECK(cache.find(makeKey(0x100, 0x13746), generation) == nullptr);
+}
+
+TEST_CASE(StoreFromOlderGenerationIsDropped)
+{
+    auto& cache = CandidatesCache::get();
+    const auto old = freshGeneration();
+    const auto current = freshGeneration();
+    CHECK(cache.find(makeKey(0x200, 0x13746), current) == nullptr);
+
+    // Кандидаты посчитаны до перезагрузки пресетов и пришли после неё
+    cache.store(makeKey(0x200, 0x13746), makeCandidates("Stale"), old);
+    CHECK(cache.find(makeKey(0x200, 0x13746), current) == nullptr);
+
+    cache.store(makeKey(0x200, 0x13746), makeCandidates("Fresh"), current);
+    auto found = cache.find(makeKey(0x200, 0x13746), current);
+    CHECK(found != nullptr);
+    CHECK((*found)[static_cast<size_t>(PresetType::BODYMORPHS)].presets.front()->id() == "Fresh");
+}
+
+TEST_CASE(ReachingMaxEntriesClearsTheCache)
+{
+    auto& cache = CandidatesCache::get();
+    const auto generation = freshGeneration();
+    auto candidates = makeCandidates("Gunner");
+    for (uint32_t i = 0; i < CandidatesCache::MAX_ENTRIES; ++i) {
+        cache.store(makeKey(0x1000 + i, 0x13746), candidates, generation);
+    }
+    CHECK(cache.find(makeKey(0x1000, 0x13746), generation) != nullptr);
+    CHECK(cache.find(makeKey(0x1000 + CandidatesCache::MAX_ENTRIES - 1, 0x13746), generation) != nullptr);
+
+    // Запись сверх предела сбрасывает все прежние и остаётся единственной
+    const auto overflow = makeKey(0x1000 + CandidatesCache::MAX_ENTRIES, 0x13746);
+    cache.store(overflow, candidates, generation);
+    CHECK(cache.find(overflow, generation) != nullptr);
+    CHECK(cache.find(makeKey(0x1000, 0x13746), generation) == nullptr);
+    CHECK(cache.find(makeKey(0x1000 + CandidatesCache::MAX_ENTRIES - 1, 0x13746), generation) == nullptr);
+}
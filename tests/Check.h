@@ -0,0 +1,120 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Минимальный каркас хостовых тестов: регистрация случаев, проверки и замеры без внешних зависимостей.
+ *
+ * Тесты запускаются через ctest. Замеры (BENCHMARK) выполняются только с аргументом --bench.
+ */
+namespace test
+{
+    struct Case
+    {
+        const char* name;
+        void (*fn)();
+        bool bench;
+    };
+
+    inline std::vector<Case>& cases()
+    {
+        static std::vector<Case> list;
+        return list;
+    }
+
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    struct Registrar
+    {
+        Registrar(const char* name, void (*fn)(), bool bench)
+        {
+            cases().push_back({ name, fn, bench });
+        }
+    };
+
+    inline void fail(const char* file, int line, const char* expr)
+    {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        ++failures();
+    }
+
+    /**
+     * @brief Среднее время одного вызова fn в микросекундах.
+     */
+    template <class Fn>
+    double measure(size_t iterations, Fn&& fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(iterations);
+    }
+
+    /**
+     * @brief Текущий резидентный объём процесса в КБ, 0 если не поддерживается.
+     */
+    inline long residentKb()
+    {
+#ifdef __linux__
+        long pages = 0, resident = 0;
+        if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+            if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+                resident = 0;
+            }
+            std::fclose(statm);
+        }
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+        return 0;
+#endif
+    }
+
+    inline int run(int argc, char** argv)
+    {
+        const bool bench = argc > 1 && std::strcmp(argv[1], "--bench") == 0;
+        for (const auto& c : cases()) {
+            if (c.bench != bench) {
+                continue;
+            }
+            std::printf("[ RUN  ] %s\n", c.name);
+            const int before = failures();
+            c.fn();
+            std::printf("[ %s ] %s\n", failures() == before ? " OK " : "FAIL", c.name);
+        }
+        return failures() == 0 ? 0 : 1;
+    }
+}
+
+#define TEST_CASE_IMPL(name, bench)                                 \
+    static void name();                                             \
+    static const test::Registrar name##Registrar{ #name, &name, bench }; \
+    static void name()
+
+#define TEST_CASE(name) TEST_CASE_IMPL(name, false)
+#define BENCHMARK(name) TEST_CASE_IMPL(name, true)
+
+#define CHECK(expr)                                  \
+    do {                                             \
+        if (!(expr)) {                               \
+            test::fail(__FILE__, __LINE__, #expr);   \
+        }                                            \
+    } while (false)
+
+#define REQUIRE(expr)                                \
+    do {                                             \
+        if (!(expr)) {                               \
+            test::fail(__FILE__, __LINE__, #expr);   \
+            return;                                  \
+        }                                            \
+    } while (false)
@@ -0,0 +1,283 @@
+#include "Check.h"
+#include "Preset/Details/ConditionMatcher.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Поддельный актёр: ключевые слова и фракции в порядке формы, как их обходят HasKeyword и IsInFaction.
+     */
+    struct FakeActor
+    {
+        uint32_t formID{};
+        uint32_t baseFormID{};
+        int32_t sex{ ActorFacts::SEX_NONE };
+        std::vector<uint32_t> keywords{};
+        std::vector<uint32_t> factions{};
+
+        bool HasKeyword(uint32_t keyword) const
+        {
+            return std::find(keywords.begin(), keywords.end(), keyword) != keywords.end();
+        }
+
+        bool IsInFaction(uint32_t faction) const
+        {
+            return std::find(factions.begin(), factions.end(), faction) != factions.end();
+        }
+
+        /**
+         * @brief Снимок, как его собирает ConditionSettings::gatherFacts.
+         */
+        ActorFacts facts() const
+        {
+            ActorFacts result{ formID, baseFormID, sex, keywords, factions };
+            result.normalize();
+            return result;
+        }
+    };
+
+    /**
+     * @brief Условия пресета в том виде, в каком их проверял прежний ConditionSettings::check.
+     */
+    struct Conditions
+    {
+        int32_t sex{ ActorFacts::SEX_NONE };
+        std::vector<uint32_t> formIDs{}, notFormIDs{}, hasKeyword{}, hasNotKeyword{}, inFaction{}, notInFaction{};
+
+        ConditionMatcher compile() const
+        {
+            return ConditionMatcher{ sex, formIDs, notFormIDs, hasKeyword, hasNotKeyword, inFaction, notInFaction };
+        }
+    };
+
+    std::string editorIdOf(uint32_t formId)
+    {
+        return "DBR_Keyword_" + std::to_string(formId);
+    }
+
+    /**
+     * @brief Прежняя проверка: цикл по записям условия с запросом к актёру на каждую и строкой editorID в нижнем регистре.
+     */
+    CoincidenceLevel checkByLoop(const Conditions& conditions, const FakeActor& actor, Filter filter = AllFilters)
+    {
+        auto has = [](Filter f, Filter flag) { return (f & flag) != Filter::None; };
+        auto contains = [](const std::vector<uint32_t>& ids, uint32_t id) { return std::find(ids.begin(), ids.end(), id) != ids.end(); };
+        CoincidenceLevel level = CoincidenceLevel::NONE;
+
+        if (has(filter, Filter::Gender)) {
+            if (conditions.sex != ActorFacts::SEX_NONE && actor.sex != conditions.sex) {
+                return CoincidenceLevel::NONE;
+            }
+            level |= CoincidenceLevel::GENDER;
+        }
+        if (has(filter, Filter::FormIDs) && !conditions.formIDs.empty()) {
+            return contains(conditions.formIDs, actor.formID) || contains(conditions.formIDs, actor.baseFormID) ? CoincidenceLevel::FULL : CoincidenceLevel::NONE;
+        }
+        if (has(filter, Filter::NotFormIDs) && (contains(conditions.notFormIDs, actor.formID) || contains(conditions.notFormIDs, actor.baseFormID))) {
+            return CoincidenceLevel::NONE;
+        }
+
+        auto anyOf = [](const std::vector<uint32_t>& ids, auto&& test) {
+            bool found = false;
+            for (auto id : ids) {
+                auto editorId = editorIdOf(id);
+                std::transform(editorId.begin(), editorId.end(), editorId.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                found = test(id) || found;
+            }
+            return found;
+        };
+        auto hasKeyword = [&actor](uint32_t id) { return actor.HasKeyword(id); };
+        auto inFaction = [&actor](uint32_t id) { return actor.IsInFaction(id); };
+
+        if (has(filter, Filter::HasKeyword) && !conditions.hasKeyword.empty()) {
+            if (!anyOf(conditions.hasKeyword, hasKeyword)) {
+                return CoincidenceLevel::NONE;
+            }
+            level |= CoincidenceLevel::KEYWORDS;
+        }
+        if (has(filter, Filter::HasNotKeyword) && anyOf(conditions.hasNotKeyword, hasKeyword)) {
+            return CoincidenceLevel::NONE;
+        }
+        if (has(filter, Filter::InFaction) && !conditions.inFaction.empty()) {
+            if (!anyOf(conditions.inFaction, inFaction)) {
+                return CoincidenceLevel::NONE;
+            }
+            level |= CoincidenceLevel::FACTIONS;
+        }
+        if (has(filter, Filter::NotInFaction) && anyOf(conditions.notInFaction, inFaction)) {
+            return CoincidenceLevel::NONE;
+        }
+        return level;
+    }
+
+    std::vector<uint32_t> pick(std::mt19937& rng, size_t maxCount, uint32_t first, uint32_t range)
+    {
+        std::vector<uint32_t> ids(rng() % (maxCount + 1));
+        for (auto& id : ids) {
+            id = first + rng() % range;
+        }
+        return ids;
+    }
+
+    Conditions randomConditions(std::mt19937& rng)
+    {
+        Conditions conditions;
+        conditions.sex = static_cast<int32_t>(rng() % 3) - 1;
+        if (rng() % 8 == 0) {
+            conditions.formIDs = pick(rng, 3, 0x100, 20);
+        }
+        if (rng() % 4 == 0) {
+            conditions.notFormIDs = pick(rng, 3, 0x100, 20);
+        }
+        conditions.hasKeyword = pick(rng, 4, 0x1000, 40);
+        conditions.hasNotKeyword = pick(rng, 2, 0x1000, 40);
+        conditions.inFaction = pick(rng, 3, 0x2000, 30);
+        conditions.notInFaction = pick(rng, 2, 0x2000, 30);
+        return conditions;
+    }
+
+    FakeActor randomActor(std::mt19937& rng)
+    {
+        FakeActor actor;
+        actor.formID = 0x100 + rng() % 20;
+        actor.baseFormID = 0x100 + rng() % 20;
+        actor.sex = static_cast<int32_t>(rng() % 3) - 1;
+        actor.keywords = pick(rng, 12, 0x1000, 40);
+        actor.factions = pick(rng, 8, 0x2000, 30);
+        return actor;
+    }
+}
+
+TEST_CASE(GenderAndFormIdRules)
+{
+    FakeActor actor{ 0x14, 0x20, ActorFacts::SEX_FEMALE };
+    const auto facts = actor.facts();
+
+    CHECK(ConditionMatcher{}.match(facts) == CoincidenceLevel::GENDER);
+    CHECK(ConditionMatcher{}.match(facts, Filter::None) == CoincidenceLevel::NONE);
+
+    Conditions male;
+    male.sex = ActorFacts::SEX_MALE;
+    CHECK(male.compile().match(facts) == CoincidenceLevel::NONE);
+    CHECK(male.compile().match(facts, AllFilters & ~Filter::Gender) == CoincidenceLevel::NONE);
+    CHECK(male.compile().genderMask() == ConditionMatcher::GENDER_MALE);
+
+    // Совпадение formID актёра или базы - полное, остальные условия не проверяются
+    Conditions byBase;
+    byBase.formIDs = { 0x20 };
+    byBase.hasKeyword = { 0x999 };
+    CHECK(byBase.compile().match(facts) == CoincidenceLevel::FULL);
+    byBase.formIDs = { 0x21 };
+    CHECK(byBase.compile().match(facts) == CoincidenceLevel::NONE);
+
+    Conditions excluded;
+    excluded.notFormIDs = { 0x14 };
+    CHECK(excluded.compile().match(facts) == CoincidenceLevel::NONE);
+    CHECK(excluded.compile().match(facts, AllFilters & ~Filter::NotFormIDs) == CoincidenceLevel::GENDER);
+}
+
+TEST_CASE(KeywordAndFactionFlags)
+{
+    FakeActor actor{ 0x14, 0x20, ActorFacts::SEX_MALE, { 0x30, 0x10 }, { 0x50 } };
+    const auto facts = actor.facts();
+
+    Conditions conditions;
+    conditions.hasKeyword = { 0x11, 0x30 };
+    conditions.inFaction = { 0x50, 0x51 };
+    CHECK(conditions.compile().match(facts) == (CoincidenceLevel::GENDER | CoincidenceLevel::KEYWORDS | CoincidenceLevel::FACTIONS));
+    CHECK(conditions.compile().match(facts, Filter::HasKeyword) == CoincidenceLevel::KEYWORDS);
+
+    // hasNot проваливает проверку, даже если has совпал
+    conditions.hasNotKeyword = { 0x10 };
+    CHECK(conditions.compile().match(facts) == CoincidenceLevel::NONE);
+    conditions.hasNotKeyword.clear();
+    conditions.notInFaction = { 0x50 };
+    CHECK(conditions.compile().match(facts) == CoincidenceLevel::NONE);
+
+    // Дубликаты и порядок в условиях не важны
+    Conditions duplicates;
+    duplicates.hasKeyword = { 0x30, 0x11, 0x30 };
+    Conditions sorted;
+    sorted.hasKeyword = { 0x11, 0x30 };
+    CHECK(duplicates.compile() == sorted.compile());
+}
+
+TEST_CASE(MatcherAgreesWithPerConditionLoop)
+{
+    std::mt19937 rng(21);
+    const Filter filters[] = { AllFilters, Filter::Gender, Filter::Gender | Filter::HasKeyword | Filter::HasNotKeyword,
+        AllFilters & ~Filter::Gender, Filter::InFaction | Filter::NotInFaction, Filter::FormIDs | Filter::NotFormIDs };
+    size_t matched = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const auto conditions = randomConditions(rng);
+        const auto actor = randomActor(rng);
+        const auto matcher = conditions.compile();
+        const auto facts = actor.facts();
+        for (auto filter : filters) {
+            const auto expected = checkByLoop(conditions, actor, filter);
+            CHECK(matcher.match(facts, filter) == expected);
+            matched += expected != CoincidenceLevel::NONE;
+        }
+    }
+    // Случайные условия дают и совпадения, и отказы
+    CHECK(matched > 1000);
+    CHECK(matched < 20000 * std::size(filters));
+}
+
+TEST_CASE(SignatureIgnoresUnreferencedFormId)
+{
+    FakeActor first{ 0x14, 0x20, ActorFacts::SEX_MALE, { 0x30 } };
+    FakeActor second = first;
+    second.formID = 0x15;
+
+    auto a = first.facts();
+    auto b = second.facts();
+    a.formIDReferenced = b.formIDReferenced = false;
+    CHECK(a.signature() == b.signature());
+    CHECK(ActorFactsHash{}(a.signature()) == ActorFactsHash{}(b.signature()));
+
+    a.formIDReferenced = b.formIDReferenced = true;
+    CHECK(!(a.signature() == b.signature()));
+
+    // Пустые векторы по-разному распределены между ключевыми словами и фракциями - разные снимки
+    ActorFacts keywords{ 1, 2, 0, { 5 }, {} };
+    ActorFacts factions{ 1, 2, 0, {}, { 5 } };
+    CHECK(ActorFactsHash{}(keywords) != ActorFactsHash{}(factions));
+}
+
+BENCHMARK(MatchOneActorAgainstPresets)
+{
+    std::mt19937 rng(5);
+    std::vector<Conditions> presets;
+    for (int i = 0; i < 500; ++i) {
+        presets.push_back(randomConditions(rng));
+    }
+    std::vector<ConditionMatcher> matchers;
+    for (const auto& conditions : presets) {
+        matchers.push_back(conditions.compile());
+    }
+    FakeActor actor = randomActor(rng);
+    actor.keywords.clear();
+    for (uint32_t i = 0; i < 40; ++i) {
+        actor.keywords.push_back(0x1000 + i * 2);    // Актёр в игре несёт десятки ключевых слов
+    }
+
+    size_t sink = 0;
+    const double loopUs = test::measure(200, [&] {
+        for (const auto& conditions : presets) {
+            sink += checkByLoop(conditions, actor) != CoincidenceLevel::NONE;
+        }
+    });
+    const double matcherUs = test::measure(200, [&] {
+        const auto facts = actor.facts();
+        for (const auto& matcher : matchers) {
+            sink += matcher.match(facts) != CoincidenceLevel::NONE;
+        }
+    });
+    std::printf("500 presets, one actor: per-condition loop %.1f us, snapshot + matcher %.1f us (%zu)\n", loopUs, matcherUs, sink);
+}
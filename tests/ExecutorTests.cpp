@@ -0,0 +1,420 @@
+#include "Check.h"
+#include "Utils/Executor.hpp"
+#include "Utils/ParallelFor.hpp"
+#include <atomic>
+#include <cstdio>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using utils::Executor;
+using utils::TaskPriority;
+
+namespace
+{
+    /**
+     * @brief Занимает единственный поток пула, пока не будет вызван open(). Нужен, чтобы поставить задачи
+     * в очереди до того, как хоть одна из них начнёт выполняться.
+     */
+    class Gate
+    {
+    public:
+        explicit Gate(Executor& executor)
+        {
+            auto started = std::make_shared<std::promise<void>>();
+            auto startedFuture = started->get_future();
+            executor.post([started, opened = m_opened.get_future().share()]() {
+                started->set_value();
+                opened.wait();
+            }, TaskPriority::High);
+            startedFuture.wait();
+        }
+
+        ~Gate()
+        {
+            open();
+        }
+
+        void open()
+        {
+            if (!m_isOpen.exchange(true)) {
+                m_opened.set_value();
+            }
+        }
+
+    private:
+        std::promise<void> m_opened;
+        std::atomic<bool> m_isOpen{ false };
+    };
+
+    /**
+     * @brief Потокобезопасный журнал порядка выполнения.
+     */
+    struct Journal
+    {
+        std::mutex mutex;
+        std::vector<int> order;
+
+        auto record(int value)
+        {
+            return [this, value]() {
+                std::lock_guard lock(mutex);
+                order.push_back(value);
+            };
+        }
+    };
+
+    void waitIdle(Executor& executor)
+    {
+        executor.submit([] {}, TaskPriority::Low).wait();
+    }
+}
+
+TEST_CASE(PriorityLanesAndFifoWithinLane)
+{
+    Executor executor(1);
+    Journal journal;
+    {
+        Gate gate(executor);
+        executor.post(journal.record(30), TaskPriority::Low);
+        executor.post(journal.record(20), TaskPriority::Normal);
+        executor.post(journal.record(10), TaskPriority::High);
+        executor.post(journal.record(21), TaskPriority::Normal);
+        executor.post(journal.record(11), TaskPriority::High);
+        executor.post(journal.record(31), TaskPriority::Low);
+    }
+    waitIdle(executor);
+    CHECK((journal.order == std::vector<int>{ 10, 11, 20, 21, 30, 31 }));
+}
+
+TEST_CASE(DelayedTasksRunInDeadlineOrder)
+{
+    Executor executor(2);
+    Journal journal;
+    const auto start = Executor::Clock::now();
+    std::promise<Executor::Clock::time_point> lastRun;
+    auto lastRunFuture = lastRun.get_future();
+
+    executor.postDelayed(journal.record(3), 60ms);
+    executor.postDelayed(journal.record(1), 20ms);
+    executor.postDelayed(journal.record(2), 40ms);
+    executor.postDelayed([&lastRun] { lastRun.set_value(Executor::Clock::now()); }, 80ms);
+    // Более ранний срок, поставленный позже, не должен ждать уже спящих потоков
+    executor.postDelayed(journal.record(0), 5ms);
+
+    CHECK(lastRunFuture.wait_for(2s) == std::future_status::ready);
+    CHECK(lastRunFuture.get() - start >= 80ms);
+    std::lock_guard lock(journal.mutex);
+    CHECK((journal.order == std::vector<int>{ 0, 1, 2, 3 }));
+}
+
+TEST_CASE(DelayedTasksDoNotOccupyWorkers)
+{
+    Executor executor(1);
+    std::atomic<bool> delayedRan{ false };
+    executor.postDelayed([&delayedRan] { delayedRan = true; }, 10s);
+    // Единственный поток свободен для обычных задач, пока отложенная ждёт своего срока
+    auto result = executor.submit([] { return 42; });
+    CHECK(result.wait_for(2s) == std::future_status::ready);
+    CHECK(result.get() == 42);
+    CHECK(!delayedRan);
+    CHECK(executor.pending() == 1);
+}
+
+TEST_CASE(SubmitPropagatesResultsAndExceptions)
+{
+    Executor executor(2);
+    auto value = executor.submit([] { return std::string("done"); });
+    auto failing = executor.submit([]() -> int { throw std::runtime_error("boom"); });
+    CHECK(value.get() == "done");
+    bool thrown = false;
+    try {
+        failing.get();
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // Исключение из post() не роняет рабочий поток
+    executor.post([] { throw std::logic_error("ignored"); });
+    CHECK(executor.submit([] { return 1; }).get() == 1);
+}
+
+TEST_CASE(PostedTaskExceptionsReachTheErrorHandler)
+{
+    std::mutex mutex;
+    std::vector<std::string> errors;
+    Executor executor(1, [&](const char* what) {
+        std::lock_guard lock(mutex);
+        errors.emplace_back(what);
+    });
+    executor.post([] { throw std::runtime_error("boom"); });
+    executor.post([] { throw 7; });
+    // Исключение из submit() уходит в future, а не в обработчик
+    auto failing = executor.submit([]() -> int { throw std::logic_error("to future"); });
+    CHECK(executor.submit([] { return 1; }).get() == 1);
+    failing.wait();
+
+    {
+        std::lock_guard lock(mutex);
+        CHECK(errors.size() == 2);
+        CHECK(errors[0] == "boom");
+        CHECK(errors[1] == "unknown exception");
+    }
+
+    // Исключение самого обработчика не останавливает поток
+    Executor throwingHandler(1, [](const char*) { throw std::runtime_error("handler"); });
+    throwingHandler.post([] { throw std::runtime_error("task"); });
+    CHECK(throwingHandler.submit([] { return 2; }).get() == 2);
+
+    // В главном потоке обработчик получает исключение, а остальные задачи пачки выполняются
+    std::vector<utils::MainThreadQueue::Task> dispatched;
+    std::vector<std::string> mainErrors;
+    utils::MainThreadQueue queue([&](utils::MainThreadQueue::Task task) {
+        dispatched.push_back(std::move(task));
+        return true;
+    }, 8, [&](const char* what) { mainErrors.emplace_back(what); });
+    int ran = 0;
+    queue.post([] { throw std::runtime_error("main"); });
+    queue.post([&ran] { ++ran; });
+    dispatched.back()();
+    CHECK(ran == 1);
+    CHECK(mainErrors.size() == 1 && mainErrors[0] == "main");
+}
+
+TEST_CASE(CancelledTasksAreSkipped)
+{
+    Executor executor(1);
+    utils::CancellationSource source;
+    std::atomic<int> ran{ 0 };
+    std::future<int> cancelled;
+    {
+        Gate gate(executor);
+        executor.post([&ran] { ++ran; }, TaskPriority::Normal, source.token());
+        cancelled = executor.submit([] { return 1; }, TaskPriority::Normal, source.token());
+        executor.post([&ran] { ran += 10; });
+        source.cancel();
+    }
+    waitIdle(executor);
+    CHECK(ran == 10);
+    bool broken = false;
+    try {
+        cancelled.get();
+    }
+    catch (const std::future_error& e) {
+        broken = e.code() == std::future_errc::broken_promise;
+    }
+    CHECK(broken);
+}
+
+TEST_CASE(ResetSessionDropsPendingSessionTasks)
+{
+    Executor executor(1);
+    std::atomic<int> ran{ 0 };
+    {
+        Gate gate(executor);
+        const auto session = executor.sessionToken();
+        executor.post([&ran] { ++ran; }, TaskPriority::Normal, session);
+        executor.postDelayed([&ran] { ++ran; }, 1ms, TaskPriority::Normal, session);
+        executor.postDelayed([&ran] { ran += 100; }, 1ms);
+        executor.post([&ran] { ran += 10; });
+        CHECK(executor.pending() == 4);
+        executor.resetSession();
+        CHECK(executor.pending() == 2);
+        CHECK(session.cancelled());
+        CHECK(!executor.sessionToken().cancelled());
+    }
+    std::this_thread::sleep_for(5ms);
+    waitIdle(executor);
+    CHECK(ran == 110);
+}
+
+TEST_CASE(ShutdownDropsPendingAndRejectsNewTasks)
+{
+    std::atomic<int> ran{ 0 };
+    auto executor = std::make_unique<Executor>(1);
+    {
+        Gate gate(*executor);
+        executor->post([&ran] { ++ran; });
+        executor->postDelayed([&ran] { ++ran; }, 1ms);
+        std::thread opener([&gate] {
+            std::this_thread::sleep_for(20ms);
+            gate.open();
+        });
+        executor->shutdown();
+        opener.join();
+    }
+    CHECK(ran == 0);
+    CHECK(!executor->post([&ran] { ++ran; }));
+    CHECK(!executor->postDelayed([&ran] { ++ran; }, 1ms));
+    executor->shutdown();
+    executor.reset();
+    CHECK(ran == 0);
+}
+
+TEST_CASE(ConcurrentPostersAllRun)
+{
+    constexpr int posters = 4;
+    constexpr int perPoster = 5000;
+    std::atomic<int> ran{ 0 };
+    {
+        Executor executor(3);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < posters; ++p) {
+            threads.emplace_back([&executor, &ran, p] {
+                for (int i = 0; i < perPoster; ++i) {
+                    const auto priority = static_cast<TaskPriority>((i + p) % 3);
+                    if (i % 10 == 0) {
+                        executor.postDelayed([&ran] { ++ran; }, std::chrono::microseconds(i % 50), priority);
+                    }
+                    else {
+                        executor.post([&ran] { ++ran; }, priority);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+        while (ran < posters * perPoster && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    CHECK(ran == posters * perPoster);
+}
+
+TEST_CASE(MainThreadQueueBatchesDispatches)
+{
+    std::vector<utils::MainThreadQueue::Task> dispatched;
+    bool accept = true;
+    utils::MainThreadQueue queue([&](utils::MainThreadQueue::Task task) {
+        if (!accept) {
+            return false;
+        }
+        dispatched.push_back(std::move(task));
+        return true;
+    }, 3);
+
+    int ran = 0;
+    for (int i = 0; i < 7; ++i) {
+        CHECK(queue.post([&ran] { ++ran; }));
+    }
+    // Одна передача в главный поток на всю пачку
+    CHECK(dispatched.size() == 1);
+
+    utils::CancellationSource source;
+    queue.post([&ran] { ran += 100; }, source.token());
+    source.cancel();
+
+    // Каждый drain выполняет не больше batchLimit задач и сам планирует продолжение
+    for (size_t i = 0; i < dispatched.size(); ++i) {
+        auto task = std::move(dispatched[i]);
+        task();
+    }
+    CHECK(ran == 7);
+    CHECK(dispatched.size() == 3);
+    CHECK(queue.pending() == 0);
+
+    // Если передать не удалось, задача остаётся в очереди и уходит со следующей успешной попыткой
+    accept = false;
+    CHECK(!queue.post([&ran] { ++ran; }));
+    CHECK(queue.pending() == 1);
+    accept = true;
+    CHECK(queue.post([&ran] { ++ran; }));
+    dispatched.back()();
+    CHECK(ran == 9);
+}
+
+TEST_CASE(ParallelForVisitsEveryIndexOnce)
+{
+    Executor executor{ 4 };
+    constexpr size_t count = 1000;
+    std::vector<std::atomic<int>> visits(count);
+    utils::parallelFor(executor, count, 4, [&visits](size_t i) {
+        visits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+    size_t once = 0;
+    for (const auto& visit : visits) {
+        once += visit.load() == 1 ? 1 : 0;
+    }
+    CHECK(once == count);
+}
+
+TEST_CASE(ParallelForRethrowsFirstException)
+{
+    Executor executor{ 2 };
+    std::atomic<int> ran{ 0 };
+    bool thrown = false;
+    try {
+        utils::parallelFor(executor, 100, 2, [&ran](size_t i) {
+            ran.fetch_add(1);
+            if (i == 10) {
+                throw std::runtime_error("item");
+            }
+        });
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(ran.load() < 100);
+}
+
+TEST_CASE(ParallelForDoesNotWaitForHelpersThatNeverStarted)
+{
+    // Единственный поток пула занят: помощники стоят в очереди, всю работу делает вызывающий поток
+    Executor executor{ 1 };
+    Gate gate(executor);
+    size_t sum = 0;
+    utils::parallelFor(executor, 100, 4, [&sum](size_t i) { sum += i; });
+    CHECK(sum == 4950);
+    gate.open();
+
+    // Вызов из задачи того же пула: его единственный поток и есть вызывающий
+    auto nested = executor.submit([&executor]() {
+        std::atomic<size_t> nestedSum{ 0 };
+        utils::parallelFor(executor, 100, 4, [&nestedSum](size_t i) { nestedSum += i; });
+        return nestedSum.load();
+    });
+    REQUIRE(nested.wait_for(10s) == std::future_status::ready);
+    CHECK(nested.get() == 4950);
+    waitIdle(executor);
+}
+
+BENCHMARK(TaskThroughput)
+{
+    constexpr int tasks = 20000;
+    std::atomic<int> ran{ 0 };
+    auto work = [&ran] { ran.fetch_add(1, std::memory_order_relaxed); };
+
+    Executor executor;
+    const double poolUs = test::measure(1, [&] {
+        ran = 0;
+        for (int i = 0; i < tasks; ++i) {
+            executor.post(work);
+        }
+        while (ran.load() < tasks) {
+            std::this_thread::yield();
+        }
+    });
+
+    // Прежний способ: отдельный поток на каждую задачу
+    const double threadsUs = test::measure(1, [&] {
+        ran = 0;
+        for (int i = 0; i < tasks; ++i) {
+            std::thread(work).detach();
+        }
+        while (ran.load() < tasks) {
+            std::this_thread::yield();
+        }
+    });
+
+    std::printf("%d tasks, %zu workers: pool %.0f us (%.2f us/task), thread per task %.0f us (%.2f us/task)\n",
+        tasks, executor.workersCount(), poolUs, poolUs / tasks, threadsUs, threadsUs / tasks);
+}
@@ -0,0 +1,156 @@
+#include "Check.h"
+#include "LooksMenu/LMPresetData.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <boost/json.hpp>
+
+namespace
+{
+    /**
+     * @brief Разобрать образец из tests/Data/LooksMenu так же, как ParseLMPreset: JSON-документ, затем LMPresetData::parse.
+     */
+    LMPresetData parseSample(const std::string& name)
+    {
+        const auto path = std::filesystem::path(DBR_TEST_DATA) / "LooksMenu" / name;
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            test::fail(__FILE__, __LINE__, ("sample " + name + " is missing").c_str());
+            return {};
+        }
+        const std::string content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        const auto document = boost::json::parse(content);
+        if (!document.is_object()) {
+            test::fail(__FILE__, __LINE__, ("sample " + name + " is not an object").c_str());
+            return {};
+        }
+        return LMPresetData::parse(document.as_object());
+    }
+
+    bool hasWarning(const LMPresetData& data, const std::string& text)
+    {
+        return std::any_of(data.warnings.begin(), data.warnings.end(), [&text](const std::string& warning) {
+            return warning.find(text) != std::string::npos;
+        });
+    }
+}
+
+TEST_CASE(FullPresetFields)
+{
+    const auto data = parseSample("Athletic.json");
+    CHECK(!data.empty);
+    CHECK(data.warnings.empty());
+
+    CHECK(data.gender == 1);
+    CHECK(data.hairColor == std::string("Fallout4.esm|B43F0"));
+    CHECK(data.faceHairColor == data.hairColor);
+    REQUIRE(data.headParts.has_value());
+    CHECK((*data.headParts == std::vector<std::string>{ "Fallout4.esm|1E3C6", "Fallout4.esm|A6B95", "DiverseBodies.esp|812" }));
+
+    REQUIRE(data.bodyMorphs.has_value());
+    CHECK(data.bodyMorphs->size() == 3);
+    CHECK(data.bodyMorphs->at("Breasts") == 0.35f);
+    CHECK(data.bodyMorphs->at("Waist") == -0.2f);
+    CHECK(data.bodyMorphs->at("Butt") == 1.0f);
+
+    CHECK(data.hasMorphs);
+    CHECK((data.morphPresets == std::vector<std::pair<uint32_t, float>>{ { 0x1, 0.5f }, { 0x1A, 1.0f } }));
+    REQUIRE(data.morphRegions.has_value());
+    REQUIRE(data.morphRegions->size() == 2);
+    // Недостающий девятый элемент (масштаб) равен 1.0
+    CHECK(((*data.morphRegions)[0] == std::pair<uint32_t, LMPresetData::RegionTransform>{ 0x2, { 0.0f, 0.1f, -0.05f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f } }));
+    CHECK((*data.morphRegions)[1].first == 0x4);
+    CHECK((*data.morphRegions)[1].second[8] == 0.9f);
+    CHECK((data.morphValues == std::vector<float>{ 0.1f, 0.0f, -0.25f }));
+    CHECK(data.morphIntensity == 0.8f);
+
+    REQUIRE(data.overlays.has_value());
+    REQUIRE(data.overlays->size() == 2);
+    const auto& freckles = (*data.overlays)[0];
+    CHECK(freckles.templateName == "DBR_Freckles");
+    CHECK(freckles.priority == 2);
+    CHECK((freckles.tint == std::array<float, 4>{ 1.0f, 0.8f, 0.6f, 0.5f }));
+    CHECK((freckles.offsetUV == std::array<float, 2>{ 0.1f, 0.2f }));
+    CHECK((freckles.scaleUV == std::array<float, 2>{ 1.5f, 1.5f }));
+    const auto& scar = (*data.overlays)[1];
+    CHECK(scar.templateName == "DBR_Scar_Back");
+    CHECK((scar.tint == std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 1.0f }));
+    CHECK((scar.scaleUV == std::array<float, 2>{ 1.0f, 1.0f }));
+
+    REQUIRE(data.tints.has_value());
+    REQUIRE(data.tints->size() == 2);
+    CHECK((*data.tints)[0].id == 0x1B6E);
+    CHECK((*data.tints)[0].type == 0);
+    CHECK((*data.tints)[0].object.contains("Value"));
+    CHECK((*data.tints)[1].id == 0xA1);
+    CHECK(!(*data.tints)[1].type.has_value());
+    CHECK((data.tintOrder == std::vector<uint32_t>{ 0xA1, 0x1B6E }));
+
+    CHECK((data.weight == std::array<float, 3>{ 0.2f, 0.5f, 0.3f }));
+    REQUIRE(data.conditions.has_value());
+    CHECK(data.conditions->size() == 2);
+}
+
+TEST_CASE(MalformedPresetKeepsValidPartsAndWarns)
+{
+    const auto data = parseSample("Malformed.json");
+    CHECK(!data.empty);
+
+    // Ключи без учёта регистра, при повторе берётся первый
+    CHECK(data.gender == 0);
+    CHECK(!data.hairColor.has_value());
+    CHECK((data.headParts == std::vector<std::string>{ "Fallout4.esm|1E3C6" }));
+    REQUIRE(data.bodyMorphs.has_value());
+    CHECK(data.bodyMorphs->size() == 1);
+    CHECK(data.bodyMorphs->at("Hips") == 0.5f);
+
+    CHECK(data.hasMorphs);
+    CHECK(data.morphPresets.has_value());
+    CHECK(data.morphPresets->empty());
+    CHECK(data.morphRegions->empty());
+    CHECK((data.morphValues == std::vector<float>{ 0.5f }));
+    CHECK(!data.morphIntensity.has_value());
+
+    // Пустой шаблон пропускается молча, tint с неверным элементом пропускает его, но сохраняет позиции
+    REQUIRE(data.overlays.has_value());
+    REQUIRE(data.overlays->size() == 1);
+    CHECK((*data.overlays)[0].templateName == "DBR_Tattoo");
+    CHECK(((*data.overlays)[0].tint == std::array<float, 4>{ 1.0f, 0.0f, 0.0f, 1.0f }));
+
+    REQUIRE(data.tints.has_value());
+    REQUIRE(data.tints->size() == 1);
+    CHECK((*data.tints)[0].id == 0x2C);
+    CHECK(!(*data.tints)[0].type.has_value());
+    CHECK((data.tintOrder == std::vector<uint32_t>{ 0x2C }));
+    CHECK((data.weight == std::array<float, 3>{ 0.5f, 0.0f, 0.0f }));
+    CHECK(!data.conditions.has_value());
+
+    CHECK(data.warnings.size() == 18);
+    CHECK(hasWarning(data, "HeadPart item is not a string"));
+    CHECK(hasWarning(data, "BodyMorphs: value for key 'Breasts' is not a number"));
+    CHECK(hasWarning(data, "Morphs/Presets: failed to parse ID 'zz'"));
+    CHECK(hasWarning(data, "Morphs/Regions: array for region ID '5' too small (size: 3)"));
+    CHECK(hasWarning(data, "Overlay template value missing or not a string"));
+    CHECK(hasWarning(data, "Overlay offsetUV array has more than 2 elements"));
+    CHECK(hasWarning(data, "Tint value for key '1B6E' is not an object"));
+    CHECK(hasWarning(data, "Tint Type for key '2C' is not a number"));
+    CHECK(hasWarning(data, "TintOrder: failed to parse ID 'nothex'"));
+    CHECK(hasWarning(data, "Weight value is not a number"));
+}
+
+TEST_CASE(ConditionsOnlyPresetIsEmpty)
+{
+    const auto data = parseSample("ConditionsOnly.json");
+    CHECK(data.empty);
+    CHECK(data.warnings.empty());
+    CHECK(data.gender == 1);
+    CHECK(data.headParts.has_value());
+    CHECK(data.headParts->empty());
+    CHECK(data.conditions.has_value());
+    CHECK(!data.hasMorphs);
+    CHECK(!data.overlays.has_value());
+    CHECK(!data.tints.has_value());
+    CHECK(!data.weight.has_value());
+}
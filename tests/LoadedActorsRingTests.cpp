@@ -0,0 +1,321 @@
+#include "Check.h"
+#include "ActorsManager/Details/LoadedActorsRing.hpp"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    /**
+     * @brief Часы, которые двигает только тест.
+     */
+    struct FakeClock
+    {
+        using rep = int64_t;
+        using period = std::micro;
+        using duration = std::chrono::duration<rep, period>;
+        using time_point = std::chrono::time_point<FakeClock>;
+        static constexpr bool is_steady = true;
+
+        static inline time_point current{};
+
+        static time_point now() noexcept { return current; }
+        static void advance(duration d) noexcept { current += d; }
+    };
+
+    using Ring = LoadedActorsRing<FakeClock>;
+}
+
+TEST_CASE(EntryExpiresAfterTtl)
+{
+    Ring ring{ 1s };
+    ring.insert(0x100, 60s);
+    CHECK(ring.contains(0x100));
+
+    FakeClock::advance(59s);
+    CHECK(ring.contains(0x100));
+
+    FakeClock::advance(1s);
+    CHECK(!ring.contains(0x100));
+}
+
+TEST_CASE(SameDeadlineExpiresAsOneSlot)
+{
+    Ring ring{ 1s };
+    // Нагрузка при быстром перемещении: сотни актёров с одним сроком попадают в один слот кольца
+    for (uint32_t id = 1; id <= 500; ++id) {
+        ring.insert(id, 60s);
+    }
+    CHECK(ring.size() == 500);
+
+    FakeClock::advance(60s);
+    // Старение выполняется записью: один проход по слоту удаляет все истёкшие записи
+    ring.insert(0x9999, 60s);
+    CHECK(ring.size() == 1);
+    CHECK(!ring.contains(1));
+    CHECK(!ring.contains(500));
+}
+
+TEST_CASE(ClearCancelsPendingExpiries)
+{
+    // Так LoadedActorsMap сбрасывается на загрузку сохранения и откат сериализации
+    Ring ring{ 1s };
+    for (uint32_t id = 1; id <= 10; ++id) {
+        ring.insert(id, 60s);
+    }
+    ring.insert(0x500);
+    ring.clear();
+    CHECK(ring.size() == 0);
+    CHECK(!ring.contains(1));
+    CHECK(!ring.contains(0x500));
+
+    // Слоты кольца очищены: новая запись после отката не удаляется старыми сроками
+    ring.insert(3, 120s);
+    FakeClock::advance(61s);
+    ring.insert(4, 60s);
+    CHECK(ring.contains(3));
+}
+
+TEST_CASE(ReinsertExtendsExpiry)
+{
+    Ring ring{ 1s };
+    ring.insert(0x100, 60s);
+    FakeClock::advance(50s);
+    // Актёр снова загрузился: срок отсчитывается заново, старый слот кольца его не удалит
+    ring.insert(0x100, 60s);
+
+    FakeClock::advance(10s);
+    ring.insert(0x200, 60s);
+    CHECK(ring.contains(0x100));
+
+    FakeClock::advance(49s);
+    ring.insert(0x200, 60s);
+    CHECK(ring.contains(0x100));
+
+    FakeClock::advance(1s);
+    CHECK(!ring.contains(0x100));
+    ring.insert(0x300, 60s);
+    CHECK(ring.size() == 2);
+}
+
+TEST_CASE(ShorterReinsertShortensExpiry)
+{
+    Ring ring{ 1s };
+    ring.insert(0x100, 60s);
+    ring.insert(0x100, 5s);
+    FakeClock::advance(5s);
+    CHECK(!ring.contains(0x100));
+}
+
+TEST_CASE(TtlIsRoundedUpAndClamped)
+{
+    Ring ring{ 1s };
+    // Меньше поколения - одно поколение
+    ring.insert(1, 1ms);
+    CHECK(ring.contains(1));
+    ring.insert(2, 1500ms);
+
+    FakeClock::advance(1s);
+    CHECK(!ring.contains(1));
+    CHECK(ring.contains(2));
+    FakeClock::advance(1s);
+    CHECK(!ring.contains(2));
+
+    // Срок длиннее кольца обрезается до 127 поколений
+    ring.insert(3, 1h);
+    FakeClock::advance(126s);
+    CHECK(ring.contains(3));
+    FakeClock::advance(1s);
+    CHECK(!ring.contains(3));
+}
+
+TEST_CASE(PinnedAndErasedEntries)
+{
+    Ring ring{ 1s };
+    ring.insert(1);
+    ring.insert(2, 60s);
+    CHECK(ring.erase(2));
+    CHECK(!ring.erase(2));
+    CHECK(!ring.contains(2));
+
+    // Устаревший id удалённой записи в слоте кольца не трогает новую запись того же актёра
+    FakeClock::advance(30s);
+    ring.insert(2, 60s);
+    FakeClock::advance(30s);
+    ring.insert(3, 60s);
+    CHECK(ring.contains(2));
+
+    // Запись без срока не стареет
+    FakeClock::advance(10min);
+    ring.insert(4, 60s);
+    CHECK(ring.contains(1));
+    CHECK(!ring.contains(2));
+    CHECK(ring.size() == 2);
+}
+
+TEST_CASE(LongIdleAgesOutEverySlotOnce)
+{
+    Ring ring{ 1s };
+    for (uint32_t id = 1; id <= 127; ++id) {
+        ring.insert(id, std::chrono::seconds(id));
+        FakeClock::advance(1s);
+    }
+    CHECK(ring.size() <= 127);
+
+    // Простой дольше кольца: одна запись проходит каждый слот один раз и удаляет всё истёкшее
+    FakeClock::advance(1h);
+    ring.insert(0x1000, 60s);
+    CHECK(ring.size() == 1);
+}
+
+namespace
+{
+    /**
+     * @brief Прежний LoadedActorsMap: multimap по итерации загрузки с линейным поиском в equal_range.
+     * Истечение вместо спящих потоков делает очередь сроков бенчмарка, логирование не учитывается.
+     */
+    class MultimapLoadedActors
+    {
+    public:
+        void insert(uint32_t id)
+        {
+            std::lock_guard lock(m_mutex);
+            m_actors.insert(std::make_pair(m_iteration, id));
+        }
+
+        bool contains(uint32_t id)
+        {
+            std::lock_guard lock(m_mutex);
+            auto range = m_actors.equal_range(m_iteration);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == id) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool erase(uint32_t id)
+        {
+            std::lock_guard lock(m_mutex);
+            auto range = m_actors.equal_range(m_iteration);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == id) {
+                    m_actors.erase(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::multimap<uint32_t, uint32_t> m_actors;
+        std::shared_mutex m_mutex;
+        uint32_t m_iteration{ 0 };
+    };
+}
+
+BENCHMARK(ChurnTenThousandLoadsPerSecond)
+{
+    // 10k событий загрузки в секунду поддельных часов по пулу актёров. Срок короче игровых 60 секунд, чтобы записи
+    // истекали и вставлялись заново в течение замера, а прежний вариант с линейным поиском укладывался в секунды
+    constexpr uint32_t eventsPerSecond = 10'000;
+    constexpr uint32_t pool = 2'000;
+    constexpr int seconds = 30;
+    constexpr int ttlSeconds = 5;
+    constexpr auto ttl = std::chrono::seconds(ttlSeconds);
+
+    std::vector<uint32_t> events(eventsPerSecond * seconds);
+    std::mt19937 rng(3);
+    for (auto& id : events) {
+        id = 0x01000000 + rng() % pool;
+    }
+
+    Ring ring{ 1s };
+    size_t ringInserted = 0;
+    const double ringUs = test::measure(1, [&] {
+        for (int second = 0; second < seconds; ++second) {
+            for (uint32_t i = 0; i < eventsPerSecond; ++i) {
+                const uint32_t id = events[second * eventsPerSecond + i];
+                if (!ring.contains(id)) {
+                    ring.insert(id, ttl);
+                    ++ringInserted;
+                }
+            }
+            FakeClock::advance(1s);
+        }
+    });
+
+    MultimapLoadedActors multimap;
+    std::deque<std::pair<int, uint32_t>> deadlines;
+    size_t multimapInserted = 0;
+    const double multimapUs = test::measure(1, [&] {
+        for (int second = 0; second < seconds; ++second) {
+            while (!deadlines.empty() && deadlines.front().first <= second) {
+                multimap.erase(deadlines.front().second);
+                deadlines.pop_front();
+            }
+            for (uint32_t i = 0; i < eventsPerSecond; ++i) {
+                const uint32_t id = events[second * eventsPerSecond + i];
+                if (!multimap.contains(id)) {
+                    multimap.insert(id);
+                    deadlines.emplace_back(second + ttlSeconds, id);
+                    ++multimapInserted;
+                }
+            }
+        }
+    });
+
+    CHECK(ringInserted == multimapInserted);
+    std::printf("%u loads/s over %u actors for %d s: ring %.0f us (%.1f us per simulated second), multimap %.0f us (%.1f us per simulated second), %zu inserts each\n",
+        eventsPerSecond, pool, seconds, ringUs, ringUs / seconds, multimapUs, multimapUs / seconds, ringInserted);
+}
+
+BENCHMARK(BurstExpiryVersusThreadPerActor)
+{
+    constexpr uint32_t actors = 500;
+
+    // Кольцо: вставка всплеска и его старение через 60 секунд поддельных часов
+    Ring ring{ 1s };
+    const double ringUs = test::measure(1, [&] {
+        for (uint32_t id = 0; id < actors; ++id) {
+            ring.insert(id, 60s);
+        }
+        FakeClock::advance(60s);
+        ring.insert(actors, 60s);
+    });
+
+    // Прежний способ: спящий поток на каждого актёра. Потоки ждут сигнала вместо 60 секунд
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool release = false;
+    std::vector<std::thread> threads;
+    threads.reserve(actors);
+    const double threadsUs = test::measure(1, [&] {
+        for (uint32_t id = 0; id < actors; ++id) {
+            threads.emplace_back([&] {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [&] { return release; });
+            });
+        }
+    });
+    {
+        std::lock_guard lock(mutex);
+        release = true;
+    }
+    cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::printf("%u actors: ring insert + age-out %.0f us, thread per actor start %.0f us (%u threads alive at once)\n",
+        actors, ringUs, threadsUs, actors);
+}
@@ -0,0 +1,354 @@
+#include "Check.h"
+#include "Validate/MaterialValidityCache.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    utils::Executor& pool()
+    {
+        static utils::Executor instance{ 4 };
+        return instance;
+    }
+
+    /**
+     * @brief Временное дерево Data: materials/ для отдельных файлов, overlays/ для overlays.json и файл кэша.
+     * Удаляется в деструкторе.
+     */
+    struct TempData
+    {
+        fs::path root;
+
+        TempData()
+        {
+            static int counter = 0;
+            root = fs::temp_directory_path() / ("dbr-material-cache-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-" + std::to_string(counter++));
+            fs::remove_all(root);
+            fs::create_directories(materials());
+            fs::create_directories(root / "overlays");
+        }
+
+        ~TempData()
+        {
+            std::error_code ec;
+            fs::remove_all(root, ec);
+        }
+
+        fs::path materials() const { return root / "materials"; }
+        fs::path cache() const { return root / "materials.cache"; }
+
+        void write(const fs::path& path, const std::string& content) const
+        {
+            fs::create_directories(path.parent_path());
+            std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+        }
+
+        void addMaterial(const std::string& key) const { write(materials() / key, "bgsm"); }
+
+        fs::path addSource(const std::string& name, const std::string& content) const
+        {
+            const auto path = root / "overlays" / name / "overlays.json";
+            write(path, content);
+            return path;
+        }
+    };
+
+    /**
+     * @brief Архивы вместо BSA: множество ключей и журнал запросов.
+     */
+    struct FakeArchives
+    {
+        std::set<std::string> contents;
+        std::vector<std::vector<std::string>> requests;
+
+        auto fn()
+        {
+            return [this](const std::vector<std::string>& batch) {
+                requests.push_back(batch);
+                std::vector<uint8_t> found;
+                for (const auto& key : batch) {
+                    found.push_back(contents.contains(key) ? 1 : 0);
+                }
+                return found;
+            };
+        }
+    };
+
+    bool equal(const MaterialValidityCache::Stats& stats, size_t cached, size_t loose, size_t archived, size_t missing)
+    {
+        return stats.cached == cached && stats.loose == loose && stats.archived == archived && stats.missing == missing;
+    }
+}
+
+TEST_CASE(NormalizeFoldsCaseSlashesAndPrefix)
+{
+    CHECK(MaterialValidityCache::normalize("Materials\\Actors\\Skin.BGSM") == "actors/skin.bgsm");
+    CHECK(MaterialValidityCache::normalize("//materials/a/b.bgsm") == "a/b.bgsm");
+    CHECK(MaterialValidityCache::normalize("overlays/x.bgsm") == "overlays/x.bgsm");
+    CHECK(MaterialValidityCache::normalize("///").empty());
+    CHECK(MaterialValidityCache::normalize("").empty());
+}
+
+TEST_CASE(ResolveSplitsLooseArchivedAndMissing)
+{
+    TempData data;
+    data.addMaterial("loose/a.bgsm");
+    data.addMaterial("loose/b.bgsm");
+    FakeArchives archives;
+    archives.contents = { "bsa/c.bgsm", "loose/a.bgsm" };
+
+    MaterialValidityCache cache(data.cache());
+    MaterialValidityCache::Stats stats;
+    const std::vector<std::string> materials{ "loose/a.bgsm", "loose/b.bgsm", "bsa/c.bgsm", "none/d.bgsm" };
+    const auto found = cache.resolve(materials, {}, data.materials(), pool(), 4, archives.fn(), &stats);
+
+    CHECK(found.size() == 4);
+    CHECK(found.at("loose/a.bgsm") && found.at("loose/b.bgsm") && found.at("bsa/c.bgsm"));
+    CHECK(!found.at("none/d.bgsm"));
+    CHECK(equal(stats, 0, 2, 1, 1));
+    // В архивы уходят одним пакетом только не найденные отдельными файлами
+    REQUIRE(archives.requests.size() == 1);
+    CHECK((std::set<std::string>(archives.requests[0].begin(), archives.requests[0].end()) == std::set<std::string>{ "bsa/c.bgsm", "none/d.bgsm" }));
+    CHECK(cache.size() == 3);
+}
+
+TEST_CASE(FoundMaterialsSurviveSessionsMissingOnesAreRechecked)
+{
+    TempData data;
+    data.addMaterial("a.bgsm");
+    const auto source = data.addSource("Mod", R"({"a":"a.bgsm"})");
+    FakeArchives archives;
+    archives.contents = { "b.bgsm" };
+    const std::vector<std::string> materials{ "a.bgsm", "b.bgsm", "c.bgsm" };
+
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(!cache.touchSource(source));
+        MaterialValidityCache::Stats stats;
+        cache.resolve(materials, {}, data.materials(), pool(), 2, archives.fn(), &stats);
+        CHECK(equal(stats, 0, 1, 1, 1));
+        CHECK(cache.save());
+    }
+    CHECK(fs::exists(data.cache()));
+    CHECK(!fs::exists(data.cache().string() + ".tmp"));
+
+    // Новая сессия: найденные берутся из кэша даже после удаления файла, отсутствующий проверяется снова
+    fs::remove(data.materials() / "a.bgsm");
+    archives.requests.clear();
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(cache.size() == 2);
+        CHECK(cache.touchSource(source));
+        MaterialValidityCache::Stats stats;
+        const auto found = cache.resolve(materials, {}, data.materials(), pool(), 2, archives.fn(), &stats);
+        CHECK(equal(stats, 2, 0, 0, 1));
+        CHECK(found.at("a.bgsm") && found.at("b.bgsm") && !found.at("c.bgsm"));
+        REQUIRE(archives.requests.size() == 1);
+        CHECK((archives.requests[0] == std::vector<std::string>{ "c.bgsm" }));
+    }
+
+    // Доустановленный материал виден сразу
+    data.addMaterial("c.bgsm");
+    {
+        MaterialValidityCache cache(data.cache());
+        MaterialValidityCache::Stats stats;
+        const auto found = cache.resolve(materials, {}, data.materials(), pool(), 2, archives.fn(), &stats);
+        CHECK(equal(stats, 2, 1, 0, 0));
+        CHECK(found.at("c.bgsm"));
+    }
+}
+
+TEST_CASE(ChangedSourceForcesRecheckOfItsMaterials)
+{
+    TempData data;
+    data.addMaterial("a.bgsm");
+    data.addMaterial("b.bgsm");
+    const auto source = data.addSource("Mod", R"({"a":"a.bgsm"})");
+    FakeArchives archives;
+    const std::vector<std::string> materials{ "a.bgsm", "b.bgsm" };
+
+    {
+        MaterialValidityCache cache(data.cache());
+        cache.touchSource(source);
+        cache.resolve(materials, {}, data.materials(), pool(), 2, archives.fn());
+        CHECK(cache.save());
+    }
+
+    // overlays.json поменял размер: его материалы проверяются заново, удалённый материал пропадает из кэша
+    data.write(source, R"({"a":"a.bgsm","extra":1})");
+    fs::remove(data.materials() / "a.bgsm");
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(!cache.touchSource(source));
+        MaterialValidityCache::Stats stats;
+        const auto found = cache.resolve(materials, { "a.bgsm" }, data.materials(), pool(), 2, archives.fn(), &stats);
+        CHECK(equal(stats, 1, 0, 0, 1));
+        CHECK(!found.at("a.bgsm") && found.at("b.bgsm"));
+        CHECK(cache.size() == 1);
+        CHECK(cache.save());
+    }
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(cache.touchSource(source));
+        CHECK(cache.size() == 1);
+    }
+}
+
+TEST_CASE(ModifiedTimeAloneInvalidatesSource)
+{
+    TempData data;
+    const auto source = data.addSource("Mod", "0123456789");
+    {
+        MaterialValidityCache cache(data.cache());
+        cache.touchSource(source);
+        CHECK(cache.save());
+    }
+
+    // Тот же размер, другое время изменения
+    fs::last_write_time(source, fs::last_write_time(source) + std::chrono::seconds(5));
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(!cache.touchSource(source));
+        CHECK(cache.touchSource(source));
+    }
+}
+
+TEST_CASE(SaveKeepsOnlyWhatThisSessionUsed)
+{
+    TempData data;
+    for (const char* key : { "a.bgsm", "b.bgsm", "c.bgsm" }) {
+        data.addMaterial(key);
+    }
+    const auto first = data.addSource("First", "1");
+    const auto second = data.addSource("Second", "2");
+    FakeArchives archives;
+
+    {
+        MaterialValidityCache cache(data.cache());
+        cache.touchSource(first);
+        cache.touchSource(second);
+        cache.resolve({ "a.bgsm", "b.bgsm", "c.bgsm" }, {}, data.materials(), pool(), 2, archives.fn());
+        CHECK(cache.save());
+    }
+
+    // Мод удалён: второго источника и материала c в этой сессии нет
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(cache.touchSource(first));
+        cache.resolve({ "a.bgsm", "b.bgsm" }, {}, data.materials(), pool(), 2, archives.fn());
+        CHECK(cache.save());
+        CHECK(cache.size() == 2);
+    }
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(cache.size() == 2);
+        CHECK(!cache.touchSource(second));
+    }
+}
+
+TEST_CASE(SaveWithoutChangesDoesNotRewrite)
+{
+    TempData data;
+    data.addMaterial("a.bgsm");
+    const auto source = data.addSource("Mod", "1");
+    FakeArchives archives;
+    {
+        MaterialValidityCache cache(data.cache());
+        cache.touchSource(source);
+        cache.resolve({ "a.bgsm" }, {}, data.materials(), pool(), 1, archives.fn());
+        CHECK(cache.save());
+    }
+
+    const auto before = fs::last_write_time(data.cache());
+    fs::last_write_time(data.cache(), before - std::chrono::hours(1));
+    const auto marked = fs::last_write_time(data.cache());
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(cache.touchSource(source));
+        cache.resolve({ "a.bgsm" }, {}, data.materials(), pool(), 1, archives.fn());
+        CHECK(cache.save());
+    }
+    CHECK(fs::last_write_time(data.cache()) == marked);
+}
+
+TEST_CASE(CorruptOrForeignCacheIsIgnored)
+{
+    TempData data;
+    data.addMaterial("a.bgsm");
+    FakeArchives archives;
+    {
+        MaterialValidityCache cache(data.cache());
+        cache.resolve({ "a.bgsm" }, {}, data.materials(), pool(), 1, archives.fn());
+        CHECK(cache.save());
+    }
+
+    std::string bytes;
+    {
+        std::ifstream in(data.cache(), std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    REQUIRE(bytes.size() > 12);
+
+    // Каждый обрезанный вариант, кроме полного, отбрасывается целиком
+    for (size_t length = 0; length < bytes.size(); ++length) {
+        data.write(data.cache(), bytes.substr(0, length));
+        MaterialValidityCache cache(data.cache());
+        CHECK(cache.size() == 0);
+    }
+
+    auto foreign = bytes;
+    foreign[4] = static_cast<char>(foreign[4] + 1); // версия
+    data.write(data.cache(), foreign);
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(cache.size() == 0);
+        // Отброшенный кэш перезаписывается при следующем сохранении
+        cache.resolve({ "a.bgsm" }, {}, data.materials(), pool(), 1, archives.fn());
+        CHECK(cache.save());
+    }
+    {
+        MaterialValidityCache cache(data.cache());
+        CHECK(cache.size() == 1);
+    }
+}
+
+TEST_CASE(SaveFailsWhenCacheFolderIsMissing)
+{
+    TempData data;
+    data.addMaterial("a.bgsm");
+    FakeArchives archives;
+    MaterialValidityCache cache(data.root / "no-such-dir" / "materials.cache");
+    cache.resolve({ "a.bgsm" }, {}, data.materials(), pool(), 1, archives.fn());
+    CHECK(!cache.save());
+}
+
+TEST_CASE(ManyMaterialsAcrossWorkers)
+{
+    TempData data;
+    FakeArchives archives;
+    std::vector<std::string> materials;
+    for (int i = 0; i < 2000; ++i) {
+        const auto key = "set" + std::to_string(i % 17) + "/m" + std::to_string(i) + ".bgsm";
+        materials.push_back(key);
+        if (i % 3 == 0) {
+            data.addMaterial(key);
+        }
+        else if (i % 3 == 1) {
+            archives.contents.insert(key);
+        }
+    }
+
+    MaterialValidityCache cache(data.cache());
+    MaterialValidityCache::Stats stats;
+    const auto found = cache.resolve(materials, {}, data.materials(), pool(), 8, archives.fn(), &stats);
+    CHECK(equal(stats, 0, 667, 667, 666));
+    for (int i = 0; i < 2000; ++i) {
+        CHECK(found.at(materials[i]) == (i % 3 != 2));
+    }
+}
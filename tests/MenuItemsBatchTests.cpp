@@ -0,0 +1,96 @@
+#include "Check.h"
+#include "DirectApply/MenuItemsBatch.hpp"
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace
+{
+    struct Item
+    {
+        int type;
+        std::string label;
+        int state;
+        bool hasState;
+    };
+
+    /**
+     * @brief Приёмник вместо GFx: значения - дерево из int, строк и массивов, вызовы записываются.
+     */
+    struct FakeSink
+    {
+        struct Value
+        {
+            std::variant<int, std::string, std::vector<Value>> data;
+        };
+
+        struct Call
+        {
+            std::string method;
+            Value argument;
+        };
+
+        bool hasBatchMethod = true;
+        std::vector<Call> calls;
+
+        Value makeArray() { return Value{ std::vector<Value>{} }; }
+        void append(Value& array, int value) { std::get<2>(array.data).push_back(Value{ value }); }
+        void append(Value& array, const char* value) { std::get<2>(array.data).push_back(Value{ std::string{ value } }); }
+        void append(Value& array, const Value& value) { std::get<2>(array.data).push_back(value); }
+
+        bool invoke(const char* method, Value& argument)
+        {
+            if (!hasBatchMethod) {
+                return false;
+            }
+            calls.push_back({ method, argument });
+            return true;
+        }
+
+        bool invoke(const char* method, int type, const char* label, int state)
+        {
+            Value args = makeArray();
+            append(args, type);
+            append(args, label);
+            append(args, state);
+            calls.push_back({ method, args });
+            return true;
+        }
+    };
+
+    const std::vector<Item> items{ { 0, "Header", 0, false }, { 2, "Checkbox", 1, true }, { 1, "Button", 0, false } };
+
+    bool elementIs(const FakeSink::Value& element, int type, const std::string& label, int state)
+    {
+        const auto& fields = std::get<2>(element.data);
+        return fields.size() == 3 && std::get<0>(fields[0].data) == type && std::get<1>(fields[1].data) == label
+            && std::get<0>(fields[2].data) == state;
+    }
+}
+
+TEST_CASE(ItemsGoOutInOneBatchCall)
+{
+    FakeSink sink;
+    CHECK(menuBatch::pushItemsOrEach(sink, "root.pushArray", "root.push", items));
+    REQUIRE(sink.calls.size() == 1);
+    CHECK(sink.calls[0].method == "root.pushArray");
+    const auto& array = std::get<2>(sink.calls[0].argument.data);
+    REQUIRE(array.size() == 3);
+    CHECK(elementIs(array[0], 0, "Header", 0));
+    CHECK(elementIs(array[1], 2, "Checkbox", 1));
+    CHECK(elementIs(array[2], 1, "Button", 0));
+}
+
+TEST_CASE(OldSwfWithoutBatchMethodGetsItemsOneByOne)
+{
+    FakeSink sink;
+    sink.hasBatchMethod = false;
+    CHECK(menuBatch::pushItemsOrEach(sink, "root.pushArray", "root.push", items));
+    REQUIRE(sink.calls.size() == 3);
+    for (const auto& call : sink.calls) {
+        CHECK(call.method == "root.push");
+    }
+    CHECK(elementIs(sink.calls[0].argument, 0, "Header", 0));
+    CHECK(elementIs(sink.calls[1].argument, 2, "Checkbox", 1));
+    CHECK(elementIs(sink.calls[2].argument, 1, "Button", 0));
+}
@@ -0,0 +1,330 @@
+#include "Check.h"
+#include "Preset/Details/MorphBatch.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Строка из общего пула, как RE::BSFixedString: одинаковые имена - один и тот же указатель.
+     * Построение берёт блокировку и ищет имя в хеш-таблице пула, как в игре.
+     */
+    class PooledName
+    {
+    public:
+        PooledName(const char* name) :
+            m_data(intern(name)) {}
+
+        const char* data() const noexcept { return m_data; }
+
+    private:
+        static const char* intern(const char* name)
+        {
+            static std::unordered_map<std::string, std::unique_ptr<std::string>> pool;
+            static std::mutex mutex;
+            std::lock_guard lock(mutex);
+            auto& slot = pool[name];
+            if (!slot) {
+                slot = std::make_unique<std::string>(name);
+            }
+            return slot->c_str();
+        }
+
+        const char* m_data;
+    };
+
+    /**
+     * @brief Подделка BodyMorphInterface из LooksMenu: морфы по (актёр, пол, имя, ключевое слово) и журнал вызовов.
+     */
+    struct MockBodyMorphInterface
+    {
+        struct Call
+        {
+            std::string name;
+            float value;
+        };
+
+        std::map<std::tuple<uint32_t, bool, const char*, const void*>, float> morphs;
+        std::vector<Call> sets;
+        size_t gets{ 0 };
+        bool journal{ true }; ///< Записывать ли вызовы SetMorph в sets. В замерах выключен.
+
+        float GetMorph(uint32_t actor, bool isFemale, const PooledName& name, const void* keyword)
+        {
+            ++gets;
+            auto it = morphs.find({ actor, isFemale, name.data(), keyword });
+            return it != morphs.end() ? it->second : 0.0f;
+        }
+
+        void SetMorph(uint32_t actor, bool isFemale, const PooledName& name, const void* keyword, float value)
+        {
+            if (journal) {
+                sets.push_back({ name.data(), value });
+            }
+            morphs[{ actor, isFemale, name.data(), keyword }] = value;
+        }
+
+        void RemoveMorphsByKeyword(uint32_t actor, bool isFemale, const void* keyword)
+        {
+            std::erase_if(morphs, [&](const auto& item) {
+                return std::get<0>(item.first) == actor && std::get<1>(item.first) == isFemale && std::get<3>(item.first) == keyword;
+            });
+        }
+
+        /**
+         * @brief Ненулевые морфы актёра с ключевым словом, как их видит игра.
+         */
+        std::map<std::string, float> visible(uint32_t actor, bool isFemale, const void* keyword) const
+        {
+            std::map<std::string, float> result;
+            for (const auto& [key, value] : morphs) {
+                if (std::get<0>(key) == actor && std::get<1>(key) == isFemale && std::get<3>(key) == keyword && value != 0.0f) {
+                    result.emplace(std::get<2>(key), value);
+                }
+            }
+            return result;
+        }
+    };
+
+    using Morphs = MorphList<PooledName>;
+
+    // Ключевые слова различаются только адресом, как указатели на BGSKeyword
+    int diversedKeyword = 0;
+    int otherKeyword = 0;
+
+    /**
+     * @brief Применение пресета так же, как BodymorphsPreset::apply: без предыдущего пресета - снять всё и выставить,
+     * с предыдущим - обнулить лишние и выставить изменившиеся.
+     */
+    struct Applier
+    {
+        MockBodyMorphInterface& bodyMorphs;
+        uint32_t actor;
+        bool isFemale;
+
+        void apply(const Morphs& morphs, const Morphs* previous)
+        {
+            auto getMorph = [&](const PooledName& name) { return bodyMorphs.GetMorph(actor, isFemale, name, &diversedKeyword); };
+            auto setMorph = [&](const PooledName& name, float value) { bodyMorphs.SetMorph(actor, isFemale, name, &diversedKeyword, value); };
+            if (!previous) {
+                bodyMorphs.RemoveMorphsByKeyword(actor, isFemale, &diversedKeyword);
+            }
+            else {
+                clearStaleMorphs(morphs, *previous, [](const PooledName& name) { return name.data(); }, setMorph);
+            }
+            setMorphs(morphs, previous != nullptr, getMorph, setMorph);
+        }
+    };
+
+    std::map<std::string, float> asMap(const Morphs& morphs)
+    {
+        std::map<std::string, float> result;
+        for (const auto& morph : morphs) {
+            if (morph.value != 0.0f) {
+                result.emplace(morph.name.data(), morph.value);
+            }
+        }
+        return result;
+    }
+}
+
+TEST_CASE(InternKeepsOrderAndFirstOfDuplicates)
+{
+    const std::vector<std::pair<std::string, double>> sliders{ { "Breasts", 0.5 }, { "Waist", -0.25 }, { "Breasts", 1.0 }, { "Butt", 0.75 } };
+    const auto morphs = internMorphs<PooledName>(sliders);
+    REQUIRE(morphs.size() == 3);
+    CHECK(std::string{ morphs[0].name.data() } == "Breasts" && morphs[0].value == 0.5f);
+    CHECK(std::string{ morphs[1].name.data() } == "Waist" && morphs[1].value == -0.25f);
+    CHECK(std::string{ morphs[2].name.data() } == "Butt" && morphs[2].value == 0.75f);
+
+    // Имена из пула: тот же указатель для того же имени в другом пресете
+    const auto other = internMorphs<PooledName>(std::map<std::string, float>{ { "Butt", 0.1f } });
+    REQUIRE(other.size() == 1);
+    CHECK(other[0].name.data() == morphs[2].name.data());
+
+    CHECK(internMorphs<PooledName>(std::vector<std::pair<std::string, float>>{}).empty());
+}
+
+TEST_CASE(FullApplySetsEveryMorph)
+{
+    MockBodyMorphInterface bodyMorphs;
+    Applier applier{ bodyMorphs, 0x14, true };
+    const auto morphs = internMorphs<PooledName>(std::vector<std::pair<std::string, float>>{ { "A", 0.1f }, { "B", 0.0f }, { "C", 0.3f } });
+
+    applier.apply(morphs, nullptr);
+    CHECK(bodyMorphs.gets == 0);
+    REQUIRE(bodyMorphs.sets.size() == 3);
+    CHECK(bodyMorphs.sets[0].name == "A" && bodyMorphs.sets[1].name == "B" && bodyMorphs.sets[2].name == "C");
+    CHECK(bodyMorphs.visible(0x14, true, &diversedKeyword) == asMap(morphs));
+}
+
+TEST_CASE(IncrementalApplySkipsUnchangedValues)
+{
+    MockBodyMorphInterface bodyMorphs;
+    Applier applier{ bodyMorphs, 0x14, true };
+    const auto first = internMorphs<PooledName>(std::vector<std::pair<std::string, float>>{ { "A", 0.1f }, { "B", 0.2f }, { "C", 0.3f } });
+    applier.apply(first, nullptr);
+    bodyMorphs.sets.clear();
+
+    // Те же значения после разбора слайдеров (35/100 против 0.35) и одно изменившееся
+    const auto second = internMorphs<PooledName>(std::vector<std::pair<std::string, float>>{
+        { "A", 10 / 100.0f }, { "B", 0.2f + 1e-6f }, { "C", 0.5f } });
+    applier.apply(second, &first);
+    CHECK(bodyMorphs.gets == 3);
+    REQUIRE(bodyMorphs.sets.size() == 1);
+    CHECK(bodyMorphs.sets[0].name == "C" && bodyMorphs.sets[0].value == 0.5f);
+    // B остался со старым значением в пределах допуска
+    CHECK((bodyMorphs.visible(0x14, true, &diversedKeyword) == std::map<std::string, float>{ { "A", 0.1f }, { "B", 0.2f }, { "C", 0.5f } }));
+}
+
+TEST_CASE(PresetSwapZeroesMorphsMissingFromNewPreset)
+{
+    MockBodyMorphInterface bodyMorphs;
+    Applier applier{ bodyMorphs, 0x14, false };
+    const auto first = internMorphs<PooledName>(std::vector<std::pair<std::string, float>>{ { "A", 0.1f }, { "B", 0.2f }, { "C", 0.3f } });
+    const auto second = internMorphs<PooledName>(std::vector<std::pair<std::string, float>>{ { "B", 0.2f }, { "D", 0.4f } });
+    applier.apply(first, nullptr);
+    bodyMorphs.sets.clear();
+
+    applier.apply(second, &first);
+    // A и C обнулены, B не тронут, D выставлен
+    std::map<std::string, float> calls;
+    for (const auto& call : bodyMorphs.sets) {
+        calls.emplace(call.name, call.value);
+    }
+    CHECK(bodyMorphs.sets.size() == 3);
+    CHECK((calls == std::map<std::string, float>{ { "A", 0.0f }, { "C", 0.0f }, { "D", 0.4f } }));
+    CHECK(bodyMorphs.visible(0x14, false, &diversedKeyword) == asMap(second));
+
+    // Обратно: пустой новый пресет обнуляет всё
+    bodyMorphs.sets.clear();
+    const Morphs empty;
+    applier.apply(empty, &second);
+    CHECK(bodyMorphs.sets.size() == 2);
+    CHECK(bodyMorphs.visible(0x14, false, &diversedKeyword).empty());
+}
+
+TEST_CASE(OtherActorsSexesAndKeywordsAreUntouched)
+{
+    MockBodyMorphInterface bodyMorphs;
+    const auto foreign = PooledName("A");
+    bodyMorphs.SetMorph(0x14, true, foreign, &otherKeyword, 0.9f);
+    bodyMorphs.SetMorph(0x14, false, foreign, &diversedKeyword, 0.8f);
+    bodyMorphs.SetMorph(0x15, true, foreign, &diversedKeyword, 0.7f);
+
+    Applier applier{ bodyMorphs, 0x14, true };
+    const auto first = internMorphs<PooledName>(std::vector<std::pair<std::string, float>>{ { "A", 0.1f } });
+    const auto second = internMorphs<PooledName>(std::vector<std::pair<std::string, float>>{ { "B", 0.2f } });
+    applier.apply(first, nullptr);
+    applier.apply(second, &first);
+
+    CHECK(bodyMorphs.visible(0x14, true, &otherKeyword) == (std::map<std::string, float>{ { "A", 0.9f } }));
+    CHECK(bodyMorphs.visible(0x14, false, &diversedKeyword) == (std::map<std::string, float>{ { "A", 0.8f } }));
+    CHECK(bodyMorphs.visible(0x15, true, &diversedKeyword) == (std::map<std::string, float>{ { "A", 0.7f } }));
+    CHECK(bodyMorphs.visible(0x14, true, &diversedKeyword) == (std::map<std::string, float>{ { "B", 0.2f } }));
+}
+
+TEST_CASE(IncrementalMatchesFullApplyOnRandomSwaps)
+{
+    // Цепочка замен пресетов: инкрементальный путь должен давать то же состояние, что снятие всего и полное применение
+    std::vector<Morphs> presets;
+    for (int p = 0; p < 8; ++p) {
+        std::vector<std::pair<std::string, float>> sliders;
+        for (int m = 0; m < 40; ++m) {
+            if ((m * 7 + p * 3) % 5 != 0) {
+                // Большинство значений общие для всех пресетов, каждый четвёртый морф свой у пресета
+                sliders.emplace_back("Morph" + std::to_string(m), static_cast<float>(m * 13 % 7) / 10.0f + (m % 4 == p % 4 ? 0.05f * static_cast<float>(p + 1) : 0.0f));
+            }
+        }
+        presets.push_back(internMorphs<PooledName>(sliders));
+    }
+
+    MockBodyMorphInterface incremental;
+    MockBodyMorphInterface full;
+    Applier incrementalApplier{ incremental, 0x20, true };
+    Applier fullApplier{ full, 0x20, true };
+    incrementalApplier.apply(presets[0], nullptr);
+    fullApplier.apply(presets[0], nullptr);
+
+    size_t incrementalSets = 0;
+    size_t fullSets = 0;
+    for (size_t step = 1; step < 30; ++step) {
+        const auto& previous = presets[(step - 1) * 5 % presets.size()];
+        const auto& current = presets[step * 5 % presets.size()];
+        incremental.sets.clear();
+        full.sets.clear();
+        incrementalApplier.apply(current, &previous);
+        fullApplier.apply(current, nullptr);
+        incrementalSets += incremental.sets.size();
+        fullSets += full.sets.size();
+        CHECK(incremental.visible(0x20, true, &diversedKeyword) == full.visible(0x20, true, &diversedKeyword));
+        CHECK(incremental.visible(0x20, true, &diversedKeyword) == asMap(current));
+    }
+    CHECK(incrementalSets < fullSets);
+}
+
+BENCHMARK(OldMapPathVersusInternedAndIncremental)
+{
+    constexpr int morphCount = 120;
+    constexpr size_t iterations = 20000;
+
+    std::unordered_map<std::string, float> oldMorphs;
+    std::vector<std::pair<std::string, float>> sliders;
+    for (int m = 0; m < morphCount; ++m) {
+        const float value = static_cast<float>(m % 11) / 10.0f;
+        oldMorphs.emplace("Morph" + std::to_string(m), value);
+        sliders.emplace_back("Morph" + std::to_string(m), value);
+    }
+    const auto interned = internMorphs<PooledName>(sliders);
+
+    MockBodyMorphInterface bodyMorphs;
+    bodyMorphs.journal = false;
+    // Как LooksMenuInterfaces::GetInterface: доступ к общему реестру интерфейсов под блокировкой
+    std::mutex registryMutex;
+    auto getInterface = [&]() {
+        std::lock_guard lock(registryMutex);
+        return &bodyMorphs;
+    };
+    constexpr uint32_t actor = 0x14;
+    constexpr bool isFemale = true;
+
+    // Прежний BodymorphsPreset::apply: снять все морфы, затем на каждый морф новый интерфейс и новое имя из пула
+    const double oldUs = test::measure(iterations, [&] {
+        getInterface()->RemoveMorphsByKeyword(actor, isFemale, &diversedKeyword);
+        for (const auto& [name, value] : oldMorphs) {
+            getInterface()->SetMorph(actor, isFemale, PooledName(name.c_str()), &diversedKeyword, value);
+        }
+    });
+
+    // Имена интернированы при загрузке, интерфейс берётся один раз на актёра
+    const double internedUs = test::measure(iterations, [&] {
+        auto iface = getInterface();
+        iface->RemoveMorphsByKeyword(actor, isFemale, &diversedKeyword);
+        setMorphs(interned, false,
+            [&](const PooledName& name) { return iface->GetMorph(actor, isFemale, name, &diversedKeyword); },
+            [&](const PooledName& name, float value) { iface->SetMorph(actor, isFemale, name, &diversedKeyword, value); });
+    });
+
+    // replace() тем же набором значений: без снятия морфов, SetMorph только для изменившихся
+    size_t incrementalSets = 0;
+    const double incrementalUs = test::measure(iterations, [&] {
+        auto iface = getInterface();
+        auto setMorph = [&](const PooledName& name, float value) { iface->SetMorph(actor, isFemale, name, &diversedKeyword, value); };
+        incrementalSets += clearStaleMorphs(interned, interned, [](const PooledName& name) { return name.data(); }, setMorph);
+        incrementalSets += setMorphs(interned, true,
+            [&](const PooledName& name) { return iface->GetMorph(actor, isFemale, name, &diversedKeyword); }, setMorph);
+    });
+
+    CHECK(incrementalSets == 0);
+    CHECK(bodyMorphs.visible(actor, isFemale, &diversedKeyword) == asMap(interned));
+    std::printf("%d morphs per apply: map + name and interface per morph %.2f us, interned %.2f us, incremental unchanged %.2f us\n",
+        morphCount, oldUs, internedUs, incrementalUs);
+}
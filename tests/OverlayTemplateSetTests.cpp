@@ -0,0 +1,133 @@
+#include "Check.h"
+#include "Preset/Details/OverlayTemplateSet.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Поддельный OverlayInterface: оверлеи одного актёра с uid и именем шаблона.
+     */
+    class FakeOverlayInterface
+    {
+    public:
+        struct OverlayData
+        {
+            uint32_t uid;
+            std::shared_ptr<std::string> templateName;
+        };
+        using OverlayDataPtr = std::shared_ptr<OverlayData>;
+
+        void add(uint32_t uid, std::string templateName)
+        {
+            m_overlays.push_back(std::make_shared<OverlayData>(OverlayData{ uid, std::make_shared<std::string>(std::move(templateName)) }));
+        }
+
+        template <class Fn>
+        void ForEachOverlay(Fn&& fn) const
+        {
+            for (const auto& overlay : m_overlays) {
+                fn(static_cast<int32_t>(overlay->uid), overlay);
+            }
+        }
+
+    private:
+        std::vector<OverlayDataPtr> m_overlays;
+    };
+
+    /**
+     * @brief Прежний findOverlaysUid: каждое имя шаблона сравнивается strcmp со всеми id пресета, id копируются.
+     */
+    std::vector<uint32_t> findByScan(const FakeOverlayInterface& overlays, const std::vector<std::string>& overlayIds)
+    {
+        std::vector<uint32_t> result{};
+        overlays.ForEachOverlay([&result, &overlayIds](int32_t, const FakeOverlayInterface::OverlayDataPtr& overlay) {
+            if (overlay && overlay->templateName) {
+                for (auto overlayId : overlayIds) {
+                    if (std::strcmp(overlay->templateName->c_str(), overlayId.c_str()) == 0) {
+                        result.push_back(overlay->uid);
+                    }
+                }
+            }
+        });
+        return result;
+    }
+
+    /**
+     * @brief Нынешний findOverlaysUid: один проход с поиском имени в OverlayTemplateSet.
+     */
+    std::vector<uint32_t> findBySet(const FakeOverlayInterface& overlays, const OverlayTemplateSet& overlayIds)
+    {
+        std::vector<uint32_t> result{};
+        overlays.ForEachOverlay([&result, &overlayIds](int32_t, const FakeOverlayInterface::OverlayDataPtr& overlay) {
+            if (overlay && overlay->templateName && overlayIds.find(std::string_view{ overlay->templateName->c_str() }) != overlayIds.end()) {
+                result.push_back(overlay->uid);
+            }
+        });
+        return result;
+    }
+
+    /**
+     * @brief Актёр с overlays оверлеями, часть которых из пресета с templates шаблонами.
+     */
+    void makeActor(size_t overlays, size_t templates, FakeOverlayInterface& actor, std::vector<std::string>& presetIds)
+    {
+        std::mt19937 rng(7);
+        for (size_t i = 0; i < templates; ++i) {
+            presetIds.push_back("DBR_BodyHair_Template_" + std::to_string(i));
+        }
+        for (uint32_t uid = 1; uid <= overlays; ++uid) {
+            // Треть оверлеев от пресета, остальные от других модов с похожими именами
+            actor.add(uid, rng() % 3 == 0 ? presetIds[rng() % templates] : "Other_Tattoo_Template_" + std::to_string(rng() % 500));
+        }
+    }
+}
+
+TEST_CASE(SetLookupMatchesStrcmpScan)
+{
+    FakeOverlayInterface actor;
+    std::vector<std::string> presetIds;
+    makeActor(200, 50, actor, presetIds);
+    const OverlayTemplateSet templates(presetIds.begin(), presetIds.end());
+
+    const auto expected = findByScan(actor, presetIds);
+    CHECK(!expected.empty());
+    CHECK(findBySet(actor, templates) == expected);
+
+    // Поиск по string_view и const char* без создания std::string, регистр различается как у strcmp
+    CHECK(templates.find(std::string_view{ "DBR_BodyHair_Template_3" }) != templates.end());
+    CHECK(templates.find("DBR_BodyHair_Template_49") != templates.end());
+    CHECK(templates.find("dbr_bodyhair_template_3") == templates.end());
+    CHECK(templates.find(std::string_view{ "DBR_BodyHair_Template_3x", 23 }) != templates.end());
+}
+
+TEST_CASE(SharedSetPublishesSnapshots)
+{
+    SharedOverlayTemplateSet shared{ std::make_shared<const OverlayTemplateSet>() };
+    const auto before = shared.load();
+    shared.store(std::make_shared<const OverlayTemplateSet>(OverlayTemplateSet{ "A", "B" }));
+
+    // Снимок, взятый до публикации, не меняется
+    CHECK(before->empty());
+    CHECK(shared.load()->size() == 2);
+    CHECK(shared.load()->contains("B"));
+}
+
+BENCHMARK(FindOverlaysUid200Overlays50Templates)
+{
+    FakeOverlayInterface actor;
+    std::vector<std::string> presetIds;
+    makeActor(200, 50, actor, presetIds);
+    const OverlayTemplateSet templates(presetIds.begin(), presetIds.end());
+
+    size_t found = 0;
+    const double scanUs = test::measure(2000, [&] { found += findByScan(actor, presetIds).size(); });
+    const double setUs = test::measure(2000, [&] { found += findBySet(actor, templates).size(); });
+    std::printf("200 overlays x 50 templates: strcmp scan %.1f us/call, hash set single pass %.1f us/call (%zu)\n",
+        scanUs, setUs, found);
+}
@@ -0,0 +1,240 @@
+#include "Check.h"
+#include "Preset/Preset.h"
+#include "Utils/ParallelFor.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    /**
+     * @brief Пресет с путём файла, из которого он загружен: по нему видно, какой из одинаковых пресетов остался.
+     */
+    class FilePreset : public Preset
+    {
+    public:
+        FilePreset(PresetType type, std::string id, fs::path path) :
+            Preset(type, std::move(id)), m_path(std::move(path)) {}
+
+        const fs::path& path() const noexcept { return m_path; }
+
+    private:
+        fs::path m_path;
+    };
+
+    struct PresetPtrLess
+    {
+        bool operator()(const std::shared_ptr<Preset>& a, const std::shared_ptr<Preset>& b) const
+        {
+            if (a->type() != b->type()) return a->type() < b->type();
+            return a->id() < b->id();
+        }
+    };
+
+    using Presets = std::set<std::shared_ptr<Preset>, PresetPtrLess>;
+
+    /**
+     * @brief План загрузки как в PresetsManager: файлы по папкам в порядке обхода.
+     */
+    struct Plan
+    {
+        std::vector<fs::path> folders;
+        std::vector<std::pair<fs::path, size_t>> sources;
+    };
+
+    /**
+     * @brief Временные папки пресетов: в каждом файле тип и id, часть id повторяется между папками,
+     * часть файлов пустые. Удаляется в деструкторе.
+     */
+    struct TempPresets
+    {
+        fs::path root;
+        Plan plan;
+
+        TempPresets(size_t folders, size_t files)
+        {
+            static int counter = 0;
+            root = fs::temp_directory_path() / ("dbr-parallel-load-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-" + std::to_string(counter++));
+            fs::remove_all(root);
+
+            std::mt19937 rng(13);
+            const char* types[] = { "BodyMorphs", "BodyHairs", "BodyTattoos" };
+            for (size_t folder = 0; folder < folders; ++folder) {
+                const auto path = root / ("Folder" + std::to_string(folder));
+                fs::create_directories(path);
+                plan.folders.push_back(path);
+                for (size_t file = 0; file < files; ++file) {
+                    const auto filePath = path / ("Preset" + std::to_string(file) + ".json");
+                    std::ofstream out(filePath, std::ios::binary);
+                    if (rng() % 15 != 0) {
+                        out << types[folder % std::size(types)] << ' ' << "Preset" << rng() % (files * 2);
+                        // Разный размер файлов, чтобы потоки заканчивали не по порядку
+                        out << ' ' << std::string(rng() % 20000, 'x');
+                    }
+                    plan.sources.emplace_back(filePath, folder);
+                }
+            }
+            // Папка без пресетов
+            fs::create_directories(root / "Empty");
+            plan.folders.push_back(root / "Empty");
+        }
+
+        ~TempPresets()
+        {
+            std::error_code ec;
+            fs::remove_all(root, ec);
+        }
+    };
+
+    std::shared_ptr<Preset> load(const fs::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::string type, id;
+        if (!(file >> type >> id)) {
+            return nullptr;
+        }
+        return std::make_shared<FilePreset>(GetPresetTypeFromString(type), id, path);
+    }
+
+    /**
+     * @brief Слияние, как в PresetsManager::loadCollectedPresets: пресеты в множество, итог по папкам в лог.
+     */
+    struct Merger
+    {
+        const Plan& plan;
+        Presets presets{};
+        std::vector<std::string> log{};
+        std::vector<int> counts = std::vector<int>(plan.folders.size(), 0);
+        size_t folder{ 0 };
+
+        void finishFolders(size_t end)
+        {
+            for (; folder < end; ++folder) {
+                log.push_back((counts[folder] ? "loaded " + std::to_string(counts[folder]) + " from " : "none in ") + plan.folders[folder].string());
+            }
+        }
+
+        void operator()(size_t i, std::shared_ptr<Preset>&& preset)
+        {
+            const auto& [path, sourceFolder] = plan.sources[i];
+            finishFolders(sourceFolder);
+            if (preset) {
+                ++counts[sourceFolder];
+                presets.insert(std::move(preset));
+            }
+            else {
+                log.push_back("failed " + path.string());
+            }
+        }
+    };
+
+    std::vector<std::string> describe(const Presets& presets)
+    {
+        std::vector<std::string> result;
+        for (const auto& preset : presets) {
+            result.push_back(GetPresetTypeString(preset->type()) + "/" + preset->id() + " <- " + static_cast<const FilePreset&>(*preset).path().string());
+        }
+        return result;
+    }
+}
+
+TEST_CASE(ParallelLoadMatchesSerialLoad)
+{
+    const TempPresets data(6, 120);
+    const auto& plan = data.plan;
+
+    Merger serial{ plan };
+    for (size_t i = 0; i < plan.sources.size(); ++i) {
+        serial(i, load(plan.sources[i].first));
+    }
+    serial.finishFolders(plan.folders.size());
+    REQUIRE(serial.presets.size() > 200);
+    REQUIRE(serial.presets.size() < plan.sources.size());
+
+    utils::Executor executor{ 4 };
+    for (int run = 0; run < 10; ++run) {
+        Merger parallel{ plan };
+        utils::parallelLoadOrdered(executor, plan.sources.size(), 8,
+            [&plan](size_t i) { return load(plan.sources[i].first); },
+            std::ref(parallel));
+        parallel.finishFolders(plan.folders.size());
+
+        CHECK(describe(parallel.presets) == describe(serial.presets));
+        CHECK(parallel.log == serial.log);
+    }
+}
+
+TEST_CASE(MergeRunsInIndexOrderOnCallingThread)
+{
+    utils::Executor executor{ 4 };
+    const auto caller = std::this_thread::get_id();
+    std::vector<size_t> order;
+    bool sameThread = true;
+    utils::parallelLoadOrdered(executor, 1000, 8,
+        [](size_t i) { return std::to_string(i * 3); },
+        [&](size_t i, std::string&& value) {
+            sameThread = sameThread && std::this_thread::get_id() == caller;
+            CHECK(value == std::to_string(i * 3));
+            order.push_back(i);
+        });
+    CHECK(sameThread);
+    REQUIRE(order.size() == 1000);
+    for (size_t i = 0; i < order.size(); ++i) {
+        CHECK(order[i] == i);
+    }
+}
+
+TEST_CASE(LoadExceptionSkipsMerge)
+{
+    utils::Executor executor{ 2 };
+    int merged = 0;
+    bool thrown = false;
+    try {
+        utils::parallelLoadOrdered(executor, 100, 4,
+            [](size_t i) -> int {
+                if (i == 57) throw std::runtime_error("broken preset");
+                return static_cast<int>(i);
+            },
+            [&merged](size_t, int&&) { ++merged; });
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(merged == 0);
+}
+
+BENCHMARK(LoadSixFoldersSerialVersusParallel)
+{
+    const TempPresets data(6, 400);
+    const auto& plan = data.plan;
+    utils::Executor executor{ utils::defaultWorkers() };
+
+    size_t sink = 0;
+    const double serialUs = test::measure(5, [&] {
+        Merger merger{ plan };
+        for (size_t i = 0; i < plan.sources.size(); ++i) {
+            merger(i, load(plan.sources[i].first));
+        }
+        sink += merger.presets.size();
+    });
+    const double parallelUs = test::measure(5, [&] {
+        Merger merger{ plan };
+        utils::parallelLoadOrdered(executor, plan.sources.size(), utils::defaultWorkers(),
+            [&plan](size_t i) { return load(plan.sources[i].first); }, std::ref(merger));
+        sink += merger.presets.size();
+    });
+    std::printf("2400 preset files: serial %.0f us, parallel (%zu workers) %.0f us (%zu)\n",
+        serialUs, utils::defaultWorkers(), parallelUs, sink);
+}
@@ -0,0 +1,207 @@
+#include "Check.h"
+#include "DirectApply/PresetListModel.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    std::string lowerAscii(std::string_view text)
+    {
+        std::string result(text);
+        std::transform(result.begin(), result.end(), result.begin(), [](char c) {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        });
+        return result;
+    }
+
+    /**
+     * @brief Прежний фильтр меню: копия имени в нижнем регистре и find на каждый пресет.
+     */
+    std::vector<size_t> naiveFilter(const std::vector<std::string>& names, std::string_view query, PresetListModel::Match match)
+    {
+        const auto needle = lowerAscii(query);
+        std::vector<size_t> result;
+        for (size_t i = 0; i < names.size(); ++i) {
+            const auto pos = lowerAscii(names[i]).find(needle);
+            if (match == PresetListModel::Match::Contains ? pos != std::string::npos : pos == 0) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    std::vector<size_t> visible(const PresetListModel& model)
+    {
+        std::vector<size_t> result;
+        for (size_t i = 0; i < model.size(); ++i) {
+            result.push_back(model.sourceIndex(i));
+        }
+        return result;
+    }
+
+    std::vector<std::string> makeNames(size_t count, uint32_t seed)
+    {
+        static constexpr std::string_view parts[] = { "Athletic", "Curvy", "Slim", "BODY", "Raider", "Settler",
+            "Gunner", "muscle", "Ghoul", "Vault", "Синт", "Heavy", "tall", "Short" };
+        std::mt19937 rng(seed);
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            std::string name;
+            for (size_t p = 0, n = 1 + rng() % 3; p < n; ++p) {
+                name += parts[rng() % std::size(parts)];
+                name += rng() % 2 ? "_" : " ";
+            }
+            name += std::to_string(i);
+            names.push_back(std::move(name));
+        }
+        return names;
+    }
+
+    PresetListModel makeModel(const std::vector<std::string>& names)
+    {
+        PresetListModel model;
+        model.assign(names, [](const std::string& name) { return std::string_view{ name }; });
+        return model;
+    }
+}
+
+TEST_CASE(FilterMatchesNaiveLowercaseFind)
+{
+    const auto names = makeNames(3000, 5);
+    auto model = makeModel(names);
+    CHECK(model.total() == names.size());
+    CHECK(model.size() == names.size());
+
+    for (const char* query : { "body", "BODY", "Slim_", "raider settler", "r", "1", "99", "Синт", "zzz", "_ghoul_1" }) {
+        for (auto match : { PresetListModel::Match::Contains, PresetListModel::Match::Prefix }) {
+            model.setFilter(query, match);
+            CHECK(visible(model) == naiveFilter(names, query, match));
+            for (size_t i = 0; i < model.size(); ++i) {
+                CHECK(model.name(i) == names[model.sourceIndex(i)]);
+            }
+        }
+    }
+
+    // Пустой запрос и запрос с '\0' сбрасывают фильтр
+    model.setFilter("");
+    CHECK(model.size() == names.size());
+    model.setFilter(std::string_view{ "a\0b", 3 });
+    CHECK(model.size() == names.size());
+    CHECK(model.query().empty());
+}
+
+TEST_CASE(MatchDoesNotCrossNameBoundary)
+{
+    const std::vector<std::string> names{ "abc", "def", "", "cd" };
+    auto model = makeModel(names);
+
+    model.setFilter("cd");
+    CHECK((visible(model) == std::vector<size_t>{ 3 }));
+
+    // Несколько совпадений в одном имени дают одну запись
+    model.setFilter("c");
+    CHECK((visible(model) == std::vector<size_t>{ 0, 3 }));
+
+    model.setFilter("D", PresetListModel::Match::Prefix);
+    CHECK((visible(model) == std::vector<size_t>{ 1 }));
+    CHECK(model.query() == "d");
+}
+
+TEST_CASE(PagingClampsToSelection)
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < 25; ++i) {
+        names.push_back("Preset" + std::to_string(i));
+    }
+    auto model = makeModel(names);
+
+    auto page = model.page(0, 10);
+    CHECK(page.count == 3);
+    CHECK(page.index == 0);
+    CHECK(page.offset == 0);
+    CHECK(page.names.size() == 10);
+    CHECK(page.names.front() == "Preset0");
+
+    page = model.page(2, 10);
+    CHECK(page.offset == 20);
+    CHECK(page.names.size() == 5);
+    CHECK(page.names.back() == "Preset24");
+
+    // Номер за концом приводится к последней странице
+    page = model.page(100, 10);
+    CHECK(page.index == 2);
+    CHECK(page.names.size() == 5);
+
+    // Нулевой размер страницы считается единицей
+    page = model.page(3, 0);
+    CHECK(page.count == 25);
+    CHECK(page.names.size() == 1);
+    CHECK(page.names.front() == "Preset3");
+
+    CHECK(model.window(24, 10).size() == 1);
+    CHECK(model.window(25, 10).empty());
+    CHECK(model.window(0, 0).empty());
+
+    // Пустая выборка: одна пустая страница
+    model.setFilter("nothing");
+    page = model.page(5, 10);
+    CHECK(page.count == 1);
+    CHECK(page.index == 0);
+    CHECK(page.names.empty());
+
+    // Страница берётся из отфильтрованной выборки
+    model.setFilter("preset2");
+    page = model.page(0, 4);
+    CHECK(page.count == 2);
+    CHECK(page.names.front() == "Preset2");
+    CHECK(model.page(1, 4).names.back() == "Preset24");
+}
+
+TEST_CASE(InitialsAreSortedPrintableAscii)
+{
+    const std::vector<std::string> names{ "beta", "Alpha", "alpine", "", "Zed", "9lives", ",comma", " space", "Ёж", "_under" };
+    auto model = makeModel(names);
+    CHECK((model.initials() == std::vector<char>{ '9', '_', 'a', 'b', 'z' }));
+
+    // Фильтр не влияет на варианты
+    model.setFilter("beta");
+    CHECK(model.initials().size() == 5);
+
+    // Каждый вариант как Match::Prefix даёт непустую выборку
+    for (char c : model.initials()) {
+        model.setFilter(std::string_view{ &c, 1 }, PresetListModel::Match::Prefix);
+        CHECK(!model.empty());
+    }
+}
+
+BENCHMARK(FilterTenThousandNames)
+{
+    const auto names = makeNames(10'000, 17);
+    PresetListModel model;
+    const double assignUs = test::measure(20, [&] {
+        model.assign(names, [](const std::string& name) { return std::string_view{ name }; });
+    });
+
+    const char* queries[] = { "b", "bo", "body", "slim_raider", "1234", "zzz" };
+    for (const char* query : queries) {
+        size_t hits = 0;
+        const double modelUs = test::measure(200, [&] {
+            model.setFilter(query);
+            hits = model.size();
+        });
+        const double naiveUs = test::measure(200, [&] {
+            hits = naiveFilter(names, query, PresetListModel::Match::Contains).size();
+        });
+        const double pageUs = test::measure(2000, [&] {
+            hits += model.page(3, 50).names.size();
+        });
+        std::printf("10k names, query \"%s\": model %.1f us, naive lowercase+find %.1f us, page of 50 %.2f us\n",
+            query, modelUs, naiveUs, pageUs);
+    }
+    std::printf("assign 10k names %.1f us\n", assignUs);
+}
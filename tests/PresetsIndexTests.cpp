@@ -0,0 +1,150 @@
+#include "Check.h"
+#include "PresetsManager/Details/PresetsIndex.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Порядок m_presets: по типу, затем по id, как Preset::operator<.
+     */
+    struct PresetPtrLess
+    {
+        bool operator()(const std::shared_ptr<Preset>& a, const std::shared_ptr<Preset>& b) const
+        {
+            if (a->type() != b->type()) return a->type() < b->type();
+            return a->id() < b->id();
+        }
+    };
+
+    using Presets = std::set<std::shared_ptr<Preset>, PresetPtrLess>;
+
+    /**
+     * @brief Прежний getPreset: перебор всего множества с find_if.
+     */
+    std::shared_ptr<Preset> findByScan(const Presets& presets, const std::string& id)
+    {
+        auto it = std::find_if(presets.begin(), presets.end(), [&id](const std::shared_ptr<Preset>& preset) {
+            return preset && preset->id() == id;
+        });
+        return it != presets.end() ? *it : nullptr;
+    }
+
+    constexpr PresetType types[] = { PresetType::BODYMORPHS, PresetType::BODYHAIRS, PresetType::HEAD, PresetType::BODYTATTOOS, PresetType::NAILS };
+
+    /**
+     * @brief count пресетов с именами, как у файлов пресетов; часть id повторяется в разных типах.
+     */
+    Presets makePresets(size_t count)
+    {
+        std::mt19937 rng(17);
+        Presets presets;
+        while (presets.size() < count) {
+            const auto type = types[rng() % std::size(types)];
+            presets.insert(std::make_shared<Preset>(type, "DBR_" + std::string(GetPresetTypeString(type)) + "_" + std::to_string(rng() % count)));
+            if (rng() % 10 == 0) {
+                presets.insert(std::make_shared<Preset>(types[rng() % std::size(types)], "Shared_" + std::to_string(rng() % 50)));
+            }
+        }
+        return presets;
+    }
+
+    /**
+     * @brief id, запрашиваемые при чтении косейва: сохранённые пресеты актёров и немного удалённых.
+     */
+    std::vector<std::string> makeQueries(const Presets& presets, size_t count)
+    {
+        std::vector<std::string> ids;
+        for (const auto& preset : presets) {
+            ids.push_back(preset->id());
+        }
+        std::mt19937 rng(29);
+        std::vector<std::string> queries;
+        for (size_t i = 0; i < count; ++i) {
+            queries.push_back(rng() % 20 == 0 ? "Removed_" + std::to_string(i) : ids[rng() % ids.size()]);
+        }
+        return queries;
+    }
+}
+
+TEST_CASE(IndexMatchesScan)
+{
+    const auto presets = makePresets(2000);
+    PresetsIndex index;
+    index.rebuild(presets);
+    CHECK(index.size() == presets.size());
+
+    for (const auto& id : makeQueries(presets, 5000)) {
+        CHECK(index.find(id) == findByScan(presets, id));
+    }
+    for (const auto& preset : presets) {
+        CHECK(index.find(preset->id(), preset->type()) == preset);
+    }
+}
+
+TEST_CASE(RepeatedIdResolvesToFirstType)
+{
+    Presets presets;
+    const auto head = std::make_shared<Preset>(PresetType::HEAD, "Athletic");
+    const auto morphs = std::make_shared<Preset>(PresetType::BODYMORPHS, "Athletic");
+    presets.insert(head);
+    presets.insert(morphs);
+
+    PresetsIndex index;
+    index.rebuild(presets);
+    CHECK(index.find("Athletic") == morphs);
+    CHECK(index.find("Athletic") == findByScan(presets, "Athletic"));
+    CHECK(index.find("Athletic", PresetType::HEAD) == head);
+    CHECK(index.find("Athletic", PresetType::NAILS) == nullptr);
+    CHECK(index.find("Athletic", PresetType::END) == nullptr);
+    CHECK(index.find("athletic") == nullptr);
+}
+
+TEST_CASE(RebuildDropsRemovedPresets)
+{
+    Presets presets;
+    presets.insert(std::make_shared<Preset>(PresetType::NAILS, "Red"));
+    presets.insert(std::make_shared<Preset>(PresetType::NAILS, "Black"));
+    PresetsIndex index;
+    index.rebuild(presets);
+    CHECK(index.find("Red") != nullptr);
+
+    // Валидация заменяет множество отфильтрованным
+    presets.erase(presets.begin());
+    index.rebuild(presets);
+    CHECK(index.size() == 1);
+    CHECK(index.find("Black") == nullptr);
+    CHECK(index.find("Red", PresetType::NAILS) != nullptr);
+}
+
+BENCHMARK(LookupVersusScan2000Presets)
+{
+    const auto presets = makePresets(2000);
+    const auto queries = makeQueries(presets, 10000);
+    PresetsIndex index;
+    index.rebuild(presets);
+
+    size_t found = 0;
+    const double scanUs = test::measure(3, [&] {
+        for (const auto& id : queries) {
+            found += findByScan(presets, id) != nullptr;
+        }
+    });
+    const double indexUs = test::measure(3, [&] {
+        for (const auto& id : queries) {
+            found += index.find(id) != nullptr;
+        }
+    });
+    const double typedUs = test::measure(3, [&] {
+        for (const auto& preset : presets) {
+            found += index.find(preset->id(), preset->type()) != nullptr;
+        }
+    });
+    std::printf("2000 presets, 10000 lookups: find_if scan %.0f us, index by id %.0f us, index by id and type (2000) %.0f us (%zu)\n",
+        scanUs, indexUs, typedUs, found);
+}
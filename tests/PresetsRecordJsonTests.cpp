@@ -0,0 +1,318 @@
+#include "Check.h"
+#include "ActorsManager/Details/PresetsRecordJson.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#if __has_include(<boost/json/basic_parser_impl.hpp>)
+#include <boost/json/basic_parser_impl.hpp>
+#include <boost/json/src.hpp>
+#define DBR_TEST_BOOST_JSON 1
+#endif
+
+namespace
+{
+    using Record = std::map<uint32_t, std::vector<std::pair<uint8_t, std::string>>>;
+
+#ifdef DBR_TEST_BOOST_JSON
+    /**
+     * @brief Разбор тем же парсером, что и в ActorsManager::deserialize.
+     */
+    class JsonParser
+    {
+    public:
+        explicit JsonParser(PresetsRecord::ActorCallback onActor) :
+            m_parser(boost::json::parse_options{}, std::move(onActor)) {}
+
+        bool write(const char* data, size_t size)
+        {
+            boost::system::error_code ec;
+            return m_parser.write_some(true, data, size, ec) == size && !ec;
+        }
+
+        bool finish()
+        {
+            boost::system::error_code ec;
+            m_parser.write_some(false, nullptr, 0, ec);
+            return !ec && m_parser.done();
+        }
+
+        const PresetsRecord::LegacyJsonHandler& handler() const { return m_parser.handler(); }
+
+    private:
+        boost::json::basic_parser<PresetsRecord::LegacyJsonHandler> m_parser;
+    };
+#else
+    /**
+     * @brief Потоковый SAX разбор подмножества JSON старой записи (без escape-последовательностей, true/false/null
+     * и дробных чисел) на случай, когда boost::json недоступен. Выдаёт обработчику те же события, что и
+     * boost::json::basic_parser, включая on_key_part/on_string_part для строк, разрезанных границей порции.
+     */
+    class JsonParser
+    {
+    public:
+        explicit JsonParser(PresetsRecord::ActorCallback onActor) :
+            m_handler(std::move(onActor)) {}
+
+        bool write(const char* data, size_t size)
+        {
+            for (size_t i = 0; i < size && m_ok;) {
+                if (m_inString) {
+                    const auto* end = std::find(data + i, data + size, '"');
+                    const std::string_view piece(data + i, static_cast<size_t>(end - data - i));
+                    m_stringSize += piece.size();
+                    if (end == data + size) {
+                        if (!piece.empty()) {
+                            m_ok = m_isKey ? m_handler.on_key_part(piece, m_stringSize, m_ec) : m_handler.on_string_part(piece, m_stringSize, m_ec);
+                        }
+                        return m_ok;
+                    }
+                    m_ok = m_isKey ? m_handler.on_key(piece, m_stringSize, m_ec) : m_handler.on_string(piece, m_stringSize, m_ec);
+                    m_inString = false;
+                    i = static_cast<size_t>(end - data) + 1;
+                    continue;
+                }
+
+                const char c = data[i++];
+                if (c == '-' || (c >= '0' && c <= '9')) {
+                    m_number.push_back(c);
+                    continue;
+                }
+                m_ok = flushNumber();
+                switch (c) {
+                case '[':
+                    m_stack.push_back('[');
+                    m_ok = m_ok && m_handler.on_array_begin(m_ec);
+                    break;
+                case '{':
+                    m_stack.push_back('{');
+                    m_expectKey = true;
+                    m_ok = m_ok && m_handler.on_object_begin(m_ec);
+                    break;
+                case ']':
+                case '}':
+                    m_ok = m_ok && !m_stack.empty() && m_stack.back() == (c == ']' ? '[' : '{');
+                    if (m_ok) {
+                        m_stack.pop_back();
+                        m_ok = c == ']' ? m_handler.on_array_end(0, m_ec) : m_handler.on_object_end(0, m_ec);
+                    }
+                    break;
+                case ',':
+                    m_expectKey = !m_stack.empty() && m_stack.back() == '{';
+                    break;
+                case '"':
+                    m_inString = true;
+                    m_isKey = m_expectKey;
+                    m_expectKey = false;
+                    m_stringSize = 0;
+                    break;
+                case ':':
+                case ' ':
+                case '\n':
+                    break;
+                default:
+                    m_ok = false;
+                }
+            }
+            return m_ok;
+        }
+
+        bool finish()
+        {
+            return m_ok && flushNumber() && !m_inString && m_stack.empty();
+        }
+
+        const PresetsRecord::LegacyJsonHandler& handler() const { return m_handler; }
+
+    private:
+        struct ErrorCode
+        {
+        };
+
+        bool flushNumber()
+        {
+            if (m_number.empty()) {
+                return true;
+            }
+            const auto value = std::stoll(m_number);
+            m_number.clear();
+            return m_handler.on_int64(value, std::string_view{}, m_ec);
+        }
+
+        PresetsRecord::LegacyJsonHandler m_handler;
+        ErrorCode m_ec{};
+        std::vector<char> m_stack;
+        std::string m_number;
+        size_t m_stringSize{ 0 };
+        bool m_inString{ false };
+        bool m_isKey{ false };
+        bool m_expectKey{ false };
+        bool m_ok{ true };
+    };
+#endif
+
+    Record makeRecord(size_t actors, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        Record record;
+        for (size_t i = 0; i < actors; ++i) {
+            auto& presets = record[static_cast<uint32_t>(0x01000000 + i * 7)];
+            const size_t count = 1 + rng() % 5;
+            for (size_t p = 0; p < count; ++p) {
+                presets.emplace_back(static_cast<uint8_t>(p + 1), "Preset_" + std::to_string(rng() % 400));
+            }
+        }
+        return record;
+    }
+
+    /**
+     * @brief JSON актёра в том виде, в каком его писали старые версии плагина.
+     */
+    std::string actorJson(uint32_t formId, const std::vector<std::pair<uint8_t, std::string>>& presets)
+    {
+        std::string json = "{\"formid\":" + std::to_string(formId) + ",\"presets\":[";
+        for (size_t i = 0; i < presets.size(); ++i) {
+            json += (i ? ",{\"type\":" : "{\"type\":") + std::to_string(presets[i].first) + ",\"id\":\"" + presets[i].second + "\"}";
+        }
+        return json + "]}";
+    }
+
+    std::string toJson(const Record& record)
+    {
+        std::string json = "[";
+        for (const auto& [formId, presets] : record) {
+            if (json.size() > 1) {
+                json += ",";
+            }
+            json += actorJson(formId, presets);
+        }
+        return json + "]";
+    }
+
+    bool parse(std::string_view json, Record& out, size_t feedSize)
+    {
+        JsonParser parser([&out](uint32_t formId, std::span<const PresetsRecord::Entry> presets) {
+            auto& target = out[formId];
+            target.clear();
+            for (const auto& entry : presets) {
+                target.emplace_back(entry.type, std::string{ entry.id });
+            }
+        });
+        for (size_t pos = 0; pos < json.size(); pos += feedSize) {
+            if (!parser.write(json.data() + pos, std::min(feedSize, json.size() - pos))) {
+                return false;
+            }
+        }
+        return parser.finish();
+    }
+}
+
+TEST_CASE(JsonRecordRestoresEveryActor)
+{
+    const auto record = makeRecord(2000, 11);
+    const auto json = toJson(record);
+    for (size_t feed : { size_t{ 1 }, size_t{ 7 }, size_t{ 4096 }, json.size() }) {
+        Record parsed;
+        CHECK(parse(json, parsed, feed));
+        CHECK(parsed == record);
+    }
+}
+
+TEST_CASE(JsonSkipsEntriesTheDomParserSkipped)
+{
+    Record parsed;
+    // Корень не массив
+    CHECK(parse(R"({"formid": 1, "presets": [{"type": 1, "id": "A"}]})", parsed, 5));
+    CHECK(parsed.empty());
+
+    const std::string json = std::string("[")
+        + R"({"presets": [{"type": 1, "id": "NoFormId"}]},)"
+        + R"({"formid": 2, "presets": {"type": 1, "id": "NotArray"}},)"
+        + R"({"formid": 3},)"
+        + R"({"formid": 4, "extra": {"formid": 99, "presets": [{"type": 1, "id": "Nested"}]}, "presets": [)"
+        + R"({"type": 1, "id": "Kept"}, {"id": "NoType"}, {"type": 2}, {"type": 300, "id": "Wide"}, {"type": -1, "id": "Negative"}, [{"type": 1, "id": "InArray"}]]},)"
+        + R"({"presets": [{"id": "Late", "type": 3}], "formid": 5},)"
+        + R"(7])";
+    CHECK(parse(json, parsed, 3));
+    CHECK(parsed.size() == 2);
+    CHECK((parsed[4] == std::vector<std::pair<uint8_t, std::string>>{ { 1, "Kept" } }));
+    CHECK((parsed[5] == std::vector<std::pair<uint8_t, std::string>>{ { 3, "Late" } }));
+}
+
+TEST_CASE(LargeJsonRecordIsParsedWithBoundedMemory)
+{
+    // Миллион актёров по 3 пресета - больше 100 МБ текста, дерево документа заняло бы в разы больше
+    constexpr uint32_t actors = 1'000'000;
+    constexpr uint32_t strings = 500;
+    auto presetsOf = [](uint32_t i) {
+        std::vector<std::pair<uint8_t, std::string>> presets;
+        for (uint8_t p = 0; p < 3; ++p) {
+            presets.emplace_back(static_cast<uint8_t>(p + 1), "Preset_" + std::to_string((i * 31 + p) % strings));
+        }
+        return presets;
+    };
+
+    std::vector<uint8_t> compressed;
+    uint64_t rawSize = 0;
+    {
+        PresetsRecord::DeflateWriter writer([&compressed](const uint8_t* data, size_t size) {
+            compressed.insert(compressed.end(), data, data + size);
+            return true;
+        });
+        std::string buf = "[";
+        for (uint32_t i = 0; i < actors; ++i) {
+            if (i) {
+                buf += ",";
+            }
+            buf += actorJson(0x01000000 + i, presetsOf(i));
+            if (buf.size() >= 64 * 1024) {
+                writer.write(reinterpret_cast<const uint8_t*>(buf.data()), buf.size());
+                buf.clear();
+            }
+        }
+        buf += "]";
+        writer.write(reinterpret_cast<const uint8_t*>(buf.data()), buf.size());
+        REQUIRE(writer.finish());
+        rawSize = writer.totalIn();
+    }
+    CHECK(rawSize >= 100'000'000);
+
+    const long rssBefore = test::residentKb();
+    long rssPeak = rssBefore;
+
+    uint32_t parsed = 0;
+    bool ordered = true;
+    JsonParser parser([&](uint32_t formId, std::span<const PresetsRecord::Entry> presets) {
+        ordered = ordered && formId == 0x01000000 + parsed && presets.size() == 3
+            && presets[0].id == "Preset_" + std::to_string((parsed * 31) % strings);
+        if (++parsed % 100'000 == 0) {
+            rssPeak = std::max(rssPeak, test::residentKb());
+        }
+    });
+    PresetsRecord::InflateWriter inflater([&parser](const uint8_t* data, size_t size) {
+        return parser.write(reinterpret_cast<const char*>(data), size);
+    });
+
+    // Как в ActorsManager::deserialize: сжатые данные читаются кусками по 64 КБ
+    constexpr size_t readChunk = 64 * 1024;
+    for (size_t pos = 0; pos < compressed.size(); pos += readChunk) {
+        REQUIRE(inflater.write(compressed.data() + pos, std::min(readChunk, compressed.size() - pos)));
+    }
+    CHECK(inflater.finished());
+    CHECK(inflater.totalOut() == rawSize);
+    CHECK(parser.finish());
+    CHECK(parsed == actors);
+    CHECK(parser.handler().actorsCount() == actors);
+    CHECK(ordered);
+
+#if defined(__linux__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+    // Под санитайзерами освобождённая память копится в карантине, поэтому пик проверяется только в обычной сборке
+    const long growthKb = rssPeak - rssBefore;
+    std::printf("raw %llu bytes, compressed %zu bytes, RSS growth while parsing %ld KB\n",
+        static_cast<unsigned long long>(rawSize), compressed.size(), growthKb);
+    CHECK(growthKb < 8 * 1024);
+#endif
+}
@@ -0,0 +1,369 @@
+#include "Check.h"
+#include "ActorsManager/Details/PresetsRecord.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Record = std::map<uint32_t, std::vector<std::pair<uint8_t, std::string>>>;
+
+    Record makeRecord(size_t actors, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        Record record;
+        for (size_t i = 0; i < actors; ++i) {
+            auto& presets = record[static_cast<uint32_t>(0x01000000 + i * 7)];
+            const size_t count = 1 + rng() % 5;
+            for (size_t p = 0; p < count; ++p) {
+                presets.emplace_back(static_cast<uint8_t>(p + 1), "Preset_" + std::to_string(rng() % 400));
+            }
+        }
+        return record;
+    }
+
+    std::vector<uint8_t> encode(const Record& record, size_t chunkSize = 64 * 1024, size_t* encodedSize = nullptr)
+    {
+        PresetsRecord::Encoder encoder;
+        for (const auto& [formId, presets] : record) {
+            encoder.beginActor(formId);
+            for (const auto& [type, id] : presets) {
+                encoder.addPreset(type, id);
+            }
+        }
+        if (encodedSize) {
+            *encodedSize = static_cast<size_t>(encoder.size());
+        }
+        std::vector<uint8_t> bytes;
+        encoder.write([&bytes](const uint8_t* data, size_t size) {
+            bytes.insert(bytes.end(), data, data + size);
+            return true;
+        }, chunkSize);
+        return bytes;
+    }
+
+    bool decode(const std::vector<uint8_t>& bytes, Record& out, size_t feedSize)
+    {
+        PresetsRecord::Decoder decoder([&out](uint32_t formId, std::span<const PresetsRecord::Entry> presets) {
+            auto& target = out[formId];
+            for (const auto& entry : presets) {
+                target.emplace_back(entry.type, std::string{ entry.id });
+            }
+        });
+        for (size_t pos = 0; pos < bytes.size(); pos += feedSize) {
+            if (!decoder.feed(bytes.data() + pos, std::min(feedSize, bytes.size() - pos))) {
+                return false;
+            }
+        }
+        return decoder.finished();
+    }
+
+    std::vector<uint8_t> deflate(const std::vector<uint8_t>& bytes)
+    {
+        std::vector<uint8_t> compressed;
+        PresetsRecord::DeflateWriter writer([&compressed](const uint8_t* data, size_t size) {
+            compressed.insert(compressed.end(), data, data + size);
+            return true;
+        }, 4096);
+        writer.write(bytes.data(), bytes.size());
+        writer.finish();
+        return compressed;
+    }
+
+    template <class T>
+    void put(std::vector<uint8_t>& buf, T value)
+    {
+        uint8_t raw[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+        buf.insert(buf.end(), raw, raw + sizeof(T));
+    }
+
+    /**
+     * @brief Пишет в sink синтетическую запись из actors актёров по presetsPerActor пресетов,
+     * не собирая её в памяти целиком. Возвращает размер разжатого содержимого.
+     */
+    uint64_t streamSyntheticRecord(uint32_t actors, uint8_t presetsPerActor, uint32_t strings, const PresetsRecord::Sink& sink)
+    {
+        std::vector<uint8_t> buf;
+        uint64_t total = 0;
+        auto flush = [&] {
+            sink(buf.data(), buf.size());
+            total += buf.size();
+            buf.clear();
+        };
+
+        put<uint32_t>(buf, PresetsRecord::MAGIC);
+        put<uint16_t>(buf, PresetsRecord::FORMAT_VERSION);
+        put<uint16_t>(buf, 0);
+        put<uint32_t>(buf, strings);
+        for (uint32_t i = 0; i < strings; ++i) {
+            const auto id = "Preset_" + std::to_string(i);
+            put<uint16_t>(buf, static_cast<uint16_t>(id.size()));
+            buf.insert(buf.end(), id.begin(), id.end());
+        }
+        put<uint32_t>(buf, actors);
+        for (uint32_t i = 0; i < actors; ++i) {
+            put<uint32_t>(buf, 0x01000000 + i);
+            put<uint8_t>(buf, presetsPerActor);
+            for (uint8_t p = 0; p < presetsPerActor; ++p) {
+                put<uint8_t>(buf, static_cast<uint8_t>(p + 1));
+                put<uint32_t>(buf, (i * 31 + p) % strings);
+            }
+            if (buf.size() >= 64 * 1024) {
+                flush();
+            }
+        }
+        flush();
+        return total;
+    }
+}
+
+TEST_CASE(RoundTripMatchesInput)
+{
+    const auto record = makeRecord(2000, 1);
+    size_t predicted = 0;
+    const auto bytes = encode(record, 1000, &predicted);
+    CHECK(predicted == bytes.size());
+
+    for (size_t feed : { size_t{ 1 }, size_t{ 7 }, size_t{ 4096 }, bytes.size() }) {
+        Record decoded;
+        CHECK(decode(bytes, decoded, feed));
+        CHECK(decoded == record);
+    }
+}
+
+TEST_CASE(EmptyRecordRoundTrips)
+{
+    size_t predicted = 0;
+    const auto bytes = encode({}, 64, &predicted);
+    CHECK(predicted == bytes.size());
+    Record decoded;
+    CHECK(decode(bytes, decoded, 3));
+    CHECK(decoded.empty());
+}
+
+TEST_CASE(PresetIdsAreStoredOnce)
+{
+    Record record;
+    for (uint32_t i = 0; i < 100; ++i) {
+        record[i] = { { 1, "SharedPresetWithALongName" } };
+    }
+    const auto bytes = encode(record);
+    // Заголовок 8, таблица 4 + 2 + 25, актёры 4 + 100 * (4 + 1 + 1 + 4)
+    CHECK(bytes.size() == 8 + 4 + 2 + 25 + 4 + 100 * 10);
+}
+
+TEST_CASE(TooManyPresetsPerActorAreCapped)
+{
+    PresetsRecord::Encoder encoder;
+    encoder.beginActor(42);
+    for (int i = 0; i < 300; ++i) {
+        encoder.addPreset(1, "P" + std::to_string(i));
+    }
+    std::vector<uint8_t> bytes;
+    encoder.write([&bytes](const uint8_t* data, size_t size) {
+        bytes.insert(bytes.end(), data, data + size);
+        return true;
+    });
+    CHECK(encoder.size() == bytes.size());
+    Record decoded;
+    CHECK(decode(bytes, decoded, bytes.size()));
+    CHECK(decoded[42].size() == 255);
+}
+
+TEST_CASE(CorruptInputIsRejected)
+{
+    const auto record = makeRecord(50, 2);
+    const auto bytes = encode(record);
+    Record decoded;
+
+    auto badMagic = bytes;
+    badMagic[0] ^= 0xFF;
+    CHECK(!decode(badMagic, decoded, badMagic.size()));
+
+    auto badVersion = bytes;
+    badVersion[4] = 0x7F;
+    CHECK(!decode(badVersion, decoded, badVersion.size()));
+
+    auto truncated = bytes;
+    truncated.pop_back();
+    CHECK(!decode(truncated, decoded, 5));
+
+    auto trailing = bytes;
+    trailing.push_back(0);
+    CHECK(!decode(trailing, decoded, trailing.size()));
+}
+
+TEST_CASE(StringIndexOutOfRangeIsRejected)
+{
+    Record record{ { 1, { { 1, "A" } } } };
+    auto bytes = encode(record);
+    // Последние 4 байта - индекс строки единственного пресета
+    bytes[bytes.size() - 4] = 5;
+    Record decoded;
+    CHECK(!decode(bytes, decoded, bytes.size()));
+}
+
+TEST_CASE(DeflateRoundTrip)
+{
+    const auto record = makeRecord(3000, 3);
+    const auto bytes = encode(record);
+    const auto compressed = deflate(bytes);
+    CHECK(compressed.size() < bytes.size());
+
+    std::vector<uint8_t> restored;
+    PresetsRecord::InflateWriter inflater([&restored](const uint8_t* data, size_t size) {
+        restored.insert(restored.end(), data, data + size);
+        return true;
+    }, UINT32_MAX, 1024);
+    CHECK(inflater.write(compressed.data(), compressed.size()));
+    CHECK(inflater.finished());
+    CHECK(inflater.totalOut() == bytes.size());
+    CHECK(restored == bytes);
+}
+
+TEST_CASE(LargeRecordIsDecodedWithBoundedMemory)
+{
+    // 2.5 млн актёров по 3 пресета - 50 МБ разжатого содержимого
+    constexpr uint32_t actors = 2'500'000;
+    constexpr uint8_t presetsPerActor = 3;
+    constexpr uint32_t strings = 500;
+
+    std::vector<uint8_t> compressed;
+    PresetsRecord::DeflateWriter writer([&compressed](const uint8_t* data, size_t size) {
+        compressed.insert(compressed.end(), data, data + size);
+        return true;
+    });
+    const auto rawSize = streamSyntheticRecord(actors, presetsPerActor, strings, [&writer](const uint8_t* data, size_t size) {
+        return writer.write(data, size);
+    });
+    REQUIRE(writer.finish());
+    CHECK(rawSize >= 50'000'000);
+    CHECK(writer.totalIn() == rawSize);
+
+    const long rssBefore = test::residentKb();
+    long rssPeak = rssBefore;
+
+    uint32_t decoded = 0;
+    bool ordered = true;
+    PresetsRecord::Decoder decoder([&](uint32_t formId, std::span<const PresetsRecord::Entry> presets) {
+        ordered = ordered && formId == 0x01000000 + decoded && presets.size() == presetsPerActor
+            && presets[0].id == "Preset_" + std::to_string((decoded * 31) % strings);
+        if (++decoded % 100'000 == 0) {
+            rssPeak = std::max(rssPeak, test::residentKb());
+        }
+    });
+    PresetsRecord::InflateWriter inflater([&decoder](const uint8_t* data, size_t size) {
+        return decoder.feed(data, size);
+    });
+
+    // Как в ActorsManager::deserialize: сжатые данные читаются кусками по 64 КБ
+    constexpr size_t readChunk = 64 * 1024;
+    for (size_t pos = 0; pos < compressed.size(); pos += readChunk) {
+        REQUIRE(inflater.write(compressed.data() + pos, std::min(readChunk, compressed.size() - pos)));
+    }
+
+    CHECK(inflater.finished());
+    CHECK(inflater.totalOut() == rawSize);
+    CHECK(decoder.finished());
+    CHECK(decoded == actors);
+    CHECK(ordered);
+
+#if defined(__linux__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+    // Под санитайзерами освобождённая память копится в карантине, поэтому пик проверяется только в обычной сборке
+    const long growthKb = rssPeak - rssBefore;
+    std::printf("raw %llu bytes, compressed %zu bytes, RSS growth while decoding %ld KB\n",
+        static_cast<unsigned long long>(rawSize), compressed.size(), growthKb);
+    CHECK(growthKb < 8 * 1024);
+#endif
+}
+
+TEST_CASE(InflateStopsAtMaxOut)
+{
+    const auto bytes = encode(makeRecord(3000, 5));
+    const auto compressed = deflate(bytes);
+
+    uint64_t delivered = 0;
+    const uint64_t maxOut = bytes.size() / 2;
+    PresetsRecord::InflateWriter inflater([&delivered](const uint8_t*, size_t size) {
+        delivered += size;
+        return true;
+    }, maxOut, 1024);
+    CHECK(!inflater.write(compressed.data(), compressed.size()));
+    CHECK(!inflater.finished());
+    CHECK(delivered <= maxOut);
+    // После ошибки поток больше не принимает данные
+    CHECK(!inflater.write(compressed.data(), 1));
+}
+
+TEST_CASE(InflateRejectsSinkFailureAndTrailingData)
+{
+    const auto bytes = encode(makeRecord(500, 6));
+    const auto compressed = deflate(bytes);
+
+    PresetsRecord::InflateWriter refused([](const uint8_t*, size_t) { return false; });
+    CHECK(!refused.write(compressed.data(), compressed.size()));
+
+    PresetsRecord::InflateWriter trailing([](const uint8_t*, size_t) { return true; });
+    CHECK(trailing.write(compressed.data(), compressed.size()));
+    CHECK(trailing.finished());
+    const uint8_t extra = 0;
+    CHECK(!trailing.write(&extra, 1));
+
+    auto corrupted = compressed;
+    corrupted[corrupted.size() / 2] ^= 0xFF;
+    corrupted[corrupted.size() / 2 + 1] ^= 0xFF;
+    PresetsRecord::InflateWriter broken([](const uint8_t*, size_t) { return true; });
+    CHECK(!broken.write(corrupted.data(), corrupted.size()) || !broken.finished());
+}
+
+TEST_CASE(InflateAcceptsTinyCompressedChunks)
+{
+    const auto record = makeRecord(1000, 7);
+    const auto bytes = encode(record);
+    const auto compressed = deflate(bytes);
+
+    Record decoded;
+    PresetsRecord::Decoder decoder([&decoded](uint32_t formId, std::span<const PresetsRecord::Entry> presets) {
+        auto& target = decoded[formId];
+        for (const auto& entry : presets) {
+            target.emplace_back(entry.type, std::string{ entry.id });
+        }
+    });
+    PresetsRecord::InflateWriter inflater([&decoder](const uint8_t* data, size_t size) {
+        return decoder.feed(data, size);
+    }, UINT32_MAX, 16);
+    for (size_t pos = 0; pos < compressed.size(); pos += 3) {
+        REQUIRE(inflater.write(compressed.data() + pos, std::min<size_t>(3, compressed.size() - pos)));
+    }
+    CHECK(inflater.finished());
+    CHECK(decoder.finished());
+    CHECK(decoded == record);
+}
+
+BENCHMARK(EncodeDecodeThroughput)
+{
+    const auto record = makeRecord(20000, 4);
+    size_t rawSize = 0;
+    std::vector<uint8_t> compressed;
+    const double encodeUs = test::measure(20, [&] {
+        compressed = deflate(encode(record, 64 * 1024, &rawSize));
+    });
+
+    const double decodeUs = test::measure(20, [&] {
+        size_t actors = 0;
+        PresetsRecord::Decoder decoder([&actors](uint32_t, std::span<const PresetsRecord::Entry>) { ++actors; });
+        PresetsRecord::InflateWriter inflater([&decoder](const uint8_t* data, size_t size) {
+            return decoder.feed(data, size);
+        });
+        inflater.write(compressed.data(), compressed.size());
+        CHECK(decoder.finished() && actors == record.size());
+    });
+
+    std::printf("20000 actors: raw %zu bytes, compressed %zu bytes, encode+deflate %.0f us, inflate+decode %.0f us\n",
+        rawSize, compressed.size(), encodeUs, decodeUs);
+}
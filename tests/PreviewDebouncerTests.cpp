@@ -0,0 +1,199 @@
+#include "Check.h"
+#include "DirectApply/PreviewDebouncer.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    /**
+     * @brief Часы, которые двигает только тест.
+     */
+    struct FakeClock
+    {
+        using rep = int64_t;
+        using period = std::milli;
+        using duration = std::chrono::duration<rep, period>;
+        using time_point = std::chrono::time_point<FakeClock>;
+        static constexpr bool is_steady = true;
+
+        static inline time_point current{};
+
+        static time_point now() noexcept { return current; }
+        static void advance(duration d) noexcept { current += d; }
+    };
+
+    using Debouncer = BasicPreviewDebouncer<FakeClock>;
+}
+
+TEST_CASE(TicketFiresOnlyAfterSettle)
+{
+    Debouncer debouncer(300ms);
+    const auto ticket = debouncer.hover("A", FakeClock::now());
+    REQUIRE(ticket);
+    CHECK(ticket.due == FakeClock::now() + 300ms);
+    CHECK(debouncer.pending());
+
+    FakeClock::advance(299ms);
+    CHECK(!debouncer.take(ticket.generation, FakeClock::now()));
+    CHECK(debouncer.pending());
+
+    FakeClock::advance(1ms);
+    const auto fire = debouncer.take(ticket.generation, FakeClock::now());
+    REQUIRE(fire);
+    CHECK(fire->key == "A");
+    CHECK(fire->previous.empty());
+    CHECK(!debouncer.pending());
+    CHECK(debouncer.previewed() == "A");
+
+    // Билет одноразовый
+    CHECK(!debouncer.take(ticket.generation, FakeClock::now()));
+}
+
+TEST_CASE(BurstOfHoversAppliesOnlyTheLast)
+{
+    Debouncer debouncer(300ms);
+    std::vector<Debouncer::Ticket> tickets;
+    for (const char* key : { "A", "B", "C", "D" }) {
+        tickets.push_back(debouncer.hover(key, FakeClock::now()));
+        FakeClock::advance(100ms);
+    }
+    FakeClock::advance(1s);
+
+    int fired = 0;
+    for (const auto& ticket : tickets) {
+        if (auto fire = debouncer.take(ticket.generation, FakeClock::now())) {
+            ++fired;
+            CHECK(fire->key == "D");
+        }
+    }
+    CHECK(fired == 1);
+    CHECK(debouncer.previewed() == "D");
+}
+
+TEST_CASE(NewHoverRestartsTheSettleWindow)
+{
+    Debouncer debouncer(300ms);
+    debouncer.hover("A", FakeClock::now());
+    FakeClock::advance(250ms);
+    const auto ticket = debouncer.hover("B", FakeClock::now());
+    FakeClock::advance(100ms);
+    // От первого наведения прошло 350 мс, но срок считается от последнего
+    CHECK(!debouncer.take(ticket.generation, FakeClock::now()));
+    FakeClock::advance(200ms);
+    const auto fire = debouncer.take(ticket.generation, FakeClock::now());
+    REQUIRE(fire);
+    CHECK(fire->key == "B");
+}
+
+TEST_CASE(NextPreviewReplacesThePreviousOne)
+{
+    Debouncer debouncer(10ms);
+    auto ticket = debouncer.hover("A", FakeClock::now());
+    FakeClock::advance(10ms);
+    REQUIRE(debouncer.take(ticket.generation, FakeClock::now()));
+
+    ticket = debouncer.hover("B", FakeClock::now());
+    FakeClock::advance(10ms);
+    const auto fire = debouncer.take(ticket.generation, FakeClock::now());
+    REQUIRE(fire);
+    CHECK(fire->key == "B");
+    CHECK(fire->previous == "A");
+}
+
+TEST_CASE(HoverOnPreviewedPresetCancelsPending)
+{
+    Debouncer debouncer(10ms);
+    auto ticket = debouncer.hover("A", FakeClock::now());
+    FakeClock::advance(10ms);
+    REQUIRE(debouncer.take(ticket.generation, FakeClock::now()));
+
+    // Ушли на B и вернулись на A до срока: B не применяется, A уже показан
+    const auto toB = debouncer.hover("B", FakeClock::now());
+    const auto backToA = debouncer.hover("A", FakeClock::now());
+    CHECK(!backToA);
+    CHECK(!debouncer.pending());
+    FakeClock::advance(1s);
+    CHECK(!debouncer.take(toB.generation, FakeClock::now()));
+    CHECK(debouncer.previewed() == "A");
+}
+
+TEST_CASE(CancelCommitAndResetInvalidateTickets)
+{
+    Debouncer debouncer(10ms);
+
+    auto ticket = debouncer.hover("A", FakeClock::now());
+    debouncer.cancel();
+    FakeClock::advance(10ms);
+    CHECK(!debouncer.take(ticket.generation, FakeClock::now()));
+    CHECK(debouncer.previewed().empty());
+
+    ticket = debouncer.hover("B", FakeClock::now());
+    debouncer.commit("C");
+    FakeClock::advance(10ms);
+    CHECK(!debouncer.take(ticket.generation, FakeClock::now()));
+    CHECK(debouncer.previewed() == "C");
+    // После commit наведение на показанный пресет ничего не планирует
+    CHECK(!debouncer.hover("C", FakeClock::now()));
+
+    ticket = debouncer.hover("D", FakeClock::now());
+    debouncer.reset();
+    FakeClock::advance(10ms);
+    CHECK(!debouncer.take(ticket.generation, FakeClock::now()));
+    CHECK(debouncer.previewed().empty());
+    CHECK(!debouncer.pending());
+
+    // После reset показанного пресета нет, поэтому C снова планируется с нуля
+    ticket = debouncer.hover("C", FakeClock::now());
+    REQUIRE(ticket);
+    FakeClock::advance(10ms);
+    const auto fire = debouncer.take(ticket.generation, FakeClock::now());
+    REQUIRE(fire);
+    CHECK(fire->previous.empty());
+}
+
+TEST_CASE(SetSettleAffectsOnlyNewHovers)
+{
+    Debouncer debouncer(300ms);
+    const auto before = debouncer.hover("A", FakeClock::now());
+    debouncer.setSettle(50ms);
+    CHECK(debouncer.settle() == 50ms);
+    CHECK(before.due == FakeClock::now() + 300ms);
+    const auto after = debouncer.hover("B", FakeClock::now());
+    CHECK(after.due == FakeClock::now() + 50ms);
+}
+
+TEST_CASE(ConcurrentHoversFireAtMostOncePerTicket)
+{
+    // Потоки наводят и забирают превью одновременно: каждый билет срабатывает не больше одного раза,
+    // а после затишья последнее наведение срабатывает.
+    Debouncer debouncer(0ms);
+    std::atomic<int> fired{ 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 2000; ++i) {
+                const auto ticket = debouncer.hover(std::to_string(t * 10000 + i), FakeClock::time_point{});
+                if (ticket && debouncer.take(ticket.generation, FakeClock::time_point{})) {
+                    fired.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (ticket && debouncer.take(ticket.generation, FakeClock::time_point{})) {
+                    fired.fetch_add(1000000, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(fired.load() <= 4 * 2000);
+
+    const auto ticket = debouncer.hover("last", FakeClock::time_point{});
+    REQUIRE(ticket);
+    const auto fire = debouncer.take(ticket.generation, FakeClock::time_point{});
+    REQUIRE(fire);
+    CHECK(fire->key == "last");
+}
@@ -0,0 +1,131 @@
+#include "Check.h"
+#include "Ini/Settings.h"
+#include "Utils/Hash.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    /**
+     * @brief Временный DiverseBodiesRedux.ini. Удаляется в деструкторе.
+     */
+    struct TempIni
+    {
+        fs::path path;
+
+        explicit TempIni(const std::string& content)
+        {
+            static int counter = 0;
+            path = fs::temp_directory_path() / ("dbr-settings-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-" + std::to_string(counter++) + ".ini");
+            write(content);
+        }
+
+        ~TempIni()
+        {
+            std::error_code ec;
+            fs::remove(path, ec);
+        }
+
+        void write(const std::string& content) const
+        {
+            std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+        }
+    };
+
+    const char* sampleIni =
+        "[GENERAL]\n"
+        "bAddChargenFlag = 1\n"
+        "[DEBUG]\n"
+        "iLogLevel = 0\n"
+        "sSerializationLog = Actors\n"
+        "[PATCH]\n"
+        "bCBP2507 = false\n"
+        "bChangeHeadPart = true\n"
+        "[MENU]\n"
+        "iPresetsPageSize = 120\n"
+        "[COLORS]\n"
+        "sTheme = Dark\n";
+}
+
+TEST_CASE(Fnv1aKnownValues)
+{
+    CHECK(utils::fnv1a("") == 0xcbf29ce484222325ULL);
+    CHECK(utils::fnv1a("a") == 0xaf63dc4c8601ec8cULL);
+    CHECK(utils::fnv1a("foobar") == 0x85944171f73967e8ULL);
+}
+
+TEST_CASE(SettingsMatchMapLookups)
+{
+    const TempIni file(sampleIni);
+    const ini::map m(file.path);
+    const auto settings = ini::Settings::fromMap(m);
+
+#define DBR_INI_SETTINGS_CHECK(type, section, key, default_value) \
+    CHECK(settings.key == m.at<type>(section "/" #key, default_value));
+    DBR_INI_SETTINGS(DBR_INI_SETTINGS_CHECK)
+#undef DBR_INI_SETTINGS_CHECK
+
+    CHECK(settings.bAddChargenFlag);
+    CHECK(settings.iLogLevel == 0);
+    CHECK(settings.sSerializationLog == "Actors");
+    CHECK(!settings.bCBP2507);
+    CHECK(settings.iPresetsPageSize == 120);
+    CHECK(settings.sTheme == "Dark");
+    // Отсутствующие ключи - значения по умолчанию
+    CHECK(settings.bBSTransformSet);
+    CHECK(!settings.bDoUpdate3DModelHook);
+    CHECK(settings.iPreviewSettleMs == 300);
+}
+
+TEST_CASE(RefreshPublishesOnlyChangedContent)
+{
+    const TempIni file(sampleIni);
+    ini::map m(file.path);
+    ini::SettingsSnapshot snapshot;
+    CHECK(snapshot.get().bCBP2507);
+
+    snapshot.publish(m);
+    const auto& first = snapshot.get();
+    CHECK(!first.bCBP2507);
+
+    // То же содержимое - снимок прежний
+    file.write(sampleIni);
+    CHECK(!snapshot.refresh(m));
+    CHECK(&snapshot.get() == &first);
+
+    file.write(std::string(sampleIni) + "[MENU]\niPreviewSettleMs = 50\n");
+    CHECK(snapshot.refresh(m));
+    CHECK(&snapshot.get() != &first);
+    CHECK(snapshot.get().iPreviewSettleMs == 50);
+    // Старый снимок остаётся валидным
+    CHECK(!first.bCBP2507);
+    CHECK(first.iPreviewSettleMs == 300);
+}
+
+BENCHMARK(MapAtVersusSnapshotRead)
+{
+    const TempIni file(sampleIni);
+    const ini::map m(file.path);
+    ini::SettingsSnapshot snapshot;
+    snapshot.publish(m);
+
+    // Так читали настройку на каждом вызове хука до снимка
+    constexpr int reads = 100000;
+    size_t sink = 0;
+    const double atUs = test::measure(5, [&] {
+        for (int i = 0; i < reads; ++i) {
+            sink += m.at<bool>("PATCH/bCBP2507", true) ? 1 : 2;
+        }
+    });
+    const double snapshotUs = test::measure(5, [&] {
+        for (int i = 0; i < reads; ++i) {
+            sink += snapshot.get().bCBP2507 ? 1 : 2;
+        }
+    });
+    std::printf("%d reads of PATCH/bCBP2507: map::at<bool> %.0f us, snapshot %.0f us (%zu)\n", reads, atUs, snapshotUs, sink);
+}
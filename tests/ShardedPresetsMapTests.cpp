@@ -0,0 +1,241 @@
+#include "Check.h"
+#include "ActorsManager/Details/ShardedPresetsMap.hpp"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Presets = ShardedPresetsMap::Presets;
+
+    /**
+     * @brief Набор из двух пресетов разных типов с одним и тем же поколением в id.
+     * Читатель, увидевший разные поколения в одном наборе, застал запись наполовину.
+     */
+    Presets makePresets(uint32_t generation)
+    {
+        const auto id = "gen" + std::to_string(generation);
+        Presets presets;
+        presets.emplace(std::make_shared<Preset>(PresetType::BODYMORPHS, id));
+        presets.emplace(std::make_shared<Preset>(PresetType::HEAD, id));
+        return presets;
+    }
+
+    bool consistent(const Presets& presets)
+    {
+        std::set<std::string> ids;
+        for (const auto& preset : presets) {
+            ids.insert(preset->id());
+        }
+        return presets.size() == 2 && ids.size() == 1;
+    }
+
+    /**
+     * @brief Прежний вариант хранилища: одна карта под одним shared_mutex. Для сравнения в замере.
+     */
+    class SingleLockMap
+    {
+    public:
+        void insert_or_assign(uint32_t formId, Presets presets)
+        {
+            std::unique_lock lock(m_mutex);
+            m_map.insert_or_assign(formId, std::move(presets));
+        }
+
+        bool contains(uint32_t formId) const
+        {
+            std::shared_lock lock(m_mutex);
+            return m_map.contains(formId);
+        }
+
+    private:
+        mutable std::shared_mutex m_mutex;
+        ShardedPresetsMap::Map m_map;
+    };
+
+    template <class MapT>
+    double concurrentLookups(MapT& map, uint32_t actors, unsigned readers, bool withWriter)
+    {
+        constexpr size_t lookupsPerReader = 2'000'000;
+        std::atomic<bool> stop{ false };
+        std::thread writer;
+        if (withWriter) {
+            writer = std::thread([&] {
+                for (uint32_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+                    map.insert_or_assign(0x01000000 + i % actors, makePresets(i));
+                }
+            });
+        }
+
+        std::atomic<size_t> hits{ 0 };
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (unsigned r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                size_t found = 0;
+                for (size_t i = 0; i < lookupsPerReader; ++i) {
+                    found += map.contains(0x01000000 + static_cast<uint32_t>((i * 7 + r) % actors));
+                }
+                hits += found;
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        stop = true;
+        if (writer.joinable()) {
+            writer.join();
+        }
+        CHECK(hits.load() == lookupsPerReader * readers);
+        return readers * lookupsPerReader / elapsed.count() / 1000.0;
+    }
+}
+
+TEST_CASE(BasicOperations)
+{
+    ShardedPresetsMap map;
+    CHECK(map.empty());
+    CHECK(!map.find(1).has_value());
+
+    for (uint32_t i = 0; i < 1000; ++i) {
+        map.insert_or_assign(0x01000000 + i, makePresets(i));
+    }
+    CHECK(map.size() == 1000);
+    CHECK(map.contains(0x01000000 + 5));
+    CHECK(!map.contains(0x02000000));
+
+    auto found = map.find(0x01000000 + 7);
+    CHECK(found && consistent(*found) && (*found->begin())->id() == "gen7");
+
+    map.insert_or_assign(0x01000000 + 7, makePresets(100));
+    CHECK(map.visit(0x01000000 + 7, [](const Presets& presets) {
+        CHECK((*presets.begin())->id() == "gen100");
+    }));
+    CHECK(!map.visit(0x02000000, [](const Presets&) {}));
+
+    map.update(0x02000000, [](Presets& presets) {
+        CHECK(presets.empty());
+        presets = makePresets(1);
+    });
+    CHECK(map.size() == 1001);
+
+    size_t visited = 0;
+    map.forEach([&visited](uint32_t, const Presets& presets) {
+        visited += consistent(presets);
+    });
+    CHECK(visited == 1001);
+    CHECK(map.snapshot().size() == 1001);
+
+    ShardedPresetsMap::Map incoming;
+    incoming.emplace(0x03000000, makePresets(3));
+    incoming.emplace(0x01000000 + 7, makePresets(4));
+    map.merge(std::move(incoming));
+    CHECK(incoming.empty());
+    CHECK(map.size() == 1002);
+    CHECK((*map.find(0x01000000 + 7)->begin())->id() == "gen4");
+
+    map.clear();
+    CHECK(map.empty() && map.size() == 0);
+}
+
+TEST_CASE(SequentialIdsSpreadAcrossShards)
+{
+    // FormID одного плагина идут подряд, шардов должно быть задействовано заметно больше одного
+    ShardedPresetsMap map;
+    for (uint32_t i = 0; i < 64; ++i) {
+        map.insert_or_assign(0x01000800 + i, makePresets(i));
+    }
+    // Косвенная проверка через forEach: порядок обхода идёт по шардам, соседние id не должны идти подряд
+    std::vector<uint32_t> order;
+    map.forEach([&order](uint32_t formId, const Presets&) { order.push_back(formId); });
+    size_t adjacent = 0;
+    for (size_t i = 1; i < order.size(); ++i) {
+        adjacent += order[i] == order[i - 1] + 1;
+    }
+    CHECK(order.size() == 64);
+    CHECK(adjacent < 16);
+}
+
+TEST_CASE(ConcurrentReadersNeverSeeTornSets)
+{
+    constexpr uint32_t actors = 512;
+    constexpr uint32_t writes = 20'000;
+    ShardedPresetsMap map;
+    for (uint32_t i = 0; i < actors; ++i) {
+        map.insert_or_assign(0x01000000 + i, makePresets(0));
+    }
+
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> torn{ 0 };
+    std::vector<std::thread> threads;
+
+    for (unsigned w = 0; w < 2; ++w) {
+        threads.emplace_back([&, w] {
+            for (uint32_t i = 0; i < writes; ++i) {
+                const uint32_t formId = 0x01000000 + (i * 13 + w) % actors;
+                if (i % 2) {
+                    map.insert_or_assign(formId, makePresets(i));
+                }
+                else {
+                    map.update(formId, [i](Presets& presets) { presets = makePresets(i); });
+                }
+            }
+        });
+    }
+    for (unsigned r = 0; r < 4; ++r) {
+        threads.emplace_back([&, r] {
+            while (!done.load(std::memory_order_acquire)) {
+                for (uint32_t i = r; i < actors; i += 4) {
+                    if (auto presets = map.find(0x01000000 + i); !presets || !consistent(*presets)) {
+                        ++torn;
+                    }
+                    map.visit(0x01000000 + i, [&torn](const Presets& presets) {
+                        if (!consistent(presets)) {
+                            ++torn;
+                        }
+                    });
+                }
+                map.forEach([&torn](uint32_t, const Presets& presets) {
+                    if (!consistent(presets)) {
+                        ++torn;
+                    }
+                });
+            }
+        });
+    }
+
+    threads[0].join();
+    threads[1].join();
+    done.store(true, std::memory_order_release);
+    for (size_t i = 2; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+
+    CHECK(torn.load() == 0);
+    CHECK(map.size() == actors);
+}
+
+BENCHMARK(ReadThroughput)
+{
+    constexpr uint32_t actors = 5000;
+    const unsigned readers = std::max(2u, std::thread::hardware_concurrency());
+
+    ShardedPresetsMap sharded;
+    SingleLockMap single;
+    for (uint32_t i = 0; i < actors; ++i) {
+        sharded.insert_or_assign(0x01000000 + i, makePresets(i));
+        single.insert_or_assign(0x01000000 + i, makePresets(i));
+    }
+
+    for (bool withWriter : { false, true }) {
+        const double shardedRate = concurrentLookups(sharded, actors, readers, withWriter);
+        const double singleRate = concurrentLookups(single, actors, readers, withWriter);
+        std::printf("%u readers%s: sharded %.1f M lookups/s, single lock %.1f M lookups/s\n",
+            readers, withWriter ? " + writer" : "", shardedRate, singleRate);
+    }
+}
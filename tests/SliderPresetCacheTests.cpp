@@ -0,0 +1,207 @@
+#include "Check.h"
+#include "Preset/Details/SliderPresetCache.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    /**
+     * @brief Временный каталог с BodySlide пресетами и файлом кэша. Удаляется в деструкторе.
+     */
+    struct TempData
+    {
+        fs::path root;
+
+        TempData()
+        {
+            static int counter = 0;
+            root = fs::temp_directory_path() / ("dbr-slider-cache-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "-" + std::to_string(counter++));
+            fs::remove_all(root);
+            fs::create_directories(presets());
+        }
+
+        ~TempData()
+        {
+            std::error_code ec;
+            fs::remove_all(root, ec);
+        }
+
+        fs::path presets() const { return root / "BodySlide" / "SliderPresets"; }
+        fs::path cache() const { return root / "DiverseBodiesRedux.slidercache"; }
+
+        fs::path write(const std::string& name, const std::string& content) const
+        {
+            const auto path = presets() / name;
+            std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+            return path;
+        }
+    };
+
+    std::string read(const fs::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    }
+
+    /**
+     * @brief Пресет BodySlide со слайдерами в случайном порядке, как их сохраняет BodySlide.
+     */
+    std::string makePreset(std::mt19937& rng, int index, size_t sliders)
+    {
+        std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<SliderPresets>\n";
+        xml += "    <Preset name=\"DBR " + std::to_string(index) + "\" set=\"CBBE Body\">\n";
+        xml += "        <Group name=\"CBBE\"/>\n";
+        for (size_t i = 0; i < sliders; ++i) {
+            const auto value = static_cast<int>(rng() % 201) - 50;
+            xml += "        <SetSlider name=\"Slider" + std::to_string(rng() % 300) + "\" size=\"" + (i % 2 ? "big" : "small") +
+                "\" value=\"" + std::to_string(value) + "\"/>\n";
+        }
+        xml += "    </Preset>\n</SliderPresets>\n";
+        return xml;
+    }
+
+    /**
+     * @brief Сгенерировать count пресетов и вернуть их пути.
+     */
+    std::vector<fs::path> makePresets(const TempData& data, int count, size_t sliders)
+    {
+        std::mt19937 rng(11);
+        std::vector<fs::path> paths;
+        for (int i = 0; i < count; ++i) {
+            paths.push_back(data.write("Preset" + std::to_string(i) + ".xml", makePreset(rng, i, sliders)));
+        }
+        return paths;
+    }
+}
+
+TEST_CASE(ParseReadsFirstPresetSliders)
+{
+    const auto sliders = SliderPresetCache::parse(
+        "<SliderPresets><Preset name=\"A\"><SetSlider name=\"Breasts\" size=\"big\" value=\"150\"/>"
+        "<SetSlider name=\"NoValue\" size=\"big\"/><SetSlider name=\"Waist\" size=\"small\" value=\"-20\"/></Preset>"
+        "<Preset name=\"B\"><SetSlider name=\"Hips\" value=\"10\"/></Preset></SliderPresets>");
+    REQUIRE(sliders.has_value());
+    REQUIRE(sliders->size() == 2);
+    CHECK((*sliders)[0].first == "Breasts");
+    CHECK((*sliders)[0].second == 1.5f);
+    CHECK((*sliders)[1].first == "Waist");
+    CHECK((*sliders)[1].second == -0.2f);
+
+    CHECK(SliderPresetCache::parse("<SliderPresets/>").value().empty());
+    CHECK(!SliderPresetCache::parse("{ \"not\": \"xml\" }").has_value());
+}
+
+TEST_CASE(CacheLoadMatchesColdParse)
+{
+    TempData data;
+    const auto paths = makePresets(data, 200, 40);
+
+    {
+        SliderPresetCache cold{ data.cache() };
+        for (const auto& path : paths) {
+            CHECK(!cold.find(path).has_value());
+            CHECK(cold.sliders(path) == SliderPresetCache::parse(read(path)));
+        }
+        CHECK(cold.save());
+    }
+    REQUIRE(fs::exists(data.cache()));
+
+    // Новая сессия: find отвечает только из кэша, без разбора
+    SliderPresetCache warm{ data.cache() };
+    for (const auto& path : paths) {
+        const auto cached = warm.find(path);
+        REQUIRE(cached.has_value());
+        CHECK(cached == SliderPresetCache::parse(read(path)));
+        CHECK(cached->size() == 40);
+    }
+}
+
+TEST_CASE(ChangedFilesAreParsedAgain)
+{
+    TempData data;
+    std::mt19937 rng(3);
+    const auto changed = data.write("Changed.xml", makePreset(rng, 0, 10));
+    const auto touched = data.write("Touched.xml", makePreset(rng, 1, 10));
+    const auto removed = data.write("Removed.xml", makePreset(rng, 2, 10));
+    const auto broken = data.write("Broken.xml", "<SliderPresets><Preset>");
+    {
+        SliderPresetCache cache{ data.cache() };
+        for (const auto& path : { changed, touched, removed, broken }) {
+            cache.sliders(path);
+        }
+        CHECK(!cache.sliders(broken).has_value());
+        CHECK(cache.save());
+    }
+
+    // Другой размер - промах; то же содержимое с новым временем - попадание по хэшу
+    data.write("Changed.xml", makePreset(rng, 0, 12));
+    fs::last_write_time(touched, fs::last_write_time(touched) + std::chrono::hours(1));
+    fs::remove(removed);
+
+    SliderPresetCache cache{ data.cache() };
+    CHECK(!cache.find(changed).has_value());
+    CHECK(cache.sliders(changed).value().size() == 12);
+    CHECK(cache.find(touched) == SliderPresetCache::parse(read(touched)));
+    CHECK(!cache.find(removed).has_value());
+    CHECK(!cache.find(broken).has_value());
+    CHECK(cache.save());
+
+    // Удалённый файл не попадает в кэш, изменённый сохраняется с новыми слайдерами
+    SliderPresetCache next{ data.cache() };
+    CHECK(next.find(changed).value().size() == 12);
+    CHECK(next.find(touched).has_value());
+}
+
+TEST_CASE(DamagedCacheFileIsIgnored)
+{
+    TempData data;
+    const auto paths = makePresets(data, 5, 8);
+    {
+        SliderPresetCache cache{ data.cache() };
+        for (const auto& path : paths) {
+            cache.sliders(path);
+        }
+        CHECK(cache.save());
+    }
+    const auto bytes = read(data.cache());
+    std::ofstream(data.cache(), std::ios::binary | std::ios::trunc) << bytes.substr(0, bytes.size() / 2);
+
+    SliderPresetCache cache{ data.cache() };
+    CHECK(!cache.find(paths.front()).has_value());
+    CHECK(cache.sliders(paths.front()) == SliderPresetCache::parse(read(paths.front())));
+}
+
+BENCHMARK(ColdParseVersusCacheLoad)
+{
+    TempData data;
+    const auto paths = makePresets(data, 500, 60);
+    {
+        SliderPresetCache cache{ data.cache() };
+        for (const auto& path : paths) {
+            cache.sliders(path);
+        }
+        cache.save();
+    }
+
+    size_t sink = 0;
+    const double parseUs = test::measure(5, [&] {
+        for (const auto& path : paths) {
+            sink += SliderPresetCache::parse(read(path))->size();
+        }
+    });
+    const double cacheUs = test::measure(5, [&] {
+        SliderPresetCache cache{ data.cache() };
+        for (const auto& path : paths) {
+            sink += cache.find(path)->size();
+        }
+    });
+    std::printf("500 presets x 60 sliders: read + parse %.0f us, cache load + find %.0f us (%zu)\n", parseUs, cacheUs, sink);
+}
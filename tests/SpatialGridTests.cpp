@@ -0,0 +1,242 @@
+#include "Check.h"
+#include "Utils/SpatialGrid.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using Grid = utils::SpatialGridCore<uint32_t>;
+    using Result = Grid::Result;
+
+    /**
+     * @brief Эталон: те же точки в словаре, поиск полным перебором.
+     */
+    struct BruteForce
+    {
+        std::unordered_map<uint32_t, utils::SpatialPoint> points;
+
+        std::vector<Result> queryRadius(utils::SpatialPoint center, float radius) const
+        {
+            std::vector<Result> results;
+            const float radiusSq = radius * radius;
+            for (const auto& [id, point] : points) {
+                const float dx = point.x - center.x;
+                const float dy = point.y - center.y;
+                const float dz = point.z - center.z;
+                const float distanceSq = dx * dx + dy * dy + dz * dz;
+                if (distanceSq <= radiusSq) {
+                    results.emplace_back(id, distanceSq);
+                }
+            }
+            return results;
+        }
+    };
+
+    utils::SpatialPoint randomPoint(std::mt19937& rng)
+    {
+        // Мир ~ 120k x 120k с отрицательными координатами, высота поменьше
+        std::uniform_real_distribution<float> xy(-60000.0f, 60000.0f);
+        std::uniform_real_distribution<float> z(-2000.0f, 4000.0f);
+        return { xy(rng), xy(rng), z(rng) };
+    }
+
+    std::vector<uint32_t> ids(std::vector<Result> results)
+    {
+        std::vector<uint32_t> out;
+        out.reserve(results.size());
+        for (const auto& [id, distanceSq] : results) {
+            out.push_back(id);
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    /**
+     * @brief Сравнить поиск в радиусе и k ближайших с перебором для набора центров и радиусов.
+     */
+    void compareQueries(const Grid& grid, const BruteForce& brute, std::mt19937& rng)
+    {
+        REQUIRE(grid.size() == brute.points.size());
+        for (const float radius : { 0.0f, 500.0f, 4096.0f, 10000.0f, 20000.0f, 200000.0f }) {
+            for (int i = 0; i < 20; ++i) {
+                const auto center = randomPoint(rng);
+                const auto expected = brute.queryRadius(center, radius);
+                CHECK(ids(grid.queryRadius(center, radius)) == ids(expected));
+
+                // Равные расстояния в случайных float почти невозможны, поэтому порядок сравнивается по расстояниям
+                auto expectedNearest = expected;
+                utils::selectNearest(expectedNearest, 10);
+                const auto nearest = grid.nearest(center, radius, 10);
+                REQUIRE(nearest.size() == expectedNearest.size());
+                for (size_t k = 0; k < nearest.size(); ++k) {
+                    CHECK(nearest[k].second == expectedNearest[k].second);
+                    CHECK(k == 0 || nearest[k - 1].second <= nearest[k].second);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(MatchesBruteForceOn5kPoints)
+{
+    std::mt19937 rng(22);
+    Grid grid(4096.0f);
+    BruteForce brute;
+    for (uint32_t id = 1; id <= 5000; ++id) {
+        const auto point = randomPoint(rng);
+        grid.upsert(id, point);
+        brute.points[id] = point;
+    }
+    compareQueries(grid, brute, rng);
+}
+
+TEST_CASE(MatchesBruteForceAfterMovesAndErases)
+{
+    std::mt19937 rng(23);
+    Grid grid(4096.0f);
+    BruteForce brute;
+    for (uint32_t id = 1; id <= 5000; ++id) {
+        const auto point = randomPoint(rng);
+        grid.upsert(id, point);
+        brute.points[id] = point;
+    }
+
+    std::uniform_int_distribution<uint32_t> anyId(1, 6000);
+    std::uniform_real_distribution<float> step(-3000.0f, 3000.0f);
+    for (int round = 0; round < 20000; ++round) {
+        const uint32_t id = anyId(rng);
+        switch (round % 4) {
+        case 0:
+        case 1: {
+            // Мелкий сдвиг: чаще внутри ячейки, иногда в соседнюю
+            auto point = brute.points.contains(id) ? brute.points[id] : randomPoint(rng);
+            point.x += step(rng);
+            point.y += step(rng);
+            grid.upsert(id, point);
+            brute.points[id] = point;
+            break;
+        }
+        case 2: {
+            const auto point = randomPoint(rng);
+            grid.upsert(id, point);
+            brute.points[id] = point;
+            break;
+        }
+        default:
+            CHECK(grid.erase(id) == (brute.points.erase(id) == 1));
+            break;
+        }
+    }
+    for (const auto& [id, point] : brute.points) {
+        CHECK(grid.contains(id));
+    }
+    compareQueries(grid, brute, rng);
+}
+
+TEST_CASE(SweepDropsObjectsNotRefreshed)
+{
+    std::mt19937 rng(24);
+    Grid grid(4096.0f);
+    BruteForce brute;
+    for (uint32_t id = 1; id <= 5000; ++id) {
+        grid.upsert(id, randomPoint(rng));
+    }
+
+    grid.beginSweep();
+    for (uint32_t id = 1; id <= 5000; id += 3) {
+        const auto point = randomPoint(rng);
+        grid.upsert(id, point);
+        brute.points[id] = point;
+    }
+    CHECK(grid.endSweep() == 5000 - brute.points.size());
+    compareQueries(grid, brute, rng);
+
+    // Пустая сверка удаляет всё
+    grid.beginSweep();
+    CHECK(grid.endSweep() == brute.points.size());
+    CHECK(grid.size() == 0);
+    CHECK(grid.queryRadius({}, 1e9f).empty());
+}
+
+TEST_CASE(EdgeCases)
+{
+    Grid grid(100.0f);
+    grid.upsert(1, { -0.5f, -0.5f, 0.0f });
+    grid.upsert(2, { 0.5f, 0.5f, 0.0f });
+    grid.upsert(3, { 0.0f, 0.0f, 50.0f });
+
+    // Соседние ячейки по разные стороны нуля
+    CHECK((ids(grid.queryRadius({ 0.0f, 0.0f, 0.0f }, 1.0f)) == std::vector<uint32_t>{ 1, 2 }));
+    // Расстояние в 3D: точка над центром не попадает в радиус по высоте
+    CHECK((ids(grid.queryRadius({ 0.0f, 0.0f, 0.0f }, 49.0f)) == std::vector<uint32_t>{ 1, 2 }));
+    CHECK((ids(grid.queryRadius({ 0.0f, 0.0f, 0.0f }, 50.0f)) == std::vector<uint32_t>{ 1, 2, 3 }));
+    CHECK(grid.queryRadius({}, -1.0f).empty());
+    CHECK(grid.nearest({}, 1000.0f, 0).empty());
+
+    CHECK(!grid.erase(42));
+    CHECK(grid.erase(2));
+    CHECK(!grid.contains(2));
+    CHECK((ids(grid.queryRadius({}, 1000.0f)) == std::vector<uint32_t>{ 1, 3 }));
+
+    grid.clear();
+    CHECK(grid.size() == 0);
+    grid.upsert(7, { 1.0f, 1.0f, 1.0f });
+    CHECK((ids(grid.queryRadius({}, 10.0f)) == std::vector<uint32_t>{ 7 }));
+}
+
+TEST_CASE(LockedSweepMatchesCore)
+{
+    std::mt19937 rng(25);
+    utils::SpatialGrid<uint32_t> grid(4096.0f);
+    BruteForce brute;
+    for (uint32_t id = 1; id <= 5000; ++id) {
+        grid.upsert(id, randomPoint(rng));
+    }
+
+    std::vector<std::pair<uint32_t, utils::SpatialPoint>> current;
+    for (uint32_t id = 2500; id <= 6000; ++id) {
+        const auto point = randomPoint(rng);
+        current.emplace_back(id, point);
+        brute.points[id] = point;
+    }
+    CHECK(grid.sweep(current) == 2499);
+    CHECK(grid.size() == brute.points.size());
+    for (int i = 0; i < 50; ++i) {
+        const auto center = randomPoint(rng);
+        CHECK(ids(grid.queryRadius(center, 10000.0f)) == ids(brute.queryRadius(center, 10000.0f)));
+    }
+}
+
+BENCHMARK(QueryVsLinearScan)
+{
+    std::mt19937 rng(26);
+    Grid grid(4096.0f);
+    BruteForce brute;
+    for (uint32_t id = 1; id <= 5000; ++id) {
+        const auto point = randomPoint(rng);
+        grid.upsert(id, point);
+        brute.points[id] = point;
+    }
+    std::vector<utils::SpatialPoint> centers;
+    for (int i = 0; i < 256; ++i) {
+        centers.push_back(randomPoint(rng));
+    }
+
+    for (const float radius : { 10000.0f, 20000.0f }) {
+        size_t next = 0;
+        size_t sink = 0;
+        const double gridUs = test::measure(20000, [&] {
+            sink += grid.nearest(centers[next++ % centers.size()], radius, 10).size();
+        });
+        const double linearUs = test::measure(2000, [&] {
+            auto results = brute.queryRadius(centers[next++ % centers.size()], radius);
+            std::sort(results.begin(), results.end(), [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+            results.resize(std::min<size_t>(results.size(), 10));
+            sink += results.size();
+        });
+        std::printf("radius %.0f, 5k points, top 10: grid %.2f us, linear scan + sort %.2f us (%zu)\n", radius, gridUs, linearUs, sink);
+    }
+}
@@ -0,0 +1,347 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Заглушка Boost.JSON для хостовых тестов, когда Boost.JSON 1.75+ не найден.
+ *
+ * Повторяет только то, что нужно LMPresetData и его тесту: документ из value/object/array/string и parse().
+ * Правила те же, что у Boost.JSON: целые числа становятся int64 (или uint64, если не помещаются),
+ * числа с дробной частью или экспонентой - double, object сохраняет порядок ключей, при повторе ключа
+ * остаётся последнее значение. Ошибка разбора - исключение std::runtime_error.
+ */
+namespace boost::json
+{
+    class value;
+    struct key_value_pair;
+
+    class string
+    {
+    public:
+        string() = default;
+        explicit string(std::string text) : m_text(std::move(text)) {}
+
+        const char* c_str() const noexcept { return m_text.c_str(); }
+        const char* data() const noexcept { return m_text.data(); }
+        std::size_t size() const noexcept { return m_text.size(); }
+        operator std::string_view() const noexcept { return m_text; }
+
+    private:
+        std::string m_text;
+    };
+
+    class array
+    {
+    public:
+        using const_iterator = std::vector<value>::const_iterator;
+
+        const_iterator begin() const noexcept { return m_items.begin(); }
+        const_iterator end() const noexcept { return m_items.end(); }
+        std::size_t size() const noexcept { return m_items.size(); }
+        bool empty() const noexcept { return m_items.empty(); }
+        const value& operator[](std::size_t index) const { return m_items[index]; }
+        void push_back(value item);
+
+    private:
+        std::vector<value> m_items;
+    };
+
+    class object
+    {
+    public:
+        using const_iterator = std::vector<key_value_pair>::const_iterator;
+
+        const_iterator begin() const noexcept { return m_items.begin(); }
+        const_iterator end() const noexcept { return m_items.end(); }
+        std::size_t size() const noexcept { return m_items.size(); }
+        bool empty() const noexcept { return m_items.empty(); }
+        bool contains(std::string_view key) const noexcept;
+        void insert_or_assign(std::string_view key, value item);
+
+    private:
+        std::vector<key_value_pair> m_items;
+    };
+
+    class value
+    {
+    public:
+        value() = default;
+        template <class T, class = std::enable_if_t<!std::is_same_v<std::decay_t<T>, value>>>
+        value(T&& item) : m_data(std::forward<T>(item)) {}
+
+        bool is_null() const noexcept { return std::holds_alternative<std::nullptr_t>(m_data); }
+        bool is_bool() const noexcept { return std::holds_alternative<bool>(m_data); }
+        bool is_int64() const noexcept { return std::holds_alternative<std::int64_t>(m_data); }
+        bool is_uint64() const noexcept { return std::holds_alternative<std::uint64_t>(m_data); }
+        bool is_double() const noexcept { return std::holds_alternative<double>(m_data); }
+        bool is_string() const noexcept { return std::holds_alternative<string>(m_data); }
+        bool is_array() const noexcept { return std::holds_alternative<array>(m_data); }
+        bool is_object() const noexcept { return std::holds_alternative<object>(m_data); }
+
+        bool as_bool() const { return std::get<bool>(m_data); }
+        std::int64_t as_int64() const { return std::get<std::int64_t>(m_data); }
+        std::uint64_t as_uint64() const { return std::get<std::uint64_t>(m_data); }
+        double as_double() const { return std::get<double>(m_data); }
+        const string& as_string() const { return std::get<string>(m_data); }
+        const array& as_array() const { return std::get<array>(m_data); }
+        const object& as_object() const { return std::get<object>(m_data); }
+
+    private:
+        std::variant<std::nullptr_t, bool, std::int64_t, std::uint64_t, double, string, array, object> m_data{ nullptr };
+    };
+
+    /**
+     * @brief Пара объекта. Разбирается через structured bindings: auto& [key, value] = pair.
+     */
+    struct key_value_pair
+    {
+        std::string key;
+        json::value value;
+    };
+
+    inline void array::push_back(value item)
+    {
+        m_items.push_back(std::move(item));
+    }
+
+    inline bool object::contains(std::string_view key) const noexcept
+    {
+        for (const auto& item : m_items) {
+            if (item.key == key) return true;
+        }
+        return false;
+    }
+
+    inline void object::insert_or_assign(std::string_view key, value item)
+    {
+        for (auto& existing : m_items) {
+            if (existing.key == key) {
+                existing.value = std::move(item);
+                return;
+            }
+        }
+        m_items.push_back(key_value_pair{ std::string(key), std::move(item) });
+    }
+
+    namespace detail
+    {
+        class parser
+        {
+        public:
+            explicit parser(std::string_view text) : m_text(text) {}
+
+            value document()
+            {
+                auto result = parseValue();
+                skipSpace();
+                if (m_pos != m_text.size()) fail("extra data after the document");
+                return result;
+            }
+
+        private:
+            [[noreturn]] void fail(const char* what) const
+            {
+                throw std::runtime_error(std::string("json parse error at ") + std::to_string(m_pos) + ": " + what);
+            }
+
+            void skipSpace() noexcept
+            {
+                while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) {
+                    ++m_pos;
+                }
+            }
+
+            bool consume(char c) noexcept
+            {
+                skipSpace();
+                if (m_pos < m_text.size() && m_text[m_pos] == c) {
+                    ++m_pos;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char c)
+            {
+                if (!consume(c)) fail("unexpected character");
+            }
+
+            bool literal(std::string_view word) noexcept
+            {
+                if (m_text.substr(m_pos, word.size()) != word) return false;
+                m_pos += word.size();
+                return true;
+            }
+
+            value parseValue()
+            {
+                skipSpace();
+                if (m_pos >= m_text.size()) fail("unexpected end");
+                const char c = m_text[m_pos];
+                if (c == '{') return parseObject();
+                if (c == '[') return parseArray();
+                if (c == '"') return string(parseString());
+                if (literal("true")) return true;
+                if (literal("false")) return false;
+                if (literal("null")) return nullptr;
+                return parseNumber();
+            }
+
+            value parseObject()
+            {
+                expect('{');
+                object result;
+                if (consume('}')) return result;
+                do {
+                    skipSpace();
+                    auto key = parseString();
+                    expect(':');
+                    result.insert_or_assign(key, parseValue());
+                } while (consume(','));
+                expect('}');
+                return result;
+            }
+
+            value parseArray()
+            {
+                expect('[');
+                array result;
+                if (consume(']')) return result;
+                do {
+                    result.push_back(parseValue());
+                } while (consume(','));
+                expect(']');
+                return result;
+            }
+
+            unsigned hex4()
+            {
+                if (m_pos + 4 > m_text.size()) fail("bad \\u escape");
+                unsigned code = 0;
+                const auto [end, ec] = std::from_chars(m_text.data() + m_pos, m_text.data() + m_pos + 4, code, 16);
+                if (ec != std::errc{} || end != m_text.data() + m_pos + 4) fail("bad \\u escape");
+                m_pos += 4;
+                return code;
+            }
+
+            static void appendUtf8(std::string& out, unsigned code)
+            {
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                }
+                else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000) {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else {
+                    out += static_cast<char>(0xF0 | (code >> 18));
+                    out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+            }
+
+            std::string parseString()
+            {
+                if (m_pos >= m_text.size() || m_text[m_pos] != '"') fail("string expected");
+                ++m_pos;
+                std::string result;
+                while (true) {
+                    if (m_pos >= m_text.size()) fail("unterminated string");
+                    const char c = m_text[m_pos++];
+                    if (c == '"') return result;
+                    if (static_cast<unsigned char>(c) < 0x20) fail("control character in string");
+                    if (c != '\\') {
+                        result += c;
+                        continue;
+                    }
+                    if (m_pos >= m_text.size()) fail("unterminated escape");
+                    switch (m_text[m_pos++]) {
+                    case '"': result += '"'; break;
+                    case '\\': result += '\\'; break;
+                    case '/': result += '/'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'n': result += '\n'; break;
+                    case 'r': result += '\r'; break;
+                    case 't': result += '\t'; break;
+                    case 'u': {
+                        unsigned code = hex4();
+                        // Суррогатная пара UTF-16 записывается двумя escape подряд
+                        if (code >= 0xD800 && code < 0xDC00 && literal("\\u")) {
+                            const unsigned low = hex4();
+                            if (low < 0xDC00 || low >= 0xE000) fail("bad surrogate pair");
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        appendUtf8(result, code);
+                        break;
+                    }
+                    default:
+                        fail("bad escape");
+                    }
+                }
+            }
+
+            value parseNumber()
+            {
+                const auto start = m_pos;
+                auto digits = [this]() {
+                    const auto from = m_pos;
+                    while (m_pos < m_text.size() && m_text[m_pos] >= '0' && m_text[m_pos] <= '9') ++m_pos;
+                    return m_pos > from;
+                };
+                if (m_pos < m_text.size() && m_text[m_pos] == '-') ++m_pos;
+                if (!digits()) fail("number expected");
+                bool integer = true;
+                if (m_pos < m_text.size() && m_text[m_pos] == '.') {
+                    ++m_pos;
+                    integer = false;
+                    if (!digits()) fail("digits expected after '.'");
+                }
+                if (m_pos < m_text.size() && (m_text[m_pos] == 'e' || m_text[m_pos] == 'E')) {
+                    ++m_pos;
+                    integer = false;
+                    if (m_pos < m_text.size() && (m_text[m_pos] == '+' || m_text[m_pos] == '-')) ++m_pos;
+                    if (!digits()) fail("digits expected in exponent");
+                }
+
+                const char* first = m_text.data() + start;
+                const char* last = m_text.data() + m_pos;
+                if (integer) {
+                    std::int64_t signedValue = 0;
+                    if (std::from_chars(first, last, signedValue).ec == std::errc{}) return signedValue;
+                    std::uint64_t unsignedValue = 0;
+                    if (*first != '-' && std::from_chars(first, last, unsignedValue).ec == std::errc{}) return unsignedValue;
+                }
+                double number = 0.0;
+                if (std::from_chars(first, last, number).ec != std::errc{}) fail("number out of range");
+                return number;
+            }
+
+            std::string_view m_text;
+            std::size_t m_pos{ 0 };
+        };
+    }
+
+    /**
+     * @brief Разобрать JSON-документ целиком.
+     * @param text Текст документа.
+     * @return Корневое значение.
+     */
+    inline value parse(std::string_view text)
+    {
+        return detail::parser(text).document();
+    }
+}
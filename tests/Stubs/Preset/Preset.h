@@ -0,0 +1,25 @@
+#pragma once
+#include <algorithm>
+#include <string>
+#include "Preset/Details/PresetEnums.h"
+#include "globals.h"
+
+/**
+ * @brief Заглушка Preset для хостовых тестов: только тип и id, без игровых зависимостей.
+ *
+ * Подключается вместо Preset/Preset.h для контейнеров, которым от пресета нужны только type() и id().
+ */
+class Preset
+{
+public:
+    Preset(PresetType type, std::string id) :
+        m_type(type), m_id(std::move(id)) {}
+    virtual ~Preset() = default;
+
+    PresetType type() const noexcept { return m_type; }
+    const std::string& id() const noexcept { return m_id; }
+
+private:
+    PresetType m_type;
+    std::string m_id;
+};
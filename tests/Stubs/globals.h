@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * @brief Заглушка globals.h для хостовых тестов: только logger, сообщения отбрасываются.
+ */
+namespace logger
+{
+    template <class... Args>
+    void info(Args&&...) {}
+
+    template <class... Args>
+    void warn(Args&&...) {}
+
+    template <class... Args>
+    void error(Args&&...) {}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+/**
+ * @brief Заглушка mmio для хостовых тестов: вместо отображения файл читается в память целиком.
+ *
+ * В плагин mmio входит собранной библиотекой, исходников для Linux в дереве нет. Повторяет только то,
+ * что нужно SliderPresetCache: open(), empty(), data() и size() у mapped_file_source.
+ */
+namespace mmio
+{
+    class mapped_file_source
+    {
+    public:
+        struct open_result
+        {
+            bool ok;
+            explicit operator bool() const noexcept { return ok; }
+        };
+
+        open_result open(const std::filesystem::path& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) return { false };
+            m_data.clear();
+            for (auto it = std::istreambuf_iterator<char>(file); it != std::istreambuf_iterator<char>(); ++it) {
+                m_data.push_back(static_cast<std::byte>(*it));
+            }
+            return { true };
+        }
+
+        bool empty() const noexcept { return m_data.empty(); }
+        const std::byte* data() const noexcept { return m_data.data(); }
+        std::size_t size() const noexcept { return m_data.size(); }
+
+    private:
+        std::vector<std::byte> m_data;
+    };
+}
@@ -0,0 +1,6 @@
+#include "Check.h"
+
+int main(int argc, char** argv)
+{
+    return test::run(argc, argv);
+}
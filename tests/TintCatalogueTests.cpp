@@ -0,0 +1,196 @@
+#include "Check.h"
+#include "Validate/TintCatalogue.hpp"
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Origin = TintTemplateItem::Origin;
+    using Reason = TintCatalogue::Rejected::Reason;
+
+    /**
+     * @brief Источник вместо игры: записи отдаются в порядке добавления, строки живут в самом источнике.
+     */
+    struct FakeSource final : TintTemplateSource
+    {
+        struct Record
+        {
+            uint32_t id;
+            std::optional<TintKind> kind;
+            Origin origin;
+            std::string group;
+            std::string name;
+            uint32_t templateKey;
+        };
+
+        std::vector<Record> records;
+        mutable size_t walks{ 0 };
+
+        FakeSource& add(uint32_t id, std::optional<TintKind> kind, uint32_t templateKey, std::string name = "tint")
+        {
+            records.push_back({ id, kind, Origin::Template, "Group", std::move(name), templateKey });
+            return *this;
+        }
+
+        FakeSource& addActor(uint32_t id, std::optional<TintKind> kind, std::string name = "")
+        {
+            records.push_back({ id, kind, Origin::Actor, "Player", std::move(name), 0 });
+            return *this;
+        }
+
+        void forEach(const std::function<void(const TintTemplateItem&)>& visit) const override
+        {
+            ++walks;
+            for (const auto& record : records) {
+                visit(TintTemplateItem{ record.id, record.kind, record.origin, record.group, record.name, record.templateKey });
+            }
+        }
+    };
+
+    // Номера шаблонов так, как их раздаёт игровой источник: HumanRace мужской и женский
+    constexpr uint32_t humanMale = 1;
+    constexpr uint32_t humanFemale = 2;
+    constexpr uint32_t modRaceFemale = 3;
+}
+
+TEST_CASE(IndexesEveryValidEntryInOneWalk)
+{
+    FakeSource source;
+    source.add(10, TintKind::Mask, humanMale, "Freckles")
+        .add(11, TintKind::Palette, humanMale, "Lipstick")
+        .add(12, TintKind::TextureSet, humanMale, "Dirt");
+
+    std::vector<TintCatalogue::Rejected> rejected;
+    const auto catalogue = TintCatalogue::build(source, &rejected);
+    CHECK(source.walks == 1);
+    CHECK(rejected.empty());
+    CHECK(catalogue.size() == 3);
+
+    const auto entry = catalogue.find(11);
+    REQUIRE(entry);
+    CHECK(entry->kind == TintKind::Palette);
+    CHECK(catalogue.contains(10, TintKind::Mask));
+    CHECK(!catalogue.contains(10, TintKind::Palette));
+    CHECK(!catalogue.contains(13));
+    CHECK(!catalogue.find(13));
+}
+
+TEST_CASE(FemaleOnlyTintsAreIndexed)
+{
+    // Тинт есть только в женском шаблоне: раньше индекс строился по мужскому, и такие тинты считались недействительными
+    FakeSource source;
+    source.add(10, TintKind::Mask, humanMale)
+        .add(20, TintKind::Palette, humanFemale, "Blush")
+        .add(30, TintKind::Mask, modRaceFemale, "Mod tattoo");
+
+    const auto catalogue = TintCatalogue::build(source);
+    CHECK(catalogue.contains(10));
+    CHECK(catalogue.contains(20, TintKind::Palette));
+    CHECK(catalogue.contains(30, TintKind::Mask));
+}
+
+TEST_CASE(SharedIdsAcrossTemplatesAreNotDuplicates)
+{
+    FakeSource source;
+    source.add(10, TintKind::Mask, humanMale)
+        .add(10, TintKind::Mask, humanFemale)
+        .add(10, TintKind::Mask, modRaceFemale)
+        .addActor(10, TintKind::Mask);
+
+    std::vector<TintCatalogue::Rejected> rejected;
+    const auto catalogue = TintCatalogue::build(source, &rejected);
+    CHECK(rejected.empty());
+    CHECK(catalogue.size() == 1);
+}
+
+TEST_CASE(DuplicatesWithinTemplateOrOfAnotherKindAreRejected)
+{
+    FakeSource source;
+    source.add(10, TintKind::Mask, humanMale, "First")
+        .add(10, TintKind::Mask, humanMale, "Second")
+        .add(11, TintKind::Mask, humanMale)
+        .add(11, TintKind::Palette, humanFemale, "Other kind")
+        .addActor(11, TintKind::TextureSet, "Actor other kind");
+
+    std::vector<TintCatalogue::Rejected> rejected;
+    const auto catalogue = TintCatalogue::build(source, &rejected);
+    REQUIRE(rejected.size() == 3);
+    for (const auto& item : rejected) {
+        CHECK(item.reason == Reason::Duplicate);
+        CHECK(TintCatalogue::toString(item.reason) == "uniqueID is not unique");
+    }
+    CHECK(rejected[0].id == 10 && rejected[0].name == "Second" && rejected[0].group == "Group");
+    CHECK(rejected[1].name == "Other kind");
+    CHECK(rejected[2].name == "Actor other kind" && rejected[2].group == "Player");
+
+    // Побеждает первая запись
+    CHECK(catalogue.contains(11, TintKind::Mask));
+    CHECK(catalogue.size() == 2);
+}
+
+TEST_CASE(InvalidEntriesAreRejectedWithReason)
+{
+    FakeSource source;
+    source.add(10, TintKind::Mask, humanMale, "")
+        .add(0, TintKind::Mask, humanMale, "No id")
+        .add(12, std::nullopt, humanFemale, "Unknown")
+        .addActor(0, TintKind::Mask)
+        .addActor(13, TintKind::Palette);   // у тинтов актёра имя не обязательно
+
+    std::vector<TintCatalogue::Rejected> rejected;
+    const auto catalogue = TintCatalogue::build(source, &rejected);
+    REQUIRE(rejected.size() == 4);
+    CHECK(rejected[0].reason == Reason::EmptyName && rejected[0].id == 10);
+    CHECK(rejected[1].reason == Reason::ZeroId && rejected[1].name == "No id");
+    CHECK(rejected[2].reason == Reason::UnknownKind && rejected[2].id == 12);
+    CHECK(rejected[3].reason == Reason::ZeroId);
+    CHECK(catalogue.size() == 1);
+    CHECK(catalogue.contains(13, TintKind::Palette));
+
+    // Отчёт необязателен
+    CHECK(TintCatalogue::build(source).size() == 1);
+}
+
+TEST_CASE(ActorTintsExtendTemplates)
+{
+    // Тинт из плагина, которого нет в шаблонах расы, но который надет на игрока
+    FakeSource source;
+    source.add(10, TintKind::Mask, humanMale).addActor(500, TintKind::TextureSet);
+    const auto catalogue = TintCatalogue::build(source);
+    CHECK(catalogue.contains(500, TintKind::TextureSet));
+}
+
+TEST_CASE(EmptySourceGivesEmptyCatalogue)
+{
+    FakeSource source;
+    const auto catalogue = TintCatalogue::build(source);
+    CHECK(catalogue.empty());
+    CHECK(catalogue.size() == 0);
+    CHECK(!catalogue.contains(1));
+    CHECK(TintCatalogue::toString(TintKind::TextureSet) == "TextureSet");
+}
+
+BENCHMARK(LookupVsLinearScan)
+{
+    FakeSource source;
+    for (uint32_t id = 1; id <= 4000; ++id) {
+        source.add(id, static_cast<TintKind>(id % 3), id % 2 ? humanMale : humanFemale);
+    }
+    const auto catalogue = TintCatalogue::build(source);
+
+    uint32_t next = 0;
+    size_t hits = 0;
+    const double indexed = test::measure(200000, [&] { hits += catalogue.contains(next++ % 5000 + 1); });
+    const double linear = test::measure(20000, [&] {
+        const uint32_t id = next++ % 5000 + 1;
+        for (const auto& record : source.records) {
+            if (record.id == id) {
+                ++hits;
+                break;
+            }
+        }
+    });
+    std::printf("4000 tints: catalogue %.3f us, linear scan %.3f us per lookup (%zu)\n", indexed, linear, hits);
+}
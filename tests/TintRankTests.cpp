@@ -0,0 +1,118 @@
+#include "Check.h"
+#include "Preset/Details/TintRank.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct FakeTint
+    {
+        uint32_t id;
+    };
+
+    uint32_t idOf(const FakeTint* tint)
+    {
+        return tint->id;
+    }
+
+    /**
+     * @brief Прежняя сортировка NPCPreset::applyImpl: std::find по порядку для обеих сторон сравнения.
+     */
+    std::vector<const FakeTint*> sortByFind(std::vector<const FakeTint*> tints, const std::vector<uint32_t>& order)
+    {
+        auto find = [](const std::vector<uint32_t>& sortOrder, uint32_t id) -> size_t {
+            auto it = std::find(sortOrder.begin(), sortOrder.end(), id);
+            return static_cast<size_t>(it - sortOrder.begin());
+        };
+        std::sort(tints.begin(), tints.end(), [&order, find](const FakeTint* a, const FakeTint* b) {
+            auto indexA = find(order, a->id);
+            auto indexB = find(order, b->id);
+            if (indexA == order.size() && indexB != order.size()) return false;
+            if (indexB == order.size() && indexA != order.size()) return true;
+            if (indexA == order.size() && indexB == order.size()) {
+                return a->id < b->id;
+            }
+            return indexA < indexB;
+        });
+        return tints;
+    }
+
+    /**
+     * @brief 120 тинтов с разными id в порядке множества и порядок LooksMenu из 102 записей:
+     * с пропусками, неизвестным id и повтором.
+     */
+    struct Preset
+    {
+        std::vector<FakeTint> storage;
+        std::vector<const FakeTint*> tints;
+        std::vector<uint32_t> order;
+
+        explicit Preset(uint32_t seed)
+        {
+            std::mt19937 rng(seed);
+            storage.resize(120);
+            for (uint32_t i = 0; i < storage.size(); ++i) {
+                storage[i].id = 1000 + i * 3;
+            }
+            std::shuffle(storage.begin(), storage.end(), rng);
+            for (const auto& tint : storage) {
+                tints.push_back(&tint);
+            }
+
+            for (size_t i = 0; i < 100; ++i) {
+                order.push_back(storage[i].id);
+            }
+            std::shuffle(order.begin(), order.end(), rng);
+            order.push_back(7);             // Нет среди тинтов
+            order.push_back(order[10]);     // Повтор: ранг по первому вхождению
+        }
+    };
+}
+
+TEST_CASE(RankOrderMatchesFindComparator)
+{
+    for (uint32_t seed = 1; seed <= 20; ++seed) {
+        const Preset preset(seed);
+        REQUIRE(preset.order.size() == 102);
+        const auto expected = sortByFind(preset.tints, preset.order);
+        const auto ordered = orderByRank(preset.tints, preset.order, idOf);
+        CHECK(ordered == expected);
+    }
+}
+
+TEST_CASE(UnorderedTintsGoLastByAscendingId)
+{
+    const FakeTint a{ 50 }, b{ 10 }, c{ 30 }, d{ 20 };
+    const std::vector<const FakeTint*> tints{ &a, &b, &c, &d };
+    const auto ordered = orderByRank(tints, { 30, 50 }, idOf);
+    CHECK((ordered == std::vector<const FakeTint*>{ &c, &a, &b, &d }));
+}
+
+TEST_CASE(EmptyOrderKeepsInputOrder)
+{
+    const FakeTint a{ 5 }, b{ 1 }, c{ 3 };
+    const std::vector<const FakeTint*> tints{ &a, &b, &c };
+    CHECK(orderByRank(tints, {}, idOf) == tints);
+    CHECK(orderByRank(std::vector<const FakeTint*>{}, { 1, 2 }, idOf).empty());
+}
+
+TEST_CASE(EqualRanksKeepInputOrder)
+{
+    // Два тинта с одним id получают один ранг и остаются в исходном порядке
+    const FakeTint a{ 2 }, b{ 1 }, c{ 2 };
+    const std::vector<const FakeTint*> tints{ &a, &b, &c };
+    CHECK((orderByRank(tints, { 2, 1, 2 }, idOf) == std::vector<const FakeTint*>{ &a, &c, &b }));
+}
+
+BENCHMARK(RankVersusFindComparator120Tints)
+{
+    const Preset preset(42);
+    size_t sink = 0;
+    const double findUs = test::measure(20000, [&] { sink += sortByFind(preset.tints, preset.order).front()->id; });
+    const double rankUs = test::measure(20000, [&] { sink += orderByRank(preset.tints, preset.order, idOf).front()->id; });
+    std::printf("120 tints, 102-entry order: sort + std::find %.1f us per apply, orderByRank %.1f us once at load (%zu)\n",
+        findUs, rankUs, sink);
+}
@@ -0,0 +1,261 @@
+#include "Check.h"
+#include "ActorsManager/Details/WaitingActorsQueue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    /**
+     * @brief Часы, которые двигает только тест.
+     */
+    struct FakeClock
+    {
+        using rep = int64_t;
+        using period = std::micro;
+        using duration = std::chrono::duration<rep, period>;
+        using time_point = std::chrono::time_point<FakeClock>;
+        static constexpr bool is_steady = true;
+
+        static inline time_point current{};
+
+        static time_point now() noexcept { return current; }
+        static void advance(duration d) noexcept { current += d; }
+    };
+
+    using Queue = WaitingActorsQueue<FakeClock>;
+
+    /**
+     * @brief Поддельные актёры: расстояние до игрока и стоимость применения пресетов в тиках часов.
+     */
+    struct FakeActors
+    {
+        std::unordered_map<uint32_t, float> distances;
+        FakeClock::duration applyCost{ 1000 };
+        std::vector<uint32_t> applied;
+        std::unordered_map<uint32_t, bool> failing;
+
+        /**
+         * @brief Поставить актёра в очередь с его текущим расстоянием, как ThreadSafeWaitingActors::push_back.
+         */
+        void push(Queue& queue, uint32_t formId) const
+        {
+            auto it = distances.find(formId);
+            queue.push(formId, it != distances.end() ? it->second : 1e9f);
+        }
+
+        Queue::ApplyFn apply()
+        {
+            return [this](uint32_t formId) {
+                FakeClock::advance(applyCost);
+                applied.push_back(formId);
+                return !failing[formId];
+            };
+        }
+    };
+}
+
+TEST_CASE(NearestActorsFirstThenQueueOrder)
+{
+    Queue queue;
+    FakeActors actors;
+    actors.distances = { { 1, 500.0f }, { 2, 100.0f }, { 3, 100.0f }, { 4, 50.0f } };
+    actors.push(queue, 3);
+    FakeClock::advance(1ms);
+    actors.push(queue, 2);
+    FakeClock::advance(1ms);
+    actors.push(queue, 1);
+    FakeClock::advance(1ms);
+    actors.push(queue, 4);
+
+    const auto result = queue.drain(1s, actors.apply());
+    CHECK(result.applied == 4 && result.failed == 0 && result.left == 0);
+    // 2 и 3 на одном расстоянии: раньше поставленный 3 идёт первым
+    CHECK((actors.applied == std::vector<uint32_t>{ 4, 3, 2, 1 }));
+}
+
+TEST_CASE(WithoutDistanceOrderIsQueueOrder)
+{
+    Queue queue;
+    FakeActors actors;
+    for (uint32_t formId : { 30u, 10u, 20u }) {
+        queue.push(formId);
+        FakeClock::advance(1ms);
+    }
+    queue.drain(1s, actors.apply());
+    CHECK((actors.applied == std::vector<uint32_t>{ 30, 10, 20 }));
+}
+
+TEST_CASE(RepeatedPushKeepsPlace)
+{
+    Queue queue;
+    FakeActors actors;
+    queue.push(1);
+    FakeClock::advance(1ms);
+    queue.push(2);
+    FakeClock::advance(1ms);
+    queue.push(1);
+    CHECK(queue.size() == 2);
+    queue.drain(1s, actors.apply());
+    CHECK((actors.applied == std::vector<uint32_t>{ 1, 2 }));
+}
+
+TEST_CASE(BudgetLimitsWorkPerDrain)
+{
+    Queue queue;
+    FakeActors actors;
+    actors.applyCost = 3ms;
+    for (uint32_t i = 0; i < 10; ++i) {
+        actors.distances[i] = static_cast<float>(i);
+        actors.push(queue, i);
+    }
+
+    // 3 применения по 3 мс укладываются в бюджет 8 мс только до третьего включительно
+    auto result = queue.drain(8ms, actors.apply());
+    CHECK(result.applied == 3 && result.left == 7);
+    CHECK((actors.applied == std::vector<uint32_t>{ 0, 1, 2 }));
+
+    // Нулевой бюджет всё равно продвигает очередь на одного актёра
+    result = queue.drain(FakeClock::duration::zero(), actors.apply());
+    CHECK(result.applied == 1 && result.left == 6);
+    CHECK(actors.applied.back() == 3);
+
+    // Новый ближайший актёр обгоняет старых
+    actors.distances[100] = -1.0f;
+    actors.push(queue, 100);
+    result = queue.drain(1s, actors.apply());
+    CHECK(result.applied == 7 && result.left == 0);
+    CHECK(actors.applied[4] == 100);
+}
+
+TEST_CASE(FailedApplyIsCountedAndRemoved)
+{
+    Queue queue;
+    FakeActors actors;
+    actors.failing[2] = true;
+    queue.push(1);
+    queue.push(2);
+    const auto result = queue.drain(1s, actors.apply());
+    CHECK(result.applied == 1 && result.failed == 1 && result.left == 0);
+    CHECK(queue.empty());
+}
+
+TEST_CASE(ErasedDuringDrainIsSkipped)
+{
+    Queue queue;
+    FakeActors actors;
+    for (uint32_t i = 1; i <= 4; ++i) {
+        actors.distances[i] = static_cast<float>(i);
+        actors.push(queue, i);
+    }
+    // Применение первого актёра убирает третьего, как событие загрузки, применившее его другим путём
+    auto apply = [&](uint32_t formId) {
+        actors.applied.push_back(formId);
+        if (formId == 1) {
+            CHECK(queue.erase(3));
+        }
+        return true;
+    };
+    const auto result = queue.drain(1s, apply);
+    CHECK(result.applied == 3 && result.skipped == 1 && result.left == 0);
+    CHECK((actors.applied == std::vector<uint32_t>{ 1, 2, 4 }));
+    CHECK(!queue.erase(3));
+}
+
+TEST_CASE(PushDuringDrainWaitsForNextDrain)
+{
+    Queue queue;
+    FakeActors actors;
+    queue.push(1);
+    auto apply = [&](uint32_t formId) {
+        actors.applied.push_back(formId);
+        queue.push(formId + 1);
+        return true;
+    };
+    auto result = queue.drain(1s, apply);
+    CHECK(result.applied == 1 && result.left == 1);
+    result = queue.drain(1s, apply);
+    CHECK(result.applied == 1 && actors.applied.back() == 2);
+    queue.clear();
+    CHECK(queue.empty());
+}
+
+TEST_CASE(ConcurrentPushEraseAndDrain)
+{
+    // Настоящие часы: поддельные не рассчитаны на запись из нескольких потоков
+    WaitingActorsQueue<> queue;
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> applied{ 0 };
+
+    std::thread pusher([&] {
+        for (uint32_t i = 0; i < 20000; ++i) {
+            queue.push(i % 2000, static_cast<float>(i % 17));
+        }
+    });
+    std::thread eraser([&] {
+        for (uint32_t i = 0; i < 20000; ++i) {
+            queue.erase((i * 7) % 2000);
+        }
+    });
+    std::thread drainer([&] {
+        while (!done.load()) {
+            auto result = queue.drain(std::chrono::microseconds(200),
+                [&applied](uint32_t) { ++applied; return true; });
+            (void)result;
+        }
+    });
+
+    pusher.join();
+    eraser.join();
+    done = true;
+    drainer.join();
+
+    const auto rest = queue.drain(std::chrono::hours(1), [&applied](uint32_t) { ++applied; return true; });
+    CHECK(rest.left == 0);
+    CHECK(queue.empty());
+    // Каждый актёр применяется не больше раза на каждую постановку
+    CHECK(applied.load() <= 20000);
+}
+
+BENCHMARK(FrameDrainVersusPerFrameSort)
+{
+    constexpr uint32_t actors = 5000;
+    constexpr int frames = 200;
+    const auto distance = [](uint32_t formId) { return static_cast<float>((formId * 2654435761u) % 10000); };
+
+    // Прежний order(): расстояние до каждого актёра в очереди и сортировка всей очереди на каждом кадре
+    size_t sink = 0;
+    const double sortUs = test::measure(3, [&] {
+        std::vector<uint32_t> queued(actors);
+        for (uint32_t i = 0; i < actors; ++i) {
+            queued[i] = i;
+        }
+        for (int frame = 0; frame < frames; ++frame) {
+            std::vector<std::pair<float, uint32_t>> candidates;
+            candidates.reserve(queued.size());
+            for (uint32_t formId : queued) {
+                candidates.emplace_back(distance(formId), formId);
+            }
+            std::sort(candidates.begin(), candidates.end());
+            sink += candidates.front().second;
+            queued.erase(std::find(queued.begin(), queued.end(), candidates.front().second));
+        }
+    });
+    // Расстояние считается при постановке, кадр снимает актёров с начала упорядоченной очереди
+    const double queueUs = test::measure(3, [&] {
+        WaitingActorsQueue<> queue;
+        for (uint32_t i = 0; i < actors; ++i) {
+            queue.push(i, distance(i));
+        }
+        for (int frame = 0; frame < frames; ++frame) {
+            queue.drain(std::chrono::steady_clock::duration::zero(), [&sink](uint32_t formId) { sink += formId; return true; });
+        }
+    });
+    std::printf("%u queued actors, %d frames: per-frame distance + sort %.0f us, queue ordered at push %.0f us (%zu)\n",
+        actors, frames, sortUs, queueUs, sink);
+}